@@ -146,6 +146,7 @@ from .fouriersqrt import *
 
 from .interpolant import *
 from .interpolatedimage import *
+from .psf_atlas import *
 from .real import *
 from .galaxy_sample import *
 
@@ -396,6 +396,13 @@ class Convolution(GSObject):
         kv_list = [obj.kValue(pos) for obj in self.obj_list]
         return np.prod(kv_list)
 
+    def _kValueMany(self, kx, ky, val):
+        self.obj_list[0]._kValueMany(kx, ky, val)
+        tmp = np.empty_like(val)
+        for obj in self.obj_list[1:]:
+            obj._kValueMany(kx, ky, tmp)
+            val *= tmp
+
     def _drawReal(self, image, jac=None, offset=(0.,0.), flux_scaling=1.):
         if len(self.obj_list) == 1:
             self.obj_list[0]._drawReal(image, jac, offset, flux_scaling)
@@ -603,6 +610,12 @@ class Deconvolution(GSObject):
         else:
             return 1./kval
 
+    def _kValueMany(self, kx, ky, val):
+        self.orig_obj._kValueMany(kx, ky, val)
+        small = np.abs(val) < self._min_acc_kvalue
+        val[small] = self._inv_min_acc_kvalue
+        val[~small] = 1./val[~small]
+
     def _drawKImage(self, image, jac=None):
         self.orig_obj._drawKImage(image, jac)
         do_inverse = np.abs(image.array) > self._min_acc_kvalue
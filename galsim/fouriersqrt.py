@@ -197,6 +197,10 @@ class FourierSqrtProfile(GSObject):
     def _kValue(self, pos):
         return np.sqrt(self.orig_obj._kValue(pos))
 
+    def _kValueMany(self, kx, ky, val):
+        self.orig_obj._kValueMany(kx, ky, val)
+        np.sqrt(val, out=val)
+
     def _drawKImage(self, image, jac=None):
         self.orig_obj._drawKImage(image, jac)
         image.array[:,:] = np.sqrt(image.array)
@@ -198,6 +198,8 @@ class GSObject:
                       'integration_relerr' : float,
                       'integration_abserr' : float,
                       'shoot_accuracy' : float,
+                      'interpolant_phase_tolerance' : float,
+                      'interpolant_tables' : bool,
                       'allowed_flux_variation' : float,
                       'range_division_for_extrema' : int,
                       'small_fraction_of_flux' : float
@@ -730,6 +732,78 @@ class GSObject:
         """
         raise NotImplementedError("%s does not implement xValue"%self.__class__.__name__)
 
+    def xValueMany(self, x, y):
+        """Returns the value of the object at many 2D positions in real space.
+
+        This is equivalent to calling `xValue` at each position (x[i], y[i]), but the whole
+        arrays are passed to the C++ layer at once, so there is no Python loop over the points.
+        The inputs may be any arrays (or scalars) that can be broadcast to a common shape.
+
+        Parameters:
+            x:          The x values of the positions.
+            y:          The y values of the positions.
+
+        Returns:
+            a numpy array of the surface brightness values with the broadcast shape of x and y.
+        """
+        x, y = np.broadcast_arrays(np.asarray(x, dtype=float), np.asarray(y, dtype=float))
+        x = np.ascontiguousarray(x)
+        y = np.ascontiguousarray(y)
+        val = np.empty(x.shape, dtype=float)
+        self._xValueMany(x, y, val)
+        return val
+
+    def _xValueMany(self, x, y, val):
+        """Equivalent to `xValueMany`, but x, y must be contiguous float arrays of the same
+        shape, and the output is written into the float array ``val``.
+        """
+        try:
+            sbp = self._sbp
+        except AttributeError:
+            # Objects without a C++ profile need to fall back to one point at a time.
+            for i, (xx, yy) in enumerate(zip(x.ravel(), y.ravel())):
+                val.flat[i] = self._xValue(_PositionD(xx, yy))
+        else:
+            with convert_cpp_errors():
+                sbp.xValueMany(x.__array_interface__['data'][0], y.__array_interface__['data'][0],
+                               val.__array_interface__['data'][0], x.size)
+
+    def kValueMany(self, kx, ky):
+        """Returns the value of the object at many 2D positions in k space.
+
+        This is equivalent to calling `kValue` at each position (kx[i], ky[i]), but the whole
+        arrays are passed to the C++ layer at once, so there is no Python loop over the points.
+        The inputs may be any arrays (or scalars) that can be broadcast to a common shape.
+
+        Parameters:
+            kx:         The kx values of the positions.
+            ky:         The ky values of the positions.
+
+        Returns:
+            a complex numpy array of the fourier amplitudes with the broadcast shape of kx and ky.
+        """
+        kx, ky = np.broadcast_arrays(np.asarray(kx, dtype=float), np.asarray(ky, dtype=float))
+        kx = np.ascontiguousarray(kx)
+        ky = np.ascontiguousarray(ky)
+        val = np.empty(kx.shape, dtype=complex)
+        self._kValueMany(kx, ky, val)
+        return val
+
+    def _kValueMany(self, kx, ky, val):
+        """Equivalent to `kValueMany`, but kx, ky must be contiguous float arrays of the same
+        shape, and the output is written into the complex array ``val``.
+        """
+        try:
+            sbp = self._sbp
+        except AttributeError:
+            for i, (kxx, kyy) in enumerate(zip(kx.ravel(), ky.ravel())):
+                val.flat[i] = self._kValue(_PositionD(kxx, kyy))
+        else:
+            with convert_cpp_errors():
+                sbp.kValueMany(kx.__array_interface__['data'][0],
+                               ky.__array_interface__['data'][0],
+                               val.__array_interface__['data'][0], kx.size)
+
     def kValue(self, *args, **kwargs):
         """Returns the value of the object at a chosen 2D position in k space.
 
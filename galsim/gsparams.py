@@ -113,6 +113,28 @@ class GSParams:
                             radial profile. When such approximations need to be made, it makes
                             sure that the resulting fractional error in the flux will be at
                             most this much. [default: 1.e-5]
+        interpolant_phase_tolerance:
+                            If this is > 0, then when drawing an `InterpolatedImage`, the
+                            position of each pixel center relative to the original image's
+                            pixel grid may be rounded by up to this much (in pixels).  Then the
+                            interpolant weights only need to be calculated once for each of a
+                            fixed set of sub-pixel phases, and the same weights are reused for
+                            all subsequent draws with that interpolant.  This is mostly useful
+                            when drawing many stamps of the same interpolated PSF at different
+                            sub-pixel offsets, especially with a `Lanczos` interpolant.  The
+                            error in the pixel values is roughly this value times the slope of
+                            the interpolant, so values around 1.e-3 or smaller are reasonable.
+                            [default: 0, which means to use the exact positions]
+        interpolant_tables: Whether the `Cubic`, `Quintic` and `Lanczos` interpolants should
+                            evaluate their kernels by linear interpolation in finely spaced
+                            lookup tables, rather than calculating them directly.  The tables
+                            are built once for each set of parameters and are accurate to
+                            ``xvalue_accuracy`` in real space and ``kvalue_accuracy`` in Fourier
+                            space.  (If a table can't reach that accuracy with a reasonable
+                            size, the kernel is calculated directly instead.)  This is usually
+                            faster when the interpolant is evaluated many times, e.g. when
+                            drawing an `InterpolatedImage` or computing its Fourier transform.
+                            [default: False]
 
     After construction, all of the above parameters are available as read-only attributes.
     """
@@ -122,7 +144,8 @@ class GSParams:
                  realspace_relerr=1.e-4, realspace_abserr=1.e-6,
                  integration_relerr=1.e-6, integration_abserr=1.e-8,
                  shoot_accuracy=1.e-5, allowed_flux_variation=0.81,
-                 range_division_for_extrema=32, small_fraction_of_flux=1.e-4):
+                 range_division_for_extrema=32, small_fraction_of_flux=1.e-4,
+                 interpolant_phase_tolerance=0., interpolant_tables=False):
         self._minimum_fft_size = int(minimum_fft_size)
         self._maximum_fft_size = int(maximum_fft_size)
         self._folding_threshold = float(folding_threshold)
@@ -136,6 +159,8 @@ class GSParams:
         self._integration_relerr = float(integration_relerr)
         self._integration_abserr = float(integration_abserr)
         self._shoot_accuracy = float(shoot_accuracy)
+        self._interpolant_phase_tolerance = float(interpolant_phase_tolerance)
+        self._interpolant_tables = bool(interpolant_tables)
 
         if allowed_flux_variation != 0.81:
             from .deprecated import depr
@@ -147,7 +172,7 @@ class GSParams:
             from .deprecated import depr
             depr('small_fraction_of_flux', 2.1, "", "This parameter is no longer used.")
 
-        self._gsp = _galsim.GSParams(*self._getinitargs())
+        self._gsp = _galsim.GSParams(*self._getcppargs())
 
     # Make all the attributes read-only
     @property
@@ -176,6 +201,10 @@ class GSParams:
     def integration_abserr(self): return self._integration_abserr
     @property
     def shoot_accuracy(self): return self._shoot_accuracy
+    @property
+    def interpolant_phase_tolerance(self): return self._interpolant_phase_tolerance
+    @property
+    def interpolant_tables(self): return self._interpolant_tables
 
     @staticmethod
     def check(gsparams, default=None, **kwargs):
@@ -202,7 +231,7 @@ class GSParams:
                 if not hasattr(ret, '_' + k):
                     raise TypeError('parameter %s is invalid'%k)
                 setattr(ret, '_' + k, kwargs[k])
-            ret._gsp = _galsim.GSParams(*ret._getinitargs())
+            ret._gsp = _galsim.GSParams(*ret._getcppargs())
             return ret
 
     @staticmethod
@@ -230,22 +259,38 @@ class GSParams:
                 min([g.realspace_abserr for g in gsp_list if g is not None]),
                 min([g.integration_relerr for g in gsp_list if g is not None]),
                 min([g.integration_abserr for g in gsp_list if g is not None]),
-                min([g.shoot_accuracy for g in gsp_list if g is not None]))
+                min([g.shoot_accuracy for g in gsp_list if g is not None]),
+                interpolant_phase_tolerance=min([g.interpolant_phase_tolerance
+                                                 for g in gsp_list if g is not None]),
+                interpolant_tables=all([g.interpolant_tables for g in gsp_list if g is not None]))
 
     # Define once the order of args in __init__, since we use it a few times.
+    # The deprecated allowed_flux_variation, range_division_for_extrema and small_fraction_of_flux
+    # come before the newer parameters, so use their default values here.
     def _getinitargs(self):
         return (int(self.minimum_fft_size), int(self.maximum_fft_size),
                 self.folding_threshold, self.stepk_minimum_hlr, self.maxk_threshold,
                 self.kvalue_accuracy, self.xvalue_accuracy, self.table_spacing,
                 self.realspace_relerr, self.realspace_abserr,
                 self.integration_relerr, self.integration_abserr,
-                self.shoot_accuracy)
+                self.shoot_accuracy, 0.81, 32, 1.e-4,
+                self.interpolant_phase_tolerance, self.interpolant_tables)
+
+    # The order of args for the C++ GSParams, which doesn't have the deprecated ones.
+    def _getcppargs(self):
+        return (int(self.minimum_fft_size), int(self.maximum_fft_size),
+                self.folding_threshold, self.stepk_minimum_hlr, self.maxk_threshold,
+                self.kvalue_accuracy, self.xvalue_accuracy, self.table_spacing,
+                self.realspace_relerr, self.realspace_abserr,
+                self.integration_relerr, self.integration_abserr,
+                self.shoot_accuracy, self.interpolant_phase_tolerance,
+                self.interpolant_tables)
 
     def __getstate__(self): return self._getinitargs()
     def __setstate__(self, state): self.__init__(*state)
 
     def __repr__(self):
-        return 'galsim.GSParams(%d,%d,%r,%r,%r,%r,%r,%d,%r,%r,%r,%r,%r)'% \
+        return 'galsim.GSParams(%d,%d,%r,%r,%r,%r,%r,%d,%r,%r,%r,%r,%r,%r,%r,%r,%r,%r)'% \
                 self._getinitargs()
 
     def __eq__(self, other):
@@ -115,6 +115,56 @@ def hankel(func, k, nu=0, rmax=None, rel_err=1.e-6, abs_err=1.e-12):
         _galsim.PyHankel(func, _k, _res, N, nu, rmax, rel_err, abs_err)
     return res
 
+def hankel_fftlog(func, kmin, dlogk, nk, nu=0, rel_err=1.e-6, abs_err=1.e-12):
+    r"""Perform an order nu Hankel transform of the given function f(r) at many log-spaced
+    values of k.
+
+    .. math::
+
+        F(k) = \int_0^\infty f(r) J_\nu(k r) r dr
+
+    This calculates the same thing as `hankel` with rmax=None, but for the values
+    :math:`k_i = k_{min} \exp(i\, dlogk)`, i = 0 .. nk-1.  All the values are calculated at once
+    using the FFTLog algorithm (Hamilton, 2000, MNRAS, 312, 257), which is much faster than
+    doing a separate integral for each k.
+
+    The accuracy is checked by repeating the calculation with half the spacing and a wider range
+    in r.  Any values where the two disagree by more than the requested accuracy are calculated
+    again with the method used by `hankel`.
+
+    The function f(r) should be smooth and fall off faster than 1/r at large r.
+
+    Parameters:
+
+        func:       The function f(r)
+        kmin:       The first (smallest) value of k.
+        dlogk:      The spacing of the k values in log(k).
+        nk:         The number of k values.
+        nu:         The order of the Bessel function to use for the transform. [default: 0]
+        rel_err:    The desired relative accuracy [default: 1.e-6]
+        abs_err:    The desired absolute accuracy [default: 1.e-12]
+
+    Returns:
+
+        A numpy array of the nk values of F(k)
+    """
+    rel_err = float(rel_err)
+    abs_err = float(abs_err)
+    nu = float(nu)
+    nk = int(nk)
+
+    if kmin <= 0:
+        raise GalSimValueError("kmin must be > 0",kmin)
+    if dlogk <= 0:
+        raise GalSimValueError("dlogk must be > 0",dlogk)
+    if nu < 0:
+        raise GalSimValueError("nu must be >= 0",nu)
+    res = np.empty(nk, dtype=float)
+    _res = res.__array_interface__['data'][0]
+    with convert_cpp_errors():
+        _galsim.PyHankelFFTLog(func, np.log(kmin), float(dlogk), nk, _res, nu, rel_err, abs_err)
+    return res
+
 class IntegrationRule:
     """A class that can be used to integrate something more complicated than a normal
     scalar function.
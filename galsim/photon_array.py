@@ -717,11 +717,9 @@ class PhotonArray:
         max_flux = float(max_flux)
         if (max_flux <= 0):
             raise GalSimRangeError("max_flux must be positive", max_flux, 0.)
-        total_flux = np.abs(image.array).sum(dtype=float)
-
-        # This goes a bit over what we actually need, but not by much.  Worth it to not have to
-        # worry about array reallocations.
-        N = int(np.prod(image.array.shape) + total_flux / max_flux)
+        # Count the photons we need first, so the arrays can be allocated at exactly the
+        # right size.
+        N = _galsim.PhotonArray.countFrom(image._image, max_flux)
         photons = cls(N)
 
         rng = BaseDeviate(rng)
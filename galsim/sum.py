@@ -301,6 +301,20 @@ class Sum(GSObject):
         kv_list = [obj.kValue(pos) for obj in self.obj_list]
         return np.sum(kv_list)
 
+    def _xValueMany(self, x, y, val):
+        self.obj_list[0]._xValueMany(x, y, val)
+        tmp = np.empty_like(val)
+        for obj in self.obj_list[1:]:
+            obj._xValueMany(x, y, tmp)
+            val += tmp
+
+    def _kValueMany(self, kx, ky, val):
+        self.obj_list[0]._kValueMany(kx, ky, val)
+        tmp = np.empty_like(val)
+        for obj in self.obj_list[1:]:
+            obj._kValueMany(kx, ky, tmp)
+            val += tmp
+
     def _drawReal(self, image, jac=None, offset=(0.,0.), flux_scaling=1.):
         self.obj_list[0]._drawReal(image, jac, offset, flux_scaling)
         if len(self.obj_list) > 1:
@@ -637,7 +637,10 @@ class LookupTable2D:
     For interpolant='spline', the derivatives df / dx, df / dy, and d^2 f / dx dy at grid-points may
     also optionally be provided if they're known, which will generally yield a more accurate
     interpolation (these derivatives will be estimated from finite differences if they're not
-    provided).
+    provided).  Also for interpolant='spline', setting ``precompute=True`` makes the table compute
+    the 16 bicubic polynomial coefficients of every grid cell up front.  This makes each lookup
+    quite a bit faster, at the cost of 16 doubles of memory per grid cell, so it is worth doing
+    when the table will be used for many lookups.
 
     The ``edge_mode`` keyword describes how to handle extrapolation beyond the initial input range.
     Possibilities include:
@@ -699,9 +702,11 @@ class LookupTable2D:
                         See above for details.  [default: 'raise']
         constant:       A constant to return when extrapolating beyond the input range and
                         ``edge_mode='constant'``.  [default: 0]
+        precompute:     Whether to precompute the bicubic coefficients of each grid cell.  Only
+                        used if interpolant='spline'.  [default: False]
     """
     def __init__(self, x, y, f, dfdx=None, dfdy=None, d2fdxdy=None,
-                 interpolant='linear', edge_mode='raise', constant=0):
+                 interpolant='linear', edge_mode='raise', constant=0, precompute=False):
         if edge_mode not in ('raise', 'warn', 'wrap', 'constant'):
             raise GalSimValueError("Unknown edge_mode.", edge_mode,
                                    ('raise', 'warn', 'wrap', 'constant'))
@@ -742,6 +747,7 @@ class LookupTable2D:
 
         self.edge_mode = edge_mode
         self.constant = float(constant)
+        self.precompute = bool(precompute)
 
         if self.edge_mode == 'wrap':
             # Can wrap if x and y arrays are equally spaced ...
@@ -836,7 +842,7 @@ class LookupTable2D:
             _dfdy = self.dfdy.__array_interface__['data'][0]
             _d2fdxdy = self.d2fdxdy.__array_interface__['data'][0]
             return _galsim.LookupTable2D(_x, _y, _f, len(self.x), len(self.y),
-                                         _dfdx, _dfdy, _d2fdxdy)
+                                         _dfdx, _dfdy, _d2fdxdy, self.precompute)
         else:
             return _galsim.LookupTable2D(_x, _y, _f, len(self.x), len(self.y),
                                          self.interpolant)
@@ -1105,9 +1111,9 @@ class LookupTable2D:
 
     def __repr__(self):
         return ("galsim.LookupTable2D(x=array(%r), y=array(%r), "
-                "f=array(%r), interpolant=%r, edge_mode=%r, constant=%r)"%(
+                "f=array(%r), interpolant=%r, edge_mode=%r, constant=%r, precompute=%r)"%(
             self.x.tolist(), self.y.tolist(), self.f.tolist(), self.interpolant, self.edge_mode,
-            self.constant))
+            self.constant, self.precompute))
 
     def __eq__(self, other):
         if self is other: return True
@@ -1150,7 +1156,7 @@ class LookupTable2D:
 
 def _LookupTable2D(x, y, f, interpolant, edge_mode, constant,
                    dfdx=None, dfdy=None, d2fdxdy=None,
-                   x0=None, y0=None, xperiod=None, yperiod=None):
+                   x0=None, y0=None, xperiod=None, yperiod=None, precompute=False):
     """Make a `LookupTable2D` but without using any of the sanity checks or array manipulation used
     in the normal initializer.
     """
@@ -1168,6 +1174,7 @@ def _LookupTable2D(x, y, f, interpolant, edge_mode, constant,
     ret.y0 = y0
     ret.xperiod = xperiod
     ret.yperiod = yperiod
+    ret.precompute = precompute
     if interpolant in ('nearest', 'linear', 'ceil', 'floor', 'spline'):
         ret._interp2d = None
     else:
@@ -568,6 +568,17 @@ class Transformation(GSObject):
         fwdT_kpos = _PositionD(*self._fwdT(kpos.x, kpos.y))
         return self._original._kValue(fwdT_kpos) * self._kfactor(kpos.x, kpos.y)
 
+    def _xValueMany(self, x, y, val):
+        # Note: _inv works in place, so start with new arrays.
+        u, v = self._inv(x - self._dx, y - self._dy)
+        self._original._xValueMany(u, v, val)
+        val *= self._amp_scaling
+
+    def _kValueMany(self, kx, ky, val):
+        u, v = self._fwdT(kx.copy(), ky.copy())
+        self._original._kValueMany(u, v, val)
+        val *= self._kfactor(kx.astype(complex), ky.astype(complex))
+
     def _drawReal(self, image, jac=None, offset=(0.,0.), flux_scaling=1.):
         dx, dy = offset
         if self._has_offset:
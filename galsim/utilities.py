@@ -1598,6 +1598,198 @@ def single_threaded(*, num_threads=1):
     if tpl is not None:  # pragma: no cover
         tpl.unregister()
 
+def get_profile_cache_stats():
+    """Get the usage statistics of the C++ caches of profile information.
+
+    Several profiles (e.g. `Sersic`, `Kolmogorov`, `VonKarman`) cache some expensive
+    precomputed information that depends only on a few of their parameters (and the
+    `GSParams`), so it can be shared by all profiles with the same values.  These statistics
+    may be useful to see whether the caches are large enough for a given simulation.
+
+    :returns: a dict indexed by the name of each cache.  Each value is a dict with the keys
+              ``size``, ``max_size``, ``memory`` (in bytes), ``hits``, ``misses``, and
+              ``evictions``.
+    """
+    stats = {}
+    for name, size, max_size, memory, hits, misses, evictions in _galsim.GetLRUCacheStats():
+        stats[name] = dict(size=size, max_size=max_size, memory=memory, hits=hits,
+                           misses=misses, evictions=evictions)
+    return stats
+
+def reset_profile_cache_stats():
+    """Reset the hit, miss and eviction counts reported by `get_profile_cache_stats`.
+
+    The cached values themselves are kept.
+    """
+    _galsim.ResetLRUCacheStats()
+
+def set_profile_cache_budget(nbytes):
+    """Set the memory budget for the C++ caches of profile information.
+
+    The budget is shared by all the caches listed by `get_profile_cache_stats`.  When their
+    total memory goes over the budget, the least recently used entries are removed (from
+    whichever cache holds them) until it is within the budget again.  Each cache also still
+    has its own maximum number of entries.
+
+    The default budget is 256 MB.
+
+    Parameters:
+        nbytes:     The budget in bytes.  Use 0 for no limit.
+    """
+    if nbytes < 0:
+        raise GalSimRangeError("nbytes must be >= 0", nbytes, 0)
+    _galsim.SetLRUCacheMemoryBudget(int(nbytes))
+
+def get_profile_cache_budget():
+    """Get the current memory budget in bytes for the C++ caches of profile information.
+
+    See `set_profile_cache_budget`.
+    """
+    return _galsim.GetLRUCacheMemoryBudget()
+
+def set_draw_cache(use):
+    """Set whether to save drawn images, so that drawing the same profile again is fast.
+
+    When this is turned on, each image drawn with ``method='no_pixel'``, ``'real_space'`` or
+    ``'sb'``, and each k-space image drawn for an FFT, is saved in a C++ cache.  The key is
+    a hash of the structure of the profile (the kind and parameters of every component and
+    their `GSParams`) along with the bounds, pixel scale, Jacobian, offset and flux scaling of
+    the image.  Drawing a profile with the same structure on the same image again just copies
+    the saved result, even if the profile was rebuilt from scratch in Python.
+
+    The cache holds a limited number of images and counts towards the memory budget set by
+    `set_profile_cache_budget`.  Its usage appears in `get_profile_cache_stats` under the
+    names ``Draw<float>``, ``Draw<double>``, ``DrawK<float>`` and ``DrawK<double>``.
+    Profiles that hold an image, such as `InterpolatedImage`, are always drawn directly.
+
+    Parameters:
+        use:    Whether to use the cache.
+    """
+    _galsim.SetDrawCache(bool(use))
+
+def get_draw_cache():
+    """Get whether drawn images are saved in a cache.
+
+    See `set_draw_cache`.
+    """
+    return _galsim.GetDrawCache()
+
+def set_sersic_interpolated_ft(interpolated):
+    """Set whether `Sersic` profiles interpolate their Fourier transform in n.
+
+    Normally, each new value of the Sersic index n requires a new lookup table for the Fourier
+    transform, which involves a numerical integral at several hundred values of k.  This is
+    slow when drawing a catalog in which nearly every galaxy has a different n.
+
+    When this is turned on, the transform is instead interpolated from a grid in (n, log k)
+    that is built the first time it is needed (once for each `GSParams`).  Building the grid
+    costs about as much as a hundred individual tables, but after that the setup for each
+    new n is just a series of lookups.
+
+    The interpolation changes the transform by up to about 10 times ``kvalue_accuracy``
+    (i.e. about 1.e-4 with the default `GSParams`), mostly for n less than about 2, at the
+    smallest values of k that use the table.  With the default `GSParams`, the direct
+    calculation is itself only accurate to a few times 1.e-4 at those values of k, so the
+    total error is similar either way.  Drawn images typically differ by less than 1.e-4 of
+    their peak value.
+
+    This only applies to untruncated profiles.  Truncated profiles always calculate their own
+    transform.  The setting takes effect when a profile is first drawn or evaluated, so it
+    does not change profiles that have already been used.
+
+    Parameters:
+        interpolated:   Whether to use the interpolated transform.
+    """
+    _galsim.SetSersicInterpolatedFT(bool(interpolated))
+
+def get_sersic_interpolated_ft():
+    """Get whether `Sersic` profiles interpolate their Fourier transform in n.
+
+    See `set_sersic_interpolated_ft`.
+    """
+    return _galsim.GetSersicInterpolatedFT()
+
+def set_vonkarman_interpolated(interpolated):
+    """Set whether `VonKarman` profiles interpolate their lookup tables on a parameter grid.
+
+    Normally, each new combination of ``lam/r0`` and ``L0/r0`` requires new lookup tables,
+    which take a few ms to build.  For a PSF whose parameters vary across the field, nearly
+    every profile is then a cache miss.
+
+    When this is turned on, the tables are only built at a reference value of ``lam/r0``, which
+    just sets the size of the profile, and at grid values of ``log(L0/r0)`` spaced 0.03 apart.
+    Each profile rescales the two nearest tables and interpolates linearly between them, so
+    after the first few profiles nearly every one is a cache hit.  The interpolated kValues
+    are accurate to about 1.e-5 of the flux.  The half-light radius is interpolated as well,
+    so it can differ by a percent or two from the direct calculation, which is itself only
+    accurate to the spacing of its table.
+
+    The setting takes effect when a profile is constructed, so it does not change profiles
+    that already exist.
+
+    Parameters:
+        interpolated:   Whether to interpolate the tables.
+    """
+    _galsim.SetVonKarmanInterpolated(bool(interpolated))
+
+def get_vonkarman_interpolated():
+    """Get whether `VonKarman` profiles interpolate their lookup tables on a parameter grid.
+
+    See `set_vonkarman_interpolated`.
+    """
+    return _galsim.GetVonKarmanInterpolated()
+
+def set_second_kick_interpolated(interpolated):
+    """Set whether `SecondKick` profiles interpolate their lookup tables on a grid in kcrit.
+
+    Normally, each new value of ``kcrit`` requires new lookup tables.  When this is turned on,
+    the tables are only built at grid values of ``log(kcrit)`` spaced 0.01 apart, and each
+    profile interpolates linearly between the two nearest ones.  The interpolated kValues are
+    accurate to about 1.e-5 of the flux.
+
+    The setting takes effect when a profile is first drawn or evaluated, so it does not change
+    profiles that have already been used.
+
+    Parameters:
+        interpolated:   Whether to interpolate the tables.
+    """
+    _galsim.SetSecondKickInterpolated(bool(interpolated))
+
+def get_second_kick_interpolated():
+    """Get whether `SecondKick` profiles interpolate their lookup tables on a grid in kcrit.
+
+    See `set_second_kick_interpolated`.
+    """
+    return _galsim.GetSecondKickInterpolated()
+
+def set_table_cache_dir(dir):
+    """Set a directory in which to save the lookup tables that some profiles build.
+
+    Some profiles (`Sersic`, `Kolmogorov`, `VonKarman`, `SecondKick`) build a lookup table
+    by doing a numerical integral at many points the first time they are used.  This is
+    normally repeated in every new process.  If a directory is set, the finished tables are
+    saved there, and any process that needs the same table (same parameters, same `GSParams`,
+    same GalSim version) loads it from the file instead of building it again.  This can speed
+    up the start of simulations that use many processes.
+
+    The directory may also be set with the environment variable GALSIM_TABLE_CACHE_DIR.
+    By default, no directory is set, so no files are written.
+
+    Parameters:
+        dir:    The directory to use.  It is created if it does not exist.  Use None or ''
+                to stop using the directory.
+    """
+    if dir:
+        os.makedirs(dir, exist_ok=True)
+    else:
+        dir = ''
+    _galsim.SetTableCacheDir(dir)
+
+def get_table_cache_dir():
+    """Get the directory set by `set_table_cache_dir`, or None if there isn't one.
+    """
+    return _galsim.GetTableCacheDir() or None
+
 
 
 # The rest of these are only used by the tests in GalSim.  But we make them available
@@ -296,6 +296,10 @@ class VonKarman(GSObject):
     def _xValue(self, pos):
         return self._sbvk.xValue(pos._p)
 
+    def _xValueMany(self, x, y, val):
+        self._sbvk.xValueMany(x.__array_interface__['data'][0], y.__array_interface__['data'][0],
+                              val.__array_interface__['data'][0], x.size)
+
     def _kValue(self, kpos):
         return self._sbp.kValue(kpos._p)
 
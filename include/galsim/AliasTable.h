@@ -0,0 +1,138 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2023 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#ifndef GalSim_AliasTable_H
+#define GalSim_AliasTable_H
+
+#include <vector>
+#include <cmath>
+#include "Std.h"
+
+namespace galsim {
+
+    /**
+     * @brief Class to make random draws of an index with known (unnormalized) probabilities
+     *
+     * This implements Walker's alias method, using Vose's construction.  After building the
+     * table from a vector of non-negative weights, each draw takes O(1) time regardless of
+     * the number of entries: the uniform deviate picks a column, and a single comparison
+     * decides between that column and its alias.
+     *
+     * Unlike ProbabilityTree, the table is just two flat arrays indexed by the position in the
+     * input weights, so there is no per-element allocation.  Calling `build()` again reuses
+     * the existing storage.
+     *
+     * Entries with zero weight are never selected.
+     */
+    class PUBLIC_API AliasTable
+    {
+    public:
+        /// @brief Constructor - nothing to do.
+        AliasTable() : _totalWeight(0.) {}
+
+        /**
+         * @brief Build the table from the given weights.
+         *
+         * @param[in] weights   The relative probability of each index.  Must be >= 0.
+         */
+        void build(const std::vector<double>& weights)
+        {
+            const int n = weights.size();
+            _prob.resize(n);
+            _alias.resize(n);
+            _totalWeight = 0.;
+            for (int i=0; i<n; ++i) _totalWeight += weights[i];
+            dbg<<"AliasTable build: n = "<<n<<", totalWeight = "<<_totalWeight<<std::endl;
+            if (n == 0 || !(_totalWeight > 0.)) {
+                _prob.clear();
+                _alias.clear();
+                return;
+            }
+
+            // Scale the weights so the mean is 1.  Then each column of the table gets its own
+            // entry with probability prob[i] and is topped up to 1 with part of one large entry.
+            const double scale = n / _totalWeight;
+            std::vector<int> small;
+            std::vector<int> large;
+            std::vector<int> zero;
+            small.reserve(n);
+            large.reserve(n);
+            for (int i=0; i<n; ++i) {
+                _prob[i] = weights[i] * scale;
+                _alias[i] = i;
+                if (_prob[i] == 0.) zero.push_back(i);
+                else if (_prob[i] < 1.) small.push_back(i);
+                else large.push_back(i);
+            }
+            // Put the zero-weight entries at the back of small, so they are paired off first.
+            // Otherwise rounding errors could leave one of them unpaired at the end.
+            small.insert(small.end(), zero.begin(), zero.end());
+            while (!small.empty() && !large.empty()) {
+                int s = small.back(); small.pop_back();
+                int l = large.back();
+                _alias[s] = l;
+                _prob[l] = (_prob[l] + _prob[s]) - 1.;
+                if (_prob[l] < 1.) {
+                    large.pop_back();
+                    small.push_back(l);
+                }
+            }
+            // Anything left over is 1 up to rounding errors.
+            for (size_t k=0; k<large.size(); ++k) _prob[large[k]] = 1.;
+            for (size_t k=0; k<small.size(); ++k) _prob[small[k]] = 1.;
+        }
+
+        /**
+         * @brief Choose an index based on a uniform deviate
+         *
+         * @param[in] unitRandom    A uniform deviate in [0,1).
+         * @returns the selected index.
+         */
+        int find(double unitRandom) const
+        {
+            const int n = _prob.size();
+            double u = unitRandom * n;
+            // Note: Don't need floor here, since u is positive, so floor is superfluous.
+            int i = int(u);
+            if (i >= n) i = n-1;  // should not happen, but be safe
+            return (u - i < _prob[i]) ? i : _alias[i];
+        }
+
+        /// @brief The number of entries in the table.
+        int size() const { return _prob.size(); }
+
+        /// @brief Whether the table is empty (or all weights were zero).
+        bool empty() const { return _prob.empty(); }
+
+        /// @brief The sum of the input weights.
+        double getTotalWeight() const { return _totalWeight; }
+
+        /// @brief Release the storage.
+        void clear() { _prob.clear(); _alias.clear(); _totalWeight = 0.; }
+
+    private:
+
+        std::vector<double> _prob;  ///< Probability of choosing column i itself
+        std::vector<int> _alias;    ///< The other index that shares column i
+        double _totalWeight;        ///< Sum of the input weights
+    };
+
+} // end namespace galsim
+
+#endif
@@ -39,11 +39,38 @@ namespace galsim {
      * The matrix is symmetric, and therefore only the upper triangular elements are actually
      * written into.  The rest are initialized and remain as zero.
      *
+     * The elements only depend on the pixel separation, so the profile is evaluated once for
+     * each distinct separation (using calculateCovarianceLags) and the values are copied into
+     * the matrix.
+     *
      * For an example of this function in use, see `galsim/correlatednoise.py`.
      */
     PUBLIC_API void calculateCovarianceMatrix(
         ImageView<double>& cov, const SBProfile& sbp,
         const Bounds<int>& bounds, double dx);
 
+    /**
+     * @brief Return the bounds of the lag table that calculateCovarianceMatrix uses for an
+     * Image with the supplied `bounds`.
+     */
+    PUBLIC_API Bounds<int> covarianceLagBounds(const Bounds<int>& bounds);
+
+    /**
+     * @brief Fill an Image with the values of a correlation function at each pixel separation.
+     *
+     * Each pixel (k, ell) of `lags` is set to the value of `sbp` at (k dx, ell dx).  With the
+     * bounds given by covarianceLagBounds, this is a compact form of the covariance matrix
+     * from calculateCovarianceMatrix.  The element (i, j) of that matrix is lags(k, ell) with
+     *
+     *     k = (j-1) / jdim - (i-1) / idim
+     *     ell = (j-1) % jdim - (i-1) % idim
+     *
+     * where idim, jdim are the dimensions of the image.  The table has
+     * (idim+jdim-1)^2 elements rather than (idim jdim)^2, so it is much more practical for
+     * large images.  The rows are calculated in parallel if OpenMP is enabled.
+     */
+    PUBLIC_API void calculateCovarianceLags(
+        ImageView<double> lags, const SBProfile& sbp, double dx);
+
 }
 #endif
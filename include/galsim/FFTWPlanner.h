@@ -0,0 +1,35 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2023 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#ifndef GalSim_FFTWPlanner_H
+#define GalSim_FFTWPlanner_H
+
+#include <mutex>
+#include "Std.h"
+
+namespace galsim {
+
+    // Only fftw_execute is thread safe in FFTW.  Everything else, in particular making and
+    // destroying plans, uses the shared planner state.  So every place in GalSim that calls
+    // fftw_plan_* or fftw_destroy_plan should hold this lock while doing so.
+    PUBLIC_API std::mutex& GetFFTWPlannerMutex();
+
+}
+
+#endif
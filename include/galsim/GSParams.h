@@ -84,6 +84,15 @@ namespace galsim {
          *                            convolution).
          * @param integration_abserr  Target absolute accuracy for integrals (other than real-space
          *                            convolution).
+         * @param interpolant_phase_tolerance  If > 0, interpolated images may round the sub-pixel
+         *                            phase of each sample point to a grid with at most this
+         *                            error (in pixels), so the interpolant weights can be
+         *                            tabulated once and reused.  0 means to use exact phases.
+         * @param interpolant_tables  Whether the Cubic, Quintic and Lanczos interpolants should
+         *                            evaluate their real- and Fourier-space kernels from
+         *                            tabulated values with linear interpolation, rather than
+         *                            calculating them directly.  The tables are accurate to
+         *                            xvalue_accuracy and kvalue_accuracy respectively.
          *
          * The Photon Shooting relevant params are:
          *
@@ -105,7 +114,9 @@ namespace galsim {
                  double _realspace_abserr,
                  double _integration_relerr,
                  double _integration_abserr,
-                 double _shoot_accuracy);
+                 double _shoot_accuracy,
+                 double _interpolant_phase_tolerance,
+                 bool _interpolant_tables);
 
         /**
          * A reasonable set of default values
@@ -126,12 +137,18 @@ namespace galsim {
             integration_relerr(1.e-6),
             integration_abserr(1.e-8),
 
-            shoot_accuracy(1.e-5)
+            shoot_accuracy(1.e-5),
+
+            interpolant_phase_tolerance(0.),
+            interpolant_tables(false)
             {}
 
         bool operator==(const GSParams& rhs) const;
         bool operator<(const GSParams& rhs) const;
 
+        // A hash of all the parameters, consistent with operator==.
+        size_t hash() const;
+
         // These are all public.  So you access them just as member values.
         int minimum_fft_size;
         int maximum_fft_size;
@@ -151,6 +168,9 @@ namespace galsim {
 
         double shoot_accuracy;
 
+        double interpolant_phase_tolerance;
+        bool interpolant_tables;
+
     };
 
     PUBLIC_API std::ostream& operator<<(std::ostream& os, const GSParams& gsp);
@@ -187,6 +207,7 @@ namespace galsim {
 
         bool operator==(const GSParamsPtr& rhs) const { return *_p == *rhs; }
         bool operator<(const GSParamsPtr& rhs) const { return *_p < *rhs; }
+        size_t hash() const { return _p->hash(); }
 
     private :
         shared_ptr<GSParams> _p;
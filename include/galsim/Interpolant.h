@@ -22,6 +22,9 @@
 
 #include <cmath>
 #include <map>
+#include <vector>
+#include <atomic>
+#include <functional>
 
 #include "Std.h"
 #include "Table.h"
@@ -47,6 +50,49 @@ namespace galsim {
         const Interpolant& _interp;  // Interpolant being wrapped
     };
 
+    /**
+     * @brief A symmetric function tabulated on a uniform grid for fast evaluation.
+     *
+     * The function f(|x|) is tabulated for 0 <= |x| <= xmax and evaluated by linear
+     * interpolation between the two nearest entries.  Outside of this range, the value is 0.
+     * The grid spacing is halved until the interpolated values at the midpoints of the grid
+     * cells are all within tol of the true values, up to a maximum of 2^20 cells.  If tol still
+     * isn't reached then, isAccurate() returns false, and the table shouldn't be used.
+     *
+     * If xmax is an integer, the grid includes all the integers, so an interpolant's values
+     * at the nodes are reproduced exactly.
+     */
+    class PUBLIC_API InterpolantTable
+    {
+    public:
+        InterpolantTable(const std::function<double(double)>& func, double xmax, double tol);
+
+        double operator()(double x) const
+        {
+            x = std::abs(x);
+            if (!(x < _xmax)) return 0.;
+            double t = x * _invdx;
+            int i = int(t);
+            return _f[i] + (t-i) * (_f[i+1] - _f[i]);
+        }
+
+        // Replace each x[i] with the value at x[i].  Uses SSE2 where available.
+        void evalMany(double* x, int N) const;
+
+        int size() const { return int(_f.size()); }
+
+        // Whether the table reached the requested tolerance.
+        bool isAccurate() const { return _accurate; }
+
+    private:
+        double _xmax;
+        double _invdx;
+        bool _accurate;
+        // The values at x = i/_invdx for i = 0..n, plus an extra 0 at the end, so that
+        // x values that round up to xmax are still safe to interpolate.
+        std::vector<double> _f;
+    };
+
     /**
      * @brief Base class representing one-dimensional interpolant functions
      *
@@ -64,10 +110,13 @@ namespace galsim {
          * @param[in] gsparams  GSParams object storing constants that control the accuracy of
          *                      operations, if different from the default.
          */
-        Interpolant(const GSParams& gsparams) : _gsparams(gsparams), _interp(*this) {}
+        Interpolant(const GSParams& gsparams) :
+            _gsparams(gsparams), _interp(*this), _nPhase(0) {}
 
         /// @brief Copy constructor: does not copy photon sampler, will need to rebuild.
-        Interpolant(const Interpolant& rhs): _gsparams(rhs._gsparams), _interp(rhs._interp) {}
+        Interpolant(const Interpolant& rhs):
+            _gsparams(rhs._gsparams), _interp(rhs._interp), _nPhase(0),
+            _xtable(rhs._xtable), _utable(rhs._utable) {}
 
         /// @brief Destructor
         virtual ~Interpolant() {}
@@ -108,6 +157,10 @@ namespace galsim {
 
         /**
          * @brief Calculate xval for array of input values x
+         *
+         * If the interpolant has a lookup table for xval (cf. gsparams.interpolant_tables),
+         * this uses a vectorized version of the table lookup.
+         *
          * @param[in/out]   Each x[i] is replaces by xval[x[i]]
          * @param[in]       How many x values to calculate
          */
@@ -123,11 +176,45 @@ namespace galsim {
 
         /**
          * @brief Calculate uval for array of input values u
+         *
+         * If the interpolant has a lookup table for uval (cf. gsparams.interpolant_tables),
+         * this uses a vectorized version of the table lookup.
+         *
          * @param[in/out]   Each u[i] is replaces by uval[u[i]]
          * @param[in]       How many u values to calculate
          */
         void uvalMany(double* u, int N) const;
 
+        /**
+         * @brief Report whether interpolation should use the tabulated weights from
+         * getPhaseWeights rather than calling xval for each sample point.
+         *
+         * This is true when gsparams.interpolant_phase_tolerance > 0, unless the table of
+         * weights would be impractically large (e.g. for a SincInterpolant).
+         */
+        bool usePhaseWeights() const;
+
+        /**
+         * @brief The number of weights returned by getPhaseWeights.
+         */
+        int nPhaseWeights() const { return 2*int(std::ceil(xrange()))+1; }
+
+        /**
+         * @brief Get the weights for interpolating at x, with the sub-pixel phase of x rounded
+         * to a grid of phases.
+         *
+         * The grid has a spacing of 1/N pixels, where N is the smallest integer for which the
+         * rounding error is at most gsparams.interpolant_phase_tolerance.  The weights for all
+         * the phases on the grid are calculated on first use, and then they are shared by all
+         * subsequent calls.
+         *
+         * @param[in]  x    The position at which to interpolate (pixels).
+         * @param[out] p0   The returned weights are xval(p-xq) for p = p0 .. p0+nPhaseWeights()-1,
+         *                  where xq is x rounded to the grid.
+         * @returns a pointer to the nPhaseWeights() weights.
+         */
+        const double* getPhaseWeights(double x, int& p0) const;
+
         /**
          * @brief Report whether interpolation will reproduce values at samples
          *
@@ -183,8 +270,24 @@ namespace galsim {
         virtual void shoot(PhotonArray& photons, UniformDeviate ud) const
         { checkSampler(); _sampler->shoot(photons, ud, true); }
 
+        /**
+         * @brief Build the photon sampler if it is needed and hasn't been built yet.
+         *
+         * shoot() may be called from several threads at once, so this should be called first
+         * from a single thread.
+         */
+        virtual void prepareShoot() const { checkSampler(); }
+
         virtual std::string makeStr() const =0;
 
+        /**
+         * @brief Make a new interpolant of the same kind, with the same parameters.
+         *
+         * This lets a class keep its own interpolant, rather than a reference to one that the
+         * caller has to keep alive.
+         */
+        virtual shared_ptr<Interpolant> clone() const =0;
+
     protected:
 
         GSParams _gsparams;
@@ -193,21 +296,35 @@ namespace galsim {
         // Class that draws photons from this Interpolant
         mutable shared_ptr<OneDimensionalDeviate> _sampler;
 
+        // The weights xval(k-iq/N) for k = -K..K, iq = 0..N-1, stored with all the k values
+        // for each iq contiguous.  Built by checkPhaseWeights the first time they are needed.
+        mutable std::vector<double> _phaseWeights;
+        mutable std::atomic<int> _nPhase;
+
+        // Optional lookup tables for xval and uval.  These are only set by the interpolants
+        // that support gsparams.interpolant_tables.
+        shared_ptr<InterpolantTable> _xtable;
+        shared_ptr<InterpolantTable> _utable;
+
         // Allocate photon sampler and do all of its pre-calculations
         virtual void checkSampler() const
         {
-            if (_sampler.get()) return;
-            // Will assume by default that the Interpolant kernel changes sign at non-zero
-            // integers, with one extremum in each integer range.
-            int nKnots = int(ceil(xrange()));
-            std::vector<double> ranges(2*nKnots);
-            for (int i=1; i<=nKnots; i++) {
-                double knot = std::min(double(i), xrange());
-                ranges[nKnots-i] = -knot;
-                ranges[nKnots+i-1] = knot;
+            if (!_sampler.get()) {
+                // Will assume by default that the Interpolant kernel changes sign at non-zero
+                // integers, with one extremum in each integer range.
+                int nKnots = int(ceil(xrange()));
+                std::vector<double> ranges(2*nKnots);
+                for (int i=1; i<=nKnots; i++) {
+                    double knot = std::min(double(i), xrange());
+                    ranges[nKnots-i] = -knot;
+                    ranges[nKnots+i-1] = knot;
+                }
+                _sampler.reset(new OneDimensionalDeviate(_interp, ranges, false, 1.0, _gsparams));
             }
-            _sampler.reset(new OneDimensionalDeviate(_interp, ranges, false, 1.0, _gsparams));
         }
+
+        // Tabulate the weights used by getPhaseWeights
+        void checkPhaseWeights() const;
     };
 
     /**
@@ -247,8 +364,11 @@ namespace galsim {
         double getPositiveFlux() const { return 1.; }
         double getNegativeFlux() const { return 0.; }
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
+        void prepareShoot() const {}
 
         std::string makeStr() const;
+        shared_ptr<Interpolant> clone() const
+        { return shared_ptr<Interpolant>(new Delta(_gsparams)); }
     };
 
     /**
@@ -284,8 +404,11 @@ namespace galsim {
         double getPositiveFlux() const { return 1.; }
         double getNegativeFlux() const { return 0.; }
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
+        void prepareShoot() const {}
 
         std::string makeStr() const;
+        shared_ptr<Interpolant> clone() const
+        { return shared_ptr<Interpolant>(new Nearest(_gsparams)); }
     };
 
     /**
@@ -318,8 +441,11 @@ namespace galsim {
         double uval(double u) const;
 
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
+        void prepareShoot() const {}
 
         std::string makeStr() const;
+        shared_ptr<Interpolant> clone() const
+        { return shared_ptr<Interpolant>(new SincInterpolant(_gsparams)); }
     };
 
     /**
@@ -354,8 +480,11 @@ namespace galsim {
         double getNegativeFlux() const { return 0.; }
         // Linear interpolant has fast photon-shooting by adding two uniform deviates per
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
+        void prepareShoot() const {}
 
         std::string makeStr() const;
+        shared_ptr<Interpolant> clone() const
+        { return shared_ptr<Interpolant>(new Linear(_gsparams)); }
     };
 
     /**
@@ -390,20 +519,22 @@ namespace galsim {
         double getNegativeFlux() const { return 1./12.; }
 
         std::string makeStr() const;
+        shared_ptr<Interpolant> clone() const
+        { return shared_ptr<Interpolant>(new Cubic(_gsparams)); }
 
     private:
         // x range, reduced slightly from n=2 so we're not using zero-valued endpoints.
         double _range;
-
-        shared_ptr<TableBuilder> _tab; // Tabulated Fourier transform
         double _uMax;  // Truncation point for Fourier transform
 
-        // Calculate the FT from a direct integration.
-        double uCalc(double u, double tolerance) const;
+        // The analytic formulae for xval and uval, for x,u >= 0.
+        double xCalc(double x) const;
+        double uCalc(double u) const;
 
-        // Store the tables in a map, so repeat constructions are quick.
-        static std::map<double,shared_ptr<TableBuilder> > _cache_tab;
-        static std::map<double,double> _cache_umax;
+        // Store the lookup tables in a map, keyed by the accuracy, so repeat constructions
+        // are quick.
+        static std::map<double,shared_ptr<InterpolantTable> > _cache_xtable;
+        static std::map<double,shared_ptr<InterpolantTable> > _cache_utable;
     };
 
     /**
@@ -437,6 +568,8 @@ namespace galsim {
         double getNegativeFlux() const { return 0.1293413499280066555; }
 
         std::string makeStr() const;
+        shared_ptr<Interpolant> clone() const
+        { return shared_ptr<Interpolant>(new Quintic(_gsparams)); }
 
     protected:
         // Override default sampler configuration because Quintic filter has sign change in
@@ -445,15 +578,16 @@ namespace galsim {
 
     private:
         double _range; // Reduce range slightly from n so we're not using zero-valued endpoints.
-        shared_ptr<TableBuilder> _tab; // Tabulated Fourier transform
         double _uMax;  // Truncation point for Fourier transform
 
-        // Calculate the FT from a direct integration.
-        double uCalc(double u, double tolerance) const;
+        // The analytic formulae for xval and uval, for x,u >= 0.
+        double xCalc(double x) const;
+        double uCalc(double u) const;
 
-        // Store the tables in a map, so repeat constructions are quick.
-        static std::map<double,shared_ptr<TableBuilder> > _cache_tab;
-        static std::map<double,double> _cache_umax;
+        // Store the lookup tables in a map, keyed by the accuracy, so repeat constructions
+        // are quick.
+        static std::map<double,shared_ptr<InterpolantTable> > _cache_xtable;
+        static std::map<double,shared_ptr<InterpolantTable> > _cache_utable;
     };
 
     /**
@@ -493,6 +627,8 @@ namespace galsim {
         double uval(double u) const;
 
         std::string makeStr() const;
+        shared_ptr<Interpolant> clone() const
+        { return shared_ptr<Interpolant>(new Lanczos(_n, _conserve_dc, _gsparams)); }
 
     private:
         int _n; // Store the filter order, n
@@ -502,7 +638,6 @@ namespace galsim {
         double _uMax;  // truncation point for Fourier transform
         std::vector<double> _K; // coefficients for flux correction in xval
         std::vector<double> _C; // coefficients for flux correction in uval
-        shared_ptr<TableBuilder> _xtab; // Table for x values
         shared_ptr<TableBuilder> _utab; // Table for Fourier transform
 
         double xCalc(double x) const;
@@ -511,9 +646,10 @@ namespace galsim {
 
         // Store the tables in a map, so repeat constructions are quick.
         typedef std::pair<int,std::pair<bool,double> > KeyType;
-        static std::map<KeyType,shared_ptr<TableBuilder> > _cache_xtab;
         static std::map<KeyType,shared_ptr<TableBuilder> > _cache_utab;
         static std::map<KeyType,double> _cache_umax;
+        static std::map<KeyType,shared_ptr<InterpolantTable> > _cache_xtable;
+        static std::map<KeyType,shared_ptr<InterpolantTable> > _cache_utable;
     };
 
 }
@@ -22,6 +22,14 @@
 
 #include <list>
 #include <map>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <future>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include "Std.h"
 
 namespace galsim {
 
@@ -144,6 +152,173 @@ namespace galsim {
         }
     };
 
+    // Hash function used to pick the shard of the LRUCache.  It must be consistent with the
+    // equivalence defined by operator< for the Key type.  The default is to call key.hash(),
+    // which works for GSParamsPtr.  Other key types can be added by specializing this struct.
+    template <typename Key>
+    struct LRUCacheHash
+    {
+        size_t operator()(const Key& key) const { return key.hash(); }
+    };
+
+    template <>
+    struct LRUCacheHash<double>
+    {
+        // Note: std::hash<double> gives the same hash for 0. and -0., which compare equal.
+        size_t operator()(double key) const { return std::hash<double>()(key); }
+    };
+
+    template <>
+    struct LRUCacheHash<int>
+    {
+        size_t operator()(int key) const { return std::hash<int>()(key); }
+    };
+
+    template <>
+    struct LRUCacheHash<bool>
+    {
+        size_t operator()(bool key) const { return std::hash<bool>()(key); }
+    };
+
+    // Combine a new hash value into a running hash (the same mixing as boost::hash_combine).
+    inline void HashCombine(size_t& seed, size_t h)
+    { seed ^= h + 0x9e3779b9 + (seed<<6) + (seed>>2); }
+
+    template <typename T1, typename T2, typename T3, typename T4, typename T5>
+    struct LRUCacheHash<Tuple<T1,T2,T3,T4,T5> >
+    {
+        size_t operator()(const Tuple<T1,T2,T3,T4,T5>& key) const
+        {
+            size_t h = LRUCacheHash<T1>()(key.first);
+            HashCombine(h, LRUCacheHash<T2>()(key.second));
+            HashCombine(h, LRUCacheHash<T3>()(key.third));
+            HashCombine(h, LRUCacheHash<T4>()(key.fourth));
+            HashCombine(h, LRUCacheHash<T5>()(key.fifth));
+            return h;
+        }
+    };
+
+    // Helper to get the memory used by a Value, in bytes.
+    // Normal case is that the Value has a method getMemorySize().
+    template <typename Value>
+    struct LRUCacheMemory
+    {
+        static size_t GetMemorySize(const Value& value)
+        { return value.getMemorySize(); }
+    };
+
+    /**
+     * @brief Base class for cached values that build some of their data lazily.
+     *
+     * The LRUCache measures each value with getMemorySize() once, right after it is built.
+     * A value that builds more data later, e.g. a lookup table the first time it is needed,
+     * should derive from this class and call addMemory() with the size of that data once it
+     * is built, so the cache counts it too.
+     */
+    class LRUCacheValue
+    {
+    public:
+        LRUCacheValue() {}
+
+    protected:
+        void addMemory(size_t bytes) const
+        { if (bytes > 0 && _add_memory) _add_memory(bytes); }
+
+    private:
+        template <typename Key, typename Value>
+        friend class LRUCache;
+
+        // Set by the LRUCache before any other thread can see the value.
+        std::function<void(size_t)> _add_memory;
+
+        // Not copyable.
+        LRUCacheValue(const LRUCacheValue&);
+        void operator=(const LRUCacheValue&);
+    };
+
+    /**
+     * @brief Base class for the LRUCache, which keeps the usage statistics and the memory budget.
+     *
+     * Every cache registers itself under a name, so the statistics for all of them can be
+     * listed (e.g. from Python) to help decide how large the caches should be.
+     *
+     * In addition to its own limit on the number of entries, each cache keeps track of the
+     * memory used by its values.  There is a single memory budget shared by all the caches.
+     * When the total memory of all the caches goes over the budget, the least recently used
+     * values (across all caches) are removed until it is under the budget again.
+     */
+    class PUBLIC_API LRUCacheBase
+    {
+    public:
+        LRUCacheBase(const std::string& name);
+        virtual ~LRUCacheBase();
+
+        const std::string& getName() const { return _name; }
+
+        /// @brief The number of values currently in the cache.
+        virtual size_t size() const = 0;
+
+        /// @brief The maximum number of values the cache will hold.
+        virtual size_t getMaxSize() const = 0;
+
+        /// @brief Remove all values from the cache.
+        virtual void clear() = 0;
+
+        /// @brief The memory used by the values currently in the cache, in bytes.
+        size_t getMemorySize() const { return _bytes; }
+
+        /// @brief The number of calls to get() that found the key in the cache.
+        long getHits() const { return _hits; }
+
+        /// @brief The number of calls to get() that needed to build a new value.
+        long getMisses() const { return _misses; }
+
+        /// @brief The number of values that were removed to make room for new ones.
+        long getEvictions() const { return _evictions; }
+
+        /// @brief Reset the hit, miss and eviction counters to zero.
+        void resetStats() { _hits = 0; _misses = 0; _evictions = 0; }
+
+        /// @brief Get all the caches that currently exist.
+        static std::vector<LRUCacheBase*> GetCaches();
+
+        /// @brief Set the memory budget for all caches together, in bytes.  0 means no limit.
+        static void SetMemoryBudget(size_t nbytes);
+
+        /// @brief Get the current memory budget in bytes.
+        static size_t GetMemoryBudget();
+
+        /// @brief The total memory used by all the caches, in bytes.
+        static size_t GetTotalMemorySize();
+
+    protected:
+        // Remove the least recently used values from any cache until the total memory is
+        // within the budget.
+        static void EnforceMemoryBudget();
+
+        // The time stamp of the least recently used value that could be removed, or -1 if
+        // there is no such value.
+        virtual long oldestTime() const = 0;
+
+        // Remove the value with the given time stamp (as returned by oldestTime).
+        virtual void evictOldest(long time) = 0;
+
+        // A global counter used as a time stamp, to compare the use of values across caches.
+        static long NextTime();
+
+        std::atomic<long> _hits;
+        std::atomic<long> _misses;
+        std::atomic<long> _evictions;
+        std::atomic<size_t> _bytes;
+
+    private:
+        std::string _name;
+
+        // Not copyable.
+        LRUCacheBase(const LRUCacheBase&);
+        void operator=(const LRUCacheBase&);
+    };
+
     /**
      * @brief Least Recently Used Cache
      *
@@ -156,28 +331,53 @@ namespace galsim {
      *    Key key;
      *    Value* value = new Value(key);
      *
-     * Special: if Key is a Tuple<Key1, Key2, ...> (up to 4), then value takes that many args:
+     * Special: if Key is a Tuple<Key1, Key2, ...> (up to 5), then value takes that many args:
      *
      *    Tuple<Key1,Key2> key(key1,key2);
      *    Value* value = new Value(key1,key2);
      *
+     * The Value type should also have a method getMemorySize() returning (an estimate of) the
+     * number of bytes it uses, including sizeof(Value).  This is measured once, right after
+     * the value is built.  (Measuring it again later could race with another thread building
+     * part of it.)  If Value derives from LRUCacheValue, anything it builds lazily later is
+     * added to that when it reports it with addMemory().  The total is removed again when the
+     * value is evicted.
+     *
      * This structure will first look to see if we have already build such a Value given a
      * provided Key, and return it if it is in the cache.  Otherwise, it builds a new Value,
      * saves it in the cache, and returns it.
      *
-     * At most nmax items will be saved in the cache.
+     * The cache may be used from several threads at once.  The keys are split into nshard
+     * shards according to LRUCacheHash<Key>, each with its own lock and its own LRU list,
+     * so threads looking up different keys rarely wait for each other.  The lock is only
+     * held for the map lookup, never while a new Value is being built.  If several threads
+     * ask for the same missing key, only the first one builds the Value; the others wait for
+     * it and then share the result.  If building the Value throws, all of the waiting threads
+     * get the exception and the key is removed again, so a later call will try again.
      *
+     * At most nmax items will be saved in the cache.  This limit applies to the cache as a
+     * whole, not to each shard, and when it is reached the least recently used item in any
+     * shard is removed.  (While other threads are adding items at the same time, the cache may
+     * briefly hold one extra item per such thread.)  Items may also be removed earlier to keep
+     * the total memory of all caches within the budget.  See LRUCacheBase.
      */
     template <typename Key, typename Value>
-    class LRUCache
+    class LRUCache : public LRUCacheBase
     {
     public:
         /**
          * @brief Constructor
          *
-         * @param[in] nmax  How many values to save in the cache.
+         * @param[in] name      A name for the cache, used when reporting statistics.
+         * @param[in] nmax      How many values to save in the cache.
+         * @param[in] nshard    How many independent shards to use. [default: 8]
          */
-        LRUCache(size_t nmax) : _nmax(nmax) {}
+        LRUCache(const std::string& name, size_t nmax, int nshard=8) :
+            LRUCacheBase(name), _nmax(std::max(nmax, size_t(1))), _count(0),
+            _shards(std::max(nshard,1))
+        {
+            for (size_t i=0; i<_shards.size(); ++i) _shards[i].reset(new Shard());
+        }
 
         /**
          * @brief Destructor
@@ -187,47 +387,215 @@ namespace galsim {
         ~LRUCache() {}
 
         shared_ptr<Value> get(const Key& key)
+        { return get(key, [&key]() { return LRUCacheHelper<Value,Key>::NewValue(key); }); }
+
+        /**
+         * @brief Get the value for key, using make() to build it if necessary.
+         *
+         * This is for values that need more than the key to be built, e.g. a profile to draw.
+         * make() is only called during this call, so it may refer to local variables.  The key
+         * must still determine the value completely, since later calls may get this value.
+         */
+        template <typename Make>
+        shared_ptr<Value> get(const Key& key, Make make)
         {
-            assert(_entries.size() == _cache.size());
-            MapIter iter = _cache.find(key);
-            if (iter != _cache.end()) {
-                // Item is cached.
-                // Move it to the front of the list.
-                if (iter != _cache.begin())
-                    _entries.splice(_entries.begin(), _entries, iter->second);
-                // Return the item's value
-                assert(_entries.size() == _cache.size());
-                return iter->second->second;
-            } else {
-                // Item is not cached.
-                // Make a new one.
-                shared_ptr<Value> value(LRUCacheHelper<Value,Key>::NewValue(key));
-                // Remove items from the cache as necessary.
-                while (_entries.size() >= _nmax) {
-                    _cache.erase(_entries.back().first);
-                    _entries.pop_back();
+            Shard& shard = *_shards[LRUCacheHash<Key>()(key) % _shards.size()];
+            std::shared_future<shared_ptr<Value> > future;
+            std::promise<shared_ptr<Value> > promise;
+            long id = 0;
+            bool check_size = false;
+            bool check_budget = false;
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                assert(shard.entries.size() == shard.cache.size());
+                MapIter iter = shard.cache.find(key);
+                if (iter != shard.cache.end()) {
+                    // Item is cached (or being built by another thread).
+                    // Move it to the front of the list.
+                    ++_hits;
+                    Entry& entry = *iter->second;
+                    shard.entries.splice(shard.entries.begin(), shard.entries, iter->second);
+                    entry.time = NextTime();
+                    future = entry.future;
+                } else {
+                    // Item is not cached.
+                    // Add a placeholder for the new value to the front.
+                    ++_misses;
+                    future = promise.get_future().share();
+                    id = ++shard.next_id;
+                    shard.entries.push_front(Entry(key, future, id, NextTime()));
+                    // Also put it in the cache
+                    shard.cache[key] = shard.entries.begin();
+                    check_size = ++_count > _nmax;
+                }
+                assert(shard.entries.size() == shard.cache.size());
+            }
+            if (id) {
+                // We are responsible for making the new value.  Do this outside the lock,
+                // since it can take a while.
+                shared_ptr<Value> value;
+                try {
+                    value.reset(make());
+                } catch (...) {
+                    promise.set_exception(std::current_exception());
+                    // Remove the failed entry, unless it has already been evicted and replaced.
+                    std::lock_guard<std::mutex> lock(shard.mutex);
+                    MapIter iter = shard.cache.find(key);
+                    if (iter != shard.cache.end() && iter->second->id == id) {
+                        shard.entries.erase(iter->second);
+                        shard.cache.erase(iter);
+                        --_count;
+                    }
+                    throw;
+                }
+                // Record the memory used by the new value.  Measure it before any other
+                // thread can see it, so nothing can be building part of it concurrently.
+                size_t bytes = LRUCacheMemory<Value>::GetMemorySize(*value);
+                trackMemory(value.get(), shard, key, id);
+                promise.set_value(value);
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                MapIter iter = shard.cache.find(key);
+                if (iter != shard.cache.end() && iter->second->id == id) {
+                    iter->second->value = value;
+                    // Another thread may already have added memory the value built lazily.
+                    iter->second->bytes += bytes;
+                    _bytes += bytes;
+                    check_budget = true;
+                }
+                // Placeholders can't be evicted, so another thread may have left the cache
+                // over its limit while this value was being built.
+                check_size = _count > _nmax;
+            }
+            // Remove items from the cache as necessary.  This is done outside the shard lock,
+            // since the least recently used item may be in any shard.
+            if (check_size) enforceMaxSize();
+            if (check_budget) EnforceMemoryBudget();
+            // Return the value.  This waits if another thread is still building it, and
+            // rethrows the exception if building it failed.
+            return future.get();
+        }
+
+        size_t size() const { return _count; }
+
+        size_t getMaxSize() const { return _nmax; }
+
+        void clear()
+        {
+            for (size_t i=0; i<_shards.size(); ++i) {
+                std::lock_guard<std::mutex> lock(_shards[i]->mutex);
+                for (ListIter it=_shards[i]->entries.begin(); it!=_shards[i]->entries.end(); ++it)
+                    _bytes -= it->bytes;
+                _count -= _shards[i]->entries.size();
+                _shards[i]->cache.clear();
+                _shards[i]->entries.clear();
+            }
+        }
+
+    protected:
+
+        long oldestTime() const
+        {
+            long oldest = -1;
+            for (size_t i=0; i<_shards.size(); ++i) {
+                std::lock_guard<std::mutex> lock(_shards[i]->mutex);
+                const std::list<Entry>& entries = _shards[i]->entries;
+                // Skip any values that are still being built.  They don't use memory yet.
+                for (typename std::list<Entry>::const_reverse_iterator it=entries.rbegin();
+                     it!=entries.rend(); ++it) {
+                    if (it->value) {
+                        if (oldest < 0 || it->time < oldest) oldest = it->time;
+                        break;
+                    }
+                }
+            }
+            return oldest;
+        }
+
+        void evictOldest(long time)
+        {
+            for (size_t i=0; i<_shards.size(); ++i) {
+                std::lock_guard<std::mutex> lock(_shards[i]->mutex);
+                std::list<Entry>& entries = _shards[i]->entries;
+                for (ListIter it=entries.end(); it!=entries.begin();) {
+                    --it;
+                    if (it->time == time) {
+                        _bytes -= it->bytes;
+                        _shards[i]->cache.erase(it->key);
+                        entries.erase(it);
+                        --_count;
+                        ++_evictions;
+                        return;
+                    }
+                    if (it->value) break;  // This shard doesn't have it.
                 }
-                // Add the new value to the front.
-                _entries.push_front(Entry(key,value));
-                // Also put it in the cache
-                _cache[key] = _entries.begin();
-                // Return the new value
-                assert(_entries.size() == _cache.size());
-                return value;
             }
         }
 
     private:
 
-        size_t _nmax;
+        // Let a value that derives from LRUCacheValue report the memory it builds lazily.
+        struct Shard;
+        void trackMemory(LRUCacheValue* value, Shard& shard, const Key& key, long id)
+        {
+            Shard* sp = &shard;
+            value->_add_memory = [this, sp, key, id](size_t bytes)
+            { this->addValueMemory(*sp, key, id, bytes); };
+        }
+        void trackMemory(void*, Shard&, const Key&, long) {}
+
+        void addValueMemory(Shard& shard, const Key& key, long id, size_t bytes)
+        {
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                MapIter iter = shard.cache.find(key);
+                // If the value has been evicted, it isn't counted any more.
+                if (iter == shard.cache.end() || iter->second->id != id) return;
+                iter->second->bytes += bytes;
+                _bytes += bytes;
+            }
+            EnforceMemoryBudget();
+        }
 
-        typedef std::pair<Key, shared_ptr<Value> > Entry;
-        std::list<Entry> _entries;
+        // Remove the least recently used values until there are at most nmax of them.
+        // If several threads do this at once, evictOldest just doesn't find a value that
+        // another thread has already removed, so we never remove more than necessary.
+        void enforceMaxSize()
+        {
+            while (_count > _nmax) {
+                long time = oldestTime();
+                if (time < 0) break;  // Only placeholders left.
+                evictOldest(time);
+            }
+        }
 
-        typedef typename std::list<Entry>::iterator ListIter;
-        std::map<Key, ListIter> _cache;
+        const size_t _nmax;
+        std::atomic<size_t> _count;
 
+        struct Entry
+        {
+            Entry(const Key& k, const std::shared_future<shared_ptr<Value> >& f, long i, long t) :
+                key(k), future(f), id(i), time(t), bytes(0) {}
+            Key key;
+            std::shared_future<shared_ptr<Value> > future;
+            shared_ptr<Value> value;  // Set once the value is built.
+            long id;
+            long time;
+            size_t bytes;
+        };
+
+        typedef typename std::list<Entry>::iterator ListIter;
         typedef typename std::map<Key, ListIter>::iterator MapIter;
+
+        struct Shard
+        {
+            Shard() : next_id(0) {}
+            mutable std::mutex mutex;
+            long next_id;
+            std::list<Entry> entries;
+            std::map<Key, ListIter> cache;
+        };
+
+        std::vector<shared_ptr<Shard> > _shards;
     };
 
 }
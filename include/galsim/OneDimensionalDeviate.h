@@ -257,6 +257,10 @@ namespace galsim {
          */
         void shoot(PhotonArray& photons, UniformDeviate ud, bool xandy=false) const;
 
+        /// @brief Estimate the memory used by the sampler, in bytes.
+        size_t getMemorySize() const
+        { return sizeof(*this) + _pt.getMemorySize() - sizeof(_pt); }
+
     private:
 
         const FluxDensity& _fluxDensity; // Function being sampled
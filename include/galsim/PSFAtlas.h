@@ -0,0 +1,104 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2023 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#ifndef GalSim_PSFAtlas_H
+#define GalSim_PSFAtlas_H
+
+/**
+ * @file PSFAtlas.h
+ *
+ * Helper class for the PSFAtlas class in python, which renders stamps of a fixed
+ * pixelized PSF at arbitrary sub-pixel offsets.
+ */
+
+#include <vector>
+#include "Std.h"
+#include "Image.h"
+#include "Interpolant.h"
+
+namespace galsim {
+
+    /**
+     * @brief A pixelized PSF tabulated on an oversampled grid.
+     *
+     * The atlas is built once from an image of the PSF convolved with the pixel response,
+     * drawn (without any further pixel convolution) at a pixel scale `oversample` times finer
+     * than the target images.  The PSF center is taken to be at the given position in the
+     * oversampled image.
+     *
+     * Since the oversampling factor is an integer, every pixel of a stamp drawn at a given
+     * offset shares the same sub-pixel phase relative to the oversampled grid.  So the
+     * interpolation weights only need to be computed once per stamp in each direction, and
+     * each output pixel is then a small separable sum over the atlas values.
+     *
+     * The atlas image should be normalized so that it sums to 1.  Then the stamp values
+     * are scaled by `flux * oversample^2`, so the stamp also sums to `flux` (up to the flux
+     * falling off the edge of the atlas).
+     */
+    class PUBLIC_API PSFAtlas
+    {
+    public:
+        /**
+         * @brief Constructor
+         *
+         * @param[in] image       The oversampled image of the pixelized PSF.
+         * @param[in] oversample  The ratio of the stamp pixel scale to that of `image`.
+         * @param[in] x0          The x position of the PSF center in `image`.
+         * @param[in] y0          The y position of the PSF center in `image`.
+         * @param[in] interp      The interpolant to use between the oversampled pixels.
+         *                        The atlas keeps its own copy of it.
+         */
+        PSFAtlas(const BaseImage<double>& image, int oversample, double x0, double y0,
+                 const Interpolant& interp);
+
+        /**
+         * @brief Draw the PSF onto a stamp.
+         *
+         * The stamp is overwritten (not added to).  Pixels that are entirely off the edge
+         * of the atlas are set to zero.
+         *
+         * @param[in] stamp   The image to draw onto.
+         * @param[in] x0      The x position of the PSF center in the coordinates of `stamp`.
+         * @param[in] y0      The y position of the PSF center in the coordinates of `stamp`.
+         * @param[in] flux    The flux to give the PSF.
+         */
+        template <typename T>
+        void drawStamp(ImageView<T> stamp, double x0, double y0, double flux) const;
+
+        int getOversample() const { return _oversample; }
+
+    private:
+
+        // The interpolation weights for the given sub-pixel phase, for offsets -_n..._n+1.
+        void getWeights(double frac, std::vector<double>& w) const;
+
+        shared_ptr<Interpolant> _interp;
+        int _oversample;
+        int _n;         // Half-width of the interpolant in oversampled pixels (rounded up).
+        int _pad;       // Number of zero pixels around the stored atlas.
+        int _nx;        // Dimensions of the stored (padded) atlas.
+        int _ny;
+        double _x0;     // Position of the PSF center in the stored atlas.
+        double _y0;
+        std::vector<double> _data;
+    };
+
+}
+
+#endif
@@ -196,6 +196,27 @@ namespace galsim {
          */
         void scaleXY(double scale);
 
+        /**
+         * @brief Apply an affine transformation to all photon positions and rescale the fluxes
+         *
+         * The positions are mapped as
+         *
+         *     x -> mA x + mB y + dx
+         *     y -> mC x + mD y + dy
+         *
+         * and the fluxes are multiplied by fluxScale.  If the angles are allocated, dxdz and
+         * dydz are transformed by the same 2x2 matrix (without the offset).
+         *
+         * The common special cases (identity, uniform scaling, diagonal matrix, no offset,
+         * no flux scaling) are detected and use simpler loops.
+         *
+         * @param[in] mA, mB, mC, mD    The elements of the 2x2 matrix [(mA mB), (mC mD)]
+         * @param[in] dx, dy            The offset to add to the positions
+         * @param[in] fluxScale         Scaling factor for all fluxes
+         */
+        void transform(double mA, double mB, double mC, double mD,
+                       double dx, double dy, double fluxScale);
+
         /**
          * @brief Assign the contents of another array to a portion of this one.
          *
@@ -258,11 +279,28 @@ namespace galsim {
          * @param maxFlux   The maximum flux that any photon should have.
          * @param rng       A BaseDeviate in case we need to shuffle.
          *
+         * The array must have room for at least countFrom(image, maxFlux) photons, else
+         * an exception is thrown.
+         *
          * @returns the total number of photons set.
          */
         template <class T>
         int setFrom(const BaseImage<T>& image, double maxFlux, BaseDeviate ud);
 
+        /**
+         * @brief Count the number of photons that setFrom would make from an image.
+         *
+         * This is useful for allocating arrays of exactly the right size before calling
+         * setFrom.
+         *
+         * @param image     The image to use for the photon fluxes and positions.
+         * @param maxFlux   The maximum flux that any photon should have.
+         *
+         * @returns the number of photons setFrom will set for this image and maxFlux.
+         */
+        template <class T>
+        static int countFrom(const BaseImage<T>& image, double maxFlux);
+
         /**
          * @brief Check if the current array has correlated photons.
          */
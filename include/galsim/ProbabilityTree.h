@@ -138,6 +138,18 @@ namespace galsim {
 #endif
         }
 
+        /**
+         * @brief Estimate the memory used by the tree, in bytes.
+         *
+         * This includes the FluxData elements themselves, but not anything they might point to.
+         */
+        size_t getMemorySize() const
+        {
+            return sizeof(*this)
+                + size() * (sizeof(shared_ptr<FluxData>) + sizeof(FluxData) + sizeof(Element))
+                + _shortcut.capacity() * sizeof(const Element*);
+        }
+
     private:
 
         /// @brief A private class that wraps the members in their tree information
@@ -37,6 +37,9 @@ namespace galsim {
 
         double xValue(const Position<double>& p) const;
         std::complex<double> kValue(const Position<double>& k) const;
+        void xValueMany(const double* x, const double* y, double* val, int N) const;
+        void kValueMany(const double* kx, const double* ky, std::complex<double>* val,
+                        int N) const;
 
         double maxK() const { return _maxMaxK; }
         double stepK() const { return _minStepK; }
@@ -83,6 +86,13 @@ namespace galsim {
         { return Position<double>(_sumfx / _sumflux, _sumfy / _sumflux); }
 
         double getFlux() const { return _sumflux; }
+        bool getStructure(ProfileStructure& key) const
+        {
+            key.add("Add").add(_plist.size());
+            for (ConstIter pptr = _plist.begin(); pptr != _plist.end(); ++pptr)
+                if (!pptr->getStructure(key)) return false;
+            return true;
+        }
         double maxSB() const;
 
         /**
@@ -95,6 +105,7 @@ namespace galsim {
          * @param[in] ud UniformDeviate that will be used to draw photons from distribution.
          */
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
+        void prepareShoot() const;
 
         /**
          * @brief Give total positive flux of all summands
@@ -33,7 +33,7 @@ namespace galsim {
      *
      * This is helpful if people use only 1 or a small number of obscuration values.
      */
-    class AiryInfo
+    class AiryInfo : public LRUCacheValue
     {
     public:
         /**
@@ -77,11 +77,15 @@ namespace galsim {
          */
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
 
+        /// @brief Build the `OneDimensionalDeviate` used by shoot() if necessary.
+        virtual void checkSampler() const = 0;
+
+        /// @brief Estimate the memory used by this object, in bytes.
+        size_t getMemorySize() const;
+
     protected:
         double _stepk; ///< Sampling in k space necessary to avoid folding
 
-        virtual void checkSampler() const = 0;
-
         ///< Class that can sample radial distribution
         mutable shared_ptr<OneDimensionalDeviate> _sampler;
 
@@ -210,6 +214,8 @@ namespace galsim {
         double getFlux() const { return _flux; }
         double getLamOverD() const { return _lam_over_D; }
         double getObscuration() const { return _obscuration; }
+        bool getStructure(ProfileStructure& key) const
+        { key.add("Airy").add(_lam_over_D).add(_obscuration).add(_flux); return true; }
         double maxSB() const { return _xnorm * _info->xValue(0.); }
 
         /**
@@ -219,6 +225,7 @@ namespace galsim {
          * @param[in] ud UniformDeviate that will be used to draw photons from distribution.
          */
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
+        void prepareShoot() const { _info->checkSampler(); }
 
         // Overrides for better efficiency
         template <typename T>
@@ -33,6 +33,7 @@ namespace galsim {
 
         double xValue(const Position<double>& p) const;
         std::complex<double> kValue(const Position<double>& k) const;
+        void xValueMany(const double* x, const double* y, double* val, int N) const;
 
         bool isAxisymmetric() const { return false; }
         bool hasHardEdges() const { return true; }
@@ -52,6 +53,8 @@ namespace galsim {
         { return Position<double>(0., 0.); }
 
         double getFlux() const { return _flux; }
+        bool getStructure(ProfileStructure& key) const
+        { key.add("Box").add(_width).add(_height).add(_flux); return true; }
         double maxSB() const { return _norm; }
 
         double getWidth() const { return _width; }
@@ -133,6 +136,7 @@ namespace galsim {
 
         double xValue(const Position<double>& p) const;
         std::complex<double> kValue(const Position<double>& k) const;
+        void xValueMany(const double* x, const double* y, double* val, int N) const;
 
         bool isAxisymmetric() const { return true; }
         bool hasHardEdges() const { return true; }
@@ -159,6 +163,8 @@ namespace galsim {
         { return Position<double>(0., 0.); }
 
         double getFlux() const { return _flux; }
+        bool getStructure(ProfileStructure& key) const
+        { key.add("TopHat").add(_r0).add(_flux); return true; }
         double maxSB() const { return _norm; }
 
         double getRadius() const { return _r0; }
@@ -32,6 +32,15 @@ namespace galsim {
         const SBProfile& p1, const SBProfile& p2, const Position<double>& pos, double flux,
         const GSParams& gsparams);
 
+    // Fill an image with the real-space convolution at x = x0 + i dx + j dxy,
+    // y = y0 + i dyx + j dy.  The parts of the calculation that don't depend on the position
+    // are done once for the whole image, and the pixels are computed in parallel.
+    template <typename T>
+    PUBLIC_API void RealSpaceConvolve(
+        const SBProfile& p1, const SBProfile& p2, ImageView<T> im,
+        double x0, double dx, double dxy, double y0, double dy, double dyx,
+        double flux, const GSParams& gsparams);
+
     /**
      * @brief Convolve SBProfiles.
      *
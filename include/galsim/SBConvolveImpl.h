@@ -43,6 +43,10 @@ namespace galsim {
 
         std::complex<double> kValue(const Position<double>& k) const;
 
+        void xValueMany(const double* x, const double* y, double* val, int N) const;
+        void kValueMany(const double* kx, const double* ky, std::complex<double>* val,
+                        int N) const;
+
         bool isAxisymmetric() const { return _isStillAxisymmetric; }
         bool hasHardEdges() const { return false; }
         bool isAnalyticX() const { return _real_space; }
@@ -99,6 +103,13 @@ namespace galsim {
         { return Position<double>(_x0, _y0); }
 
         double getFlux() const { return _fluxProduct; }
+        bool getStructure(ProfileStructure& key) const
+        {
+            key.add("Convolve").add(_real_space).add(_plist.size());
+            for (ConstIter pptr = _plist.begin(); pptr != _plist.end(); ++pptr)
+                if (!pptr->getStructure(key)) return false;
+            return true;
+        }
         double maxSB() const;
 
         double getPositiveFlux() const;
@@ -113,9 +124,18 @@ namespace galsim {
          * @param[in] ud UniformDeviate that will be used to draw photons from distribution.
          */
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
+        void prepareShoot() const;
 
         // Overrides for better efficiency
         template <typename T>
+        void fillXImage(ImageView<T> im,
+                        double x0, double dx, int izero,
+                        double y0, double dy, int jzero) const;
+        template <typename T>
+        void fillXImage(ImageView<T> im,
+                        double x0, double dx, double dxy,
+                        double y0, double dy, double dyx) const;
+        template <typename T>
         void fillKImage(ImageView<std::complex<T> > im,
                         double kx0, double dkx, int izero,
                         double ky0, double dky, int jzero) const;
@@ -123,6 +143,14 @@ namespace galsim {
         void fillKImage(ImageView<std::complex<T> > im,
                         double kx0, double dkx, double dkxy,
                         double ky0, double dky, double dkyx) const;
+        template <typename T>
+        void multiplyKImage(ImageView<std::complex<T> > im,
+                            double kx0, double dkx, int izero,
+                            double ky0, double dky, int jzero) const;
+        template <typename T>
+        void multiplyKImage(ImageView<std::complex<T> > im,
+                            double kx0, double dkx, double dkxy,
+                            double ky0, double dky, double dkyx) const;
 
     private:
         typedef std::list<SBProfile>::iterator Iter;
@@ -138,6 +166,22 @@ namespace galsim {
         mutable double _maxk; ///< Minimum maxK() of the convolved SBProfiles.
         mutable double _stepk; ///< Minimum stepK() of the convolved SBProfiles.
 
+        void doFillXImage(ImageView<double> im,
+                          double x0, double dx, int izero,
+                          double y0, double dy, int jzero) const
+        { fillXImage(im,x0,dx,izero,y0,dy,jzero); }
+        void doFillXImage(ImageView<double> im,
+                          double x0, double dx, double dxy,
+                          double y0, double dy, double dyx) const
+        { fillXImage(im,x0,dx,dxy,y0,dy,dyx); }
+        void doFillXImage(ImageView<float> im,
+                          double x0, double dx, int izero,
+                          double y0, double dy, int jzero) const
+        { fillXImage(im,x0,dx,izero,y0,dy,jzero); }
+        void doFillXImage(ImageView<float> im,
+                          double x0, double dx, double dxy,
+                          double y0, double dy, double dyx) const
+        { fillXImage(im,x0,dx,dxy,y0,dy,dyx); }
         void doFillKImage(ImageView<std::complex<double> > im,
                           double kx0, double dkx, int izero,
                           double ky0, double dky, int jzero) const
@@ -154,6 +198,22 @@ namespace galsim {
                           double kx0, double dkx, double dkxy,
                           double ky0, double dky, double dkyx) const
         { fillKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx); }
+        void doMultiplyKImage(ImageView<std::complex<double> > im,
+                              double kx0, double dkx, int izero,
+                              double ky0, double dky, int jzero) const
+        { multiplyKImage(im,kx0,dkx,izero,ky0,dky,jzero); }
+        void doMultiplyKImage(ImageView<std::complex<double> > im,
+                              double kx0, double dkx, double dkxy,
+                              double ky0, double dky, double dkyx) const
+        { multiplyKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx); }
+        void doMultiplyKImage(ImageView<std::complex<float> > im,
+                              double kx0, double dkx, int izero,
+                              double ky0, double dky, int jzero) const
+        { multiplyKImage(im,kx0,dkx,izero,ky0,dky,jzero); }
+        void doMultiplyKImage(ImageView<std::complex<float> > im,
+                              double kx0, double dkx, double dkxy,
+                              double ky0, double dky, double dkyx) const
+        { multiplyKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx); }
 
         // Copy constructor and op= are undefined.
         SBConvolveImpl(const SBConvolveImpl& rhs);
@@ -176,6 +236,13 @@ namespace galsim {
         std::complex<double> kValue(const Position<double>& k) const
         { return SQR(_adaptee.kValue(k)); }
 
+        void kValueMany(const double* kx, const double* ky, std::complex<double>* val,
+                        int N) const
+        {
+            _adaptee.kValueMany(kx, ky, val, N);
+            for (int i=0; i<N; ++i) val[i] = SQR(val[i]);
+        }
+
         bool isAxisymmetric() const { return _adaptee.isAxisymmetric(); }
         bool hasHardEdges() const { return false; }
         bool isAnalyticX() const { return _real_space; }
@@ -186,15 +253,29 @@ namespace galsim {
         Position<double> centroid() const { return _adaptee.centroid() * 2.; }
 
         double getFlux() const { return SQR(_adaptee.getFlux()); }
+        bool getStructure(ProfileStructure& key) const
+        {
+            key.add("AutoConvolve").add(_real_space);
+            return _adaptee.getStructure(key);
+        }
         double maxSB() const;
 
         double getPositiveFlux() const;
         double getNegativeFlux() const;
 
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
+        void prepareShoot() const { GetImpl(_adaptee)->prepareShoot(); }
 
         // Overrides for better efficiency
         template <typename T>
+        void fillXImage(ImageView<T> im,
+                        double x0, double dx, int izero,
+                        double y0, double dy, int jzero) const;
+        template <typename T>
+        void fillXImage(ImageView<T> im,
+                        double x0, double dx, double dxy,
+                        double y0, double dy, double dyx) const;
+        template <typename T>
         void fillKImage(ImageView<std::complex<T> > im,
                         double kx0, double dkx, int izero,
                         double ky0, double dky, int jzero) const;
@@ -214,6 +295,22 @@ namespace galsim {
         template <typename T>
         static T SQR(T x) { return x*x; }
 
+        void doFillXImage(ImageView<double> im,
+                          double x0, double dx, int izero,
+                          double y0, double dy, int jzero) const
+        { fillXImage(im,x0,dx,izero,y0,dy,jzero); }
+        void doFillXImage(ImageView<double> im,
+                          double x0, double dx, double dxy,
+                          double y0, double dy, double dyx) const
+        { fillXImage(im,x0,dx,dxy,y0,dy,dyx); }
+        void doFillXImage(ImageView<float> im,
+                          double x0, double dx, int izero,
+                          double y0, double dy, int jzero) const
+        { fillXImage(im,x0,dx,izero,y0,dy,jzero); }
+        void doFillXImage(ImageView<float> im,
+                          double x0, double dx, double dxy,
+                          double y0, double dy, double dyx) const
+        { fillXImage(im,x0,dx,dxy,y0,dy,dyx); }
         void doFillKImage(ImageView<std::complex<double> > im,
                           double kx0, double dkx, int izero,
                           double ky0, double dky, int jzero) const
@@ -252,6 +349,13 @@ namespace galsim {
         std::complex<double> kValue(const Position<double>& k) const
         { return NORM(_adaptee.kValue(k)); }
 
+        void kValueMany(const double* kx, const double* ky, std::complex<double>* val,
+                        int N) const
+        {
+            _adaptee.kValueMany(kx, ky, val, N);
+            for (int i=0; i<N; ++i) val[i] = NORM(val[i]);
+        }
+
         bool isAxisymmetric() const { return _adaptee.isAxisymmetric(); }
         bool hasHardEdges() const { return false; }
         bool isAnalyticX() const { return _real_space; }
@@ -262,15 +366,29 @@ namespace galsim {
         Position<double> centroid() const { return Position<double>(0., 0.); }
 
         double getFlux() const { return SQR(_adaptee.getFlux()); }
+        bool getStructure(ProfileStructure& key) const
+        {
+            key.add("AutoCorrelate").add(_real_space);
+            return _adaptee.getStructure(key);
+        }
         double maxSB() const;
 
         double getPositiveFlux() const;
         double getNegativeFlux() const;
 
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
+        void prepareShoot() const { GetImpl(_adaptee)->prepareShoot(); }
 
         // Overrides for better efficiency
         template <typename T>
+        void fillXImage(ImageView<T> im,
+                        double x0, double dx, int izero,
+                        double y0, double dy, int jzero) const;
+        template <typename T>
+        void fillXImage(ImageView<T> im,
+                        double x0, double dx, double dxy,
+                        double y0, double dy, double dyx) const;
+        template <typename T>
         void fillKImage(ImageView<std::complex<T> > im,
                         double kx0, double dkx, int izero,
                         double ky0, double dky, int jzero) const;
@@ -292,6 +410,22 @@ namespace galsim {
         template <typename T>
         static T NORM(std::complex<T> x) { return std::norm(x); }
 
+        void doFillXImage(ImageView<double> im,
+                          double x0, double dx, int izero,
+                          double y0, double dy, int jzero) const
+        { fillXImage(im,x0,dx,izero,y0,dy,jzero); }
+        void doFillXImage(ImageView<double> im,
+                          double x0, double dx, double dxy,
+                          double y0, double dy, double dyx) const
+        { fillXImage(im,x0,dx,dxy,y0,dy,dyx); }
+        void doFillXImage(ImageView<float> im,
+                          double x0, double dx, int izero,
+                          double y0, double dy, int jzero) const
+        { fillXImage(im,x0,dx,izero,y0,dy,jzero); }
+        void doFillXImage(ImageView<float> im,
+                          double x0, double dx, double dxy,
+                          double y0, double dy, double dyx) const
+        { fillXImage(im,x0,dx,dxy,y0,dy,dyx); }
         void doFillKImage(ImageView<std::complex<double> > im,
                           double kx0, double dkx, int izero,
                           double ky0, double dky, int jzero) const
@@ -50,6 +50,8 @@ namespace galsim {
         Position<double> centroid() const { return Position<double>(0., 0.); }
 
         double getFlux() const { return _flux; }
+        bool getStructure(ProfileStructure& key) const
+        { key.add("DeltaFunction").add(_flux); return true; }
         double maxSB() const { return MOCK_INF; }
 
         /**
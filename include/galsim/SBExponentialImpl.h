@@ -70,6 +70,9 @@ namespace galsim {
          */
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
 
+        /// @brief Estimate the memory used by this object, in bytes.
+        size_t getMemorySize() const;
+
         double maxK() const;
         double stepK() const;
 
@@ -98,6 +101,9 @@ namespace galsim {
 
         double xValue(const Position<double>& p) const;
         std::complex<double> kValue(const Position<double>& k) const;
+        void xValueMany(const double* x, const double* y, double* val, int N) const;
+        void kValueMany(const double* kx, const double* ky, std::complex<double>* val,
+                        int N) const;
 
         void getXRange(double& xmin, double& xmax, std::vector<double>& splits) const
         { xmin = -integ::MOCK_INF; xmax = integ::MOCK_INF; splits.push_back(0.); }
@@ -124,6 +130,8 @@ namespace galsim {
 
         double getFlux() const { return _flux; }
         double getScaleRadius() const { return _r0; }
+        bool getStructure(ProfileStructure& key) const
+        { key.add("Exponential").add(_r0).add(_flux); return true; }
         double maxSB() const { return _norm; }
 
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
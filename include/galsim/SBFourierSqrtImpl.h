@@ -37,6 +37,8 @@ namespace galsim {
         SBProfile getObj() const { return _adaptee; }
 
         std::complex<double> kValue(const Position<double>& k) const;
+        void kValueMany(const double* kx, const double* ky, std::complex<double>* val,
+                        int N) const;
 
         double maxK() const { return _adaptee.maxK(); }
         double stepK() const { return _adaptee.stepK() * sqrt(2.); }
@@ -52,6 +54,11 @@ namespace galsim {
 
         Position<double> centroid() const;
         double getFlux() const;
+        bool getStructure(ProfileStructure& key) const
+        {
+            key.add("FourierSqrt");
+            return _adaptee.getStructure(key);
+        }
         double maxSB() const;
 
         // shoot also not implemented.
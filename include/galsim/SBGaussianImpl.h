@@ -34,6 +34,9 @@ namespace galsim {
 
         double xValue(const Position<double>& p) const;
         std::complex<double> kValue(const Position<double>& k) const;
+        void xValueMany(const double* x, const double* y, double* val, int N) const;
+        void kValueMany(const double* kx, const double* ky, std::complex<double>* val,
+                        int N) const;
 
         bool isAxisymmetric() const { return true; }
         bool hasHardEdges() const { return false; }
@@ -47,6 +50,8 @@ namespace galsim {
         { return Position<double>(0., 0.); }
 
         double getFlux() const { return _flux; }
+        bool getStructure(ProfileStructure& key) const
+        { key.add("Gaussian").add(_sigma).add(_flux); return true; }
         double maxSB() const { return _norm; }
 
         /**
@@ -69,6 +69,8 @@ namespace galsim {
         double getFlux() const { return _flux; }
 
         /// @brief Maximum surface brightness
+        bool getStructure(ProfileStructure& key) const
+        { key.add("InclinedExponential").add(_inclination).add(_r0).add(_h0).add(_flux); return true; }
         double maxSB() const;
 
         /// @brief photon shooting is not implemented yet.
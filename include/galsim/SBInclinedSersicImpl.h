@@ -56,6 +56,12 @@ namespace galsim {
         double getFlux() const { return _flux; }
 
         /// @brief Maximum surface brightness
+        bool getStructure(ProfileStructure& key) const
+        {
+            key.add("InclinedSersic").add(_n).add(_inclination).add(_r0).add(_h0);
+            key.add(_flux).add(_trunc).add(_info->isInterpolated());
+            return true;
+        }
         double maxSB() const;
 
         /// @brief photon shooting is not yet implemented
@@ -22,7 +22,7 @@
 
 #include "SBProfileImpl.h"
 #include "SBInterpolatedImage.h"
-#include "ProbabilityTree.h"
+#include "AliasTable.h"
 
 namespace galsim {
 
@@ -98,6 +98,7 @@ namespace galsim {
          * @param[in] ud UniformDeviate that will be used to draw photons from distribution.
          */
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
+        void prepareShoot() const { checkReadyToShoot(); _xInterp.prepareShoot(); }
 
         void getXRange(double& xmin, double& xmax, std::vector<double>& ) const;
         void getYRange(double& ymin, double& ymax, std::vector<double>& ) const;
@@ -159,13 +160,15 @@ namespace galsim {
             bool isPositive;
             double flux;
 
+            Pixel() {}
             Pixel(double x_, double y_, double flux_):
                 x(x_), y(y_), flux(flux_) { isPositive = flux>=0.; }
             double getFlux() const { return flux; }
         };
         mutable double _positiveFlux;    ///< Sum of all positive pixels' flux
         mutable double _negativeFlux;    ///< Sum of all negative pixels' flux
-        mutable ProbabilityTree<Pixel> _pt; ///< Binary tree of pixels, for photon-shooting
+        mutable std::vector<Pixel> _pixels; ///< The non-zero pixels, for photon-shooting
+        mutable AliasTable _alias;       ///< Alias table over _pixels, for photon-shooting
 
     private:
 
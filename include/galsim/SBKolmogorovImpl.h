@@ -77,6 +77,9 @@ namespace galsim {
          */
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
 
+        /// @brief Estimate the memory used by this object, in bytes.
+        size_t getMemorySize() const;
+
     private:
         KolmogorovInfo(const KolmogorovInfo& rhs); ///< Hides the copy constructor.
         void operator=(const KolmogorovInfo& rhs); ///<Hide assignment operator.
@@ -113,6 +116,8 @@ namespace galsim {
 
         double getFlux() const { return _flux; }
         double getLamOverR0() const { return _lam_over_r0; }
+        bool getStructure(ProfileStructure& key) const
+        { key.add("Kolmogorov").add(_lam_over_r0).add(_flux); return true; }
         double maxSB() const;
 
         /**
@@ -65,6 +65,8 @@ namespace galsim {
 
 
         double getFlux() const { return _flux; }
+        bool getStructure(ProfileStructure& key) const
+        { key.add("Moffat").add(_beta).add(_rD).add(_trunc).add(_flux); return true; }
         double maxSB() const { return _norm; }
 
         /**
@@ -33,6 +33,7 @@
 #include <vector>
 #include <algorithm>
 #include <complex>
+#include <functional>
 
 #include "Std.h"
 #include "Random.h"
@@ -56,6 +57,55 @@ namespace galsim {
 
     class PUBLIC_API SBTransform;
 
+    /**
+     * @brief A description of the structure of a profile, used as a key for caching its images.
+     *
+     * Each component of a profile adds its name, its GSParams and its parameters.  Components
+     * that contain other profiles add those too, so two profiles with equal structures are
+     * built the same way and draw identical images.  Values are stored as their exact bytes, so
+     * there is no rounding.
+     */
+    class PUBLIC_API ProfileStructure
+    {
+    public:
+        ProfileStructure() {}
+
+        /// @brief Add the name of a kind of profile.
+        ProfileStructure& add(const char* name);
+
+        /// @brief Add a parameter.
+        ProfileStructure& add(double x);
+
+        /// @brief Add all the values in a GSParams.
+        ProfileStructure& add(const GSParams& gsparams);
+
+        const std::string& str() const { return _key; }
+        size_t hash() const { return std::hash<std::string>()(_key); }
+
+        bool operator<(const ProfileStructure& rhs) const { return _key < rhs._key; }
+        bool operator==(const ProfileStructure& rhs) const { return _key == rhs._key; }
+
+    private:
+        std::string _key;
+    };
+
+    /**
+     * @brief Set whether SBProfile::draw and drawK save the images they draw.
+     *
+     * When this is turned on, images are saved in an LRUCache keyed on the structure of the
+     * profile (see ProfileStructure) and all of the arguments to draw or drawK.  Drawing a
+     * profile with the same structure on the same bounds again just copies the saved image.
+     * Profiles that can't describe their structure, such as interpolated images, are always
+     * drawn directly.
+     */
+    PUBLIC_API void SetDrawCache(bool use);
+    PUBLIC_API bool GetDrawCache();
+
+    namespace sbp {
+        // How many drawn images (of each pixel type) to save in the cache
+        const int max_draw_cache = 100;
+    }
+
     /**
      * @brief A base class representing all of the 2D surface brightness profiles that we know how
      * to draw.
@@ -153,6 +203,33 @@ namespace galsim {
          */
         std::complex<double> kValue(const Position<double>& k) const;
 
+        /**
+         * @brief Return values of SBProfile at many 2D positions in real space.
+         *
+         * This is equivalent to calling xValue() at each position (x[i], y[i]), but it avoids
+         * the per-point overhead.  Composite profiles pass the whole arrays on to their
+         * components, and some profiles vectorize the calculation.
+         *
+         * @param[in] x     The x values of the positions.
+         * @param[in] y     The y values of the positions.
+         * @param[out] val  The output values.
+         * @param[in] N     The number of positions.
+         */
+        void xValueMany(const double* x, const double* y, double* val, int N) const;
+
+        /**
+         * @brief Return values of SBProfile at many 2D positions in k space.
+         *
+         * This is equivalent to calling kValue() at each position (kx[i], ky[i]).
+         *
+         * @param[in] kx    The kx values of the positions.
+         * @param[in] ky    The ky values of the positions.
+         * @param[out] val  The output values.
+         * @param[in] N     The number of positions.
+         */
+        void kValueMany(const double* kx, const double* ky, std::complex<double>* val,
+                        int N) const;
+
         //@{
         /**
          *  @brief Define the range over which the profile is not trivially zero.
@@ -231,6 +308,14 @@ namespace galsim {
         /// @brief Get an estimate of the maximum surface brightness.
         double maxSB() const;
 
+        /**
+         * @brief Add the structure of this profile to key.
+         *
+         * @returns false if the profile can't be described this way (e.g. if it holds an
+         *          image), in which case its images are never cached.
+         */
+        bool getStructure(ProfileStructure& key) const;
+
         // ****Methods implemented in base class****
 
         // Transformations (all are special cases of affine transformations via SBTransform):
@@ -366,6 +451,13 @@ namespace galsim {
 
         class SBProfileImpl;
 
+        // The versions of draw and drawK that don't use the cache.
+        template <typename T>
+        void plainDraw(ImageView<T> image, double dx, double* jac,
+                       double xoff, double yoff, double flux_ratio) const;
+        template <typename T>
+        void plainDrawK(ImageView<std::complex<T> > image, double dk, double* jac) const;
+
         // Regular constructor only available to derived classes
         SBProfile(SBProfileImpl* pimpl);
 
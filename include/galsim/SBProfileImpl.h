@@ -39,6 +39,14 @@ namespace galsim {
         virtual double xValue(const Position<double>& p) const =0;
         virtual std::complex<double> kValue(const Position<double>& k) const =0;
 
+        // Calculate xValues and kValues at N arbitrary positions.
+        // The default implementations just call xValue or kValue for each position.
+        // Composite profiles override these to pass the arrays on to their components, and
+        // leaf profiles may override them to vectorize the calculation.
+        virtual void xValueMany(const double* x, const double* y, double* val, int N) const;
+        virtual void kValueMany(const double* kx, const double* ky, std::complex<double>* val,
+                                int N) const;
+
         // Calculate xValues and kValues for a bunch of positions at once.
         // For some profiles, this may be more efficient than repeated calls of xValue(pos)
         // since it affords the opportunity for vectorization of the calculations.
@@ -79,6 +87,23 @@ namespace galsim {
                         double ky0, double dky, double dkyx) const
         { doFillKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx); }
 
+        // Multiply the k-space values of this profile into an existing image, rather than
+        // overwriting it.  SBConvolve uses this to combine its components without needing
+        // a full-sized scratch image for each one.  The default implementation fills a
+        // small temporary image and multiplies it in: a single quadrant for axisymmetric
+        // profiles when izero or jzero is given, otherwise a few rows at a time.
+        // Profiles that can do this without any temporary override doMultiplyKImage.
+        template <typename T>
+        void multiplyKImage(ImageView<std::complex<T> > im,
+                            double kx0, double dkx, int izero,
+                            double ky0, double dky, int jzero) const
+        { doMultiplyKImage(im,kx0,dkx,izero,ky0,dky,jzero); }
+        template <typename T>
+        void multiplyKImage(ImageView<std::complex<T> > im,
+                            double kx0, double dkx, double dkxy,
+                            double ky0, double dky, double dkyx) const
+        { doMultiplyKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx); }
+
         template <typename T>
         void defaultFillXImage(ImageView<T> im,
                                double x0, double dx, int izero,
@@ -95,6 +120,14 @@ namespace galsim {
         void defaultFillKImage(ImageView<std::complex<T> > im,
                                double kx0, double dkx, double dkxy,
                                double ky0, double dky, double dkyx) const;
+        template <typename T>
+        void defaultMultiplyKImage(ImageView<std::complex<T> > im,
+                                   double kx0, double dkx, int izero,
+                                   double ky0, double dky, int jzero) const;
+        template <typename T>
+        void defaultMultiplyKImage(ImageView<std::complex<T> > im,
+                                   double kx0, double dkx, double dkxy,
+                                   double ky0, double dky, double dkyx) const;
 
         virtual double maxK() const =0;
         virtual double stepK() const =0;
@@ -108,6 +141,10 @@ namespace galsim {
         virtual void shoot(PhotonArray& photons, UniformDeviate ud) const=0;
 
         // Functions with default implementations:
+
+        // Build any state that shoot() constructs lazily.  SBAdd and SBConvolve call this
+        // for each component before shooting them concurrently, so shoot() doesn't need locks.
+        virtual void prepareShoot() const {}
         virtual void getXRange(double& xmin, double& xmax, std::vector<double>& /*splits*/) const
         { xmin = -integ::MOCK_INF; xmax = integ::MOCK_INF; }
 
@@ -122,6 +159,10 @@ namespace galsim {
 
         virtual double getNegativeFlux() const { return getFlux()>0. ? 0. : -getFlux(); }
 
+        // Add the name and parameters of this profile to key.  (SBProfile::getStructure adds
+        // the GSParams.)  Return false if the profile can't be described this way.
+        virtual bool getStructure(ProfileStructure& /*key*/) const { return false; }
+
         // Public so it can be directly used from SBProfile.
         GSParams gsparams;
 
@@ -176,6 +217,24 @@ namespace galsim {
                                   double ky0, double dky, double dkyx) const
         { defaultFillKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx); }
 
+        // Likewise for multiplyKImage.
+        virtual void doMultiplyKImage(ImageView<std::complex<double> > im,
+                                      double kx0, double dkx, int izero,
+                                      double ky0, double dky, int jzero) const
+        { defaultMultiplyKImage(im,kx0,dkx,izero,ky0,dky,jzero); }
+        virtual void doMultiplyKImage(ImageView<std::complex<double> > im,
+                                      double kx0, double dkx, double dkxy,
+                                      double ky0, double dky, double dkyx) const
+        { defaultMultiplyKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx); }
+        virtual void doMultiplyKImage(ImageView<std::complex<float> > im,
+                                      double kx0, double dkx, int izero,
+                                      double ky0, double dky, int jzero) const
+        { defaultMultiplyKImage(im,kx0,dkx,izero,ky0,dky,jzero); }
+        virtual void doMultiplyKImage(ImageView<std::complex<float> > im,
+                                      double kx0, double dkx, double dkxy,
+                                      double ky0, double dky, double dkyx) const
+        { defaultMultiplyKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx); }
+
     private:
         // Copy constructor and op= are undefined.
         SBProfileImpl(const SBProfileImpl& rhs);
@@ -27,9 +27,22 @@
 
 namespace galsim {
 
+    /**
+     * @brief Set whether SBSecondKick interpolates its tables on a grid in kcrit.
+     *
+     * Normally each new value of kcrit requires new tables.  When this is turned on, the tables
+     * are only built at grid values of log(kcrit), and each profile interpolates linearly
+     * between the two nearest ones.  The interpolated kValues are accurate to about 1.e-5.
+     */
+    PUBLIC_API void SetSecondKickInterpolated(bool interpolated);
+    PUBLIC_API bool GetSecondKickInterpolated();
+
     namespace sbp {
         // How many SecondKick profiles to save in the cache
         const int max_SK_cache = 100;
+
+        // The spacing in log(kcrit) of the grid used by SetSecondKickInterpolated.
+        const double SK_grid_dlogkcrit = 0.01;
     }
 
     class PUBLIC_API SBSecondKick : public SBProfile
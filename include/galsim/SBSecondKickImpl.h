@@ -55,6 +55,9 @@ namespace galsim {
         double structureFunction(double rho) const;
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
 
+        /// @brief Estimate the memory used by this object, in bytes.
+        size_t getMemorySize() const;
+
     private:
         SKInfo(const SKInfo& rhs); ///<Hide the copy constructor
         void operator=(const SKInfo& rhs); ///<Hide the assignment operator
@@ -103,7 +106,18 @@ namespace galsim {
         double getFlux() const { return _flux-getDelta(); }
         double getLamOverR0() const { return _lam_over_r0; }
         double getKCrit() const { return _kcrit; }
-        double maxSB() const { return _flux * _info->xValue(0.); }
+        bool getStructure(ProfileStructure& key) const
+        {
+            key.add("SecondKick").add(_lam_over_r0).add(_kcrit).add(_flux);
+            key.add(_interpolated).add(_w);
+            return true;
+        }
+        double maxSB() const
+        {
+            double val = _info->xValue(0.);
+            if (_info2) val = (1.-_w) * val + _w * _info2->xValue(0.);
+            return _flux * val;
+        }
 
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
 
@@ -125,8 +139,11 @@ namespace galsim {
         double _kcrit;
         double _flux;
         double _xnorm;
+        bool _interpolated;  // Whether the infos are on the grid in kcrit.
+        double _w;  // Weight of _info2, when interpolating.
 
         shared_ptr<SKInfo> _info;
+        shared_ptr<SKInfo> _info2;  // Only set when interpolating in kcrit.
 
         // Copy constructor and op= are undefined.
         SBSecondKickImpl(const SBSecondKickImpl& rhs);
@@ -31,6 +31,18 @@ namespace galsim {
     PUBLIC_API double SersicIntegratedFlux(double n, double r);
     PUBLIC_API double SersicTruncatedScale(double n, double hlr, double trunc);
 
+    /**
+     * @brief Set whether untruncated Sersic profiles interpolate their Fourier transform.
+     *
+     * Normally each new value of n requires a new table of the Hankel transform, which is slow
+     * when every profile has a different n.  When this is turned on, the transform is
+     * interpolated from a grid in (n, log k) that is built once for each GSParams.  This
+     * changes the values by up to about 10 kvalue_accuracy, mostly for n < 2 at the smallest
+     * k that use the table.  Truncated profiles always calculate their own transform.
+     */
+    PUBLIC_API void SetSersicInterpolatedFT(bool interpolated);
+    PUBLIC_API bool GetSersicInterpolatedFT();
+
     namespace sbp {
 
         // Constrain range of allowed Sersic index n to those for which testing was done
@@ -42,6 +54,11 @@ namespace galsim {
         // How many Sersic profiles to save in the cache
         const int max_sersic_cache = 100;
 
+        // The spacing in n of the grid used by SetSersicInterpolatedFT, and how many grids
+        // (one per GSParams) to save in the cache.
+        const double sersic_grid_dn = 0.05;
+        const int max_sersic_grid_cache = 4;
+
     }
 
     /**
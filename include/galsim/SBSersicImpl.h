@@ -29,12 +29,63 @@
 
 namespace galsim {
 
-    /// @brief A private class that caches the needed parameters for each Sersic index `n`.
-    class SersicInfo
+    /**
+     * @brief A private class holding the Fourier transform of untruncated Sersic profiles
+     * tabulated on a grid in (n, log(k re)).
+     *
+     * The grid nodes are ordinary SersicInfo tables at regularly spaced values of n.  Their
+     * transforms are resampled onto a common grid in log(k re), where re is the half-light
+     * radius, so the values change slowly with n at fixed position in the grid.  Then the
+     * transform for any other n is found by bicubic interpolation with a Table2D.
+     *
+     * Building the grid is much slower than building a single SersicInfo table, but it only
+     * needs to be done once for each GSParams.  After that, setting up a new value of n is
+     * just a series of lookups.
+     */
+    class SersicFTGrid
     {
     public:
         /// @brief Constructor
-        SersicInfo(double n, double trunc, const GSParamsPtr& gsparams);
+        SersicFTGrid(const GSParamsPtr& gsparams);
+
+        /**
+         * @brief Returns the unnormalized value of the fourier transform.
+         *
+         * The input `logkre` is log(k_actual * re_actual).  Values below the range of the
+         * grid get the value at the lower edge.  Values above it use the 1/k^2 asymptote.
+         */
+        double kValue(double n, double logkre) const;
+
+        /// @brief Estimate the memory used by this object, in bytes.
+        size_t getMemorySize() const;
+
+        static LRUCache<GSParamsPtr, SersicFTGrid> cache;
+
+    private:
+
+        SersicFTGrid(const SersicFTGrid& rhs); ///< Hide the copy constructor.
+        void operator=(const SersicFTGrid& rhs); ///<Hide assignment operator.
+
+        std::vector<double> _nargs;    ///< The values of n at the grid nodes.
+        std::vector<double> _uargs;    ///< The values of log(k re) at the grid nodes.
+        std::vector<double> _vals;     ///< F(n,u) with n varying fastest.
+        std::vector<double> _dfdn;     ///< dF/dn
+        std::vector<double> _dfdu;     ///< dF/du
+        std::vector<double> _d2fdndu;  ///< d2F/dndu
+        shared_ptr<Table2D> _table;    ///< The interpolating table, pointing at the above.
+    };
+
+    /// @brief A private class that caches the needed parameters for each Sersic index `n`.
+    class SersicInfo : public LRUCacheValue
+    {
+    public:
+        /**
+         * @brief Constructor
+         *
+         * If `interpolated` is true and the profile is not truncated, the Fourier transform
+         * is taken from the SersicFTGrid for these GSParams, rather than calculated directly.
+         */
+        SersicInfo(double n, double trunc, const GSParamsPtr& gsparams, bool interpolated);
 
         /// @brief Destructor: deletes photon-shooting classes if necessary
         ~SersicInfo() {}
@@ -64,6 +115,9 @@ namespace galsim {
         /// @brief The fractional flux relative to the untruncated profile.
         double getFluxFraction() const;
 
+        /// @brief Whether the Fourier transform comes from SersicFTGrid.
+        bool isInterpolated() const { return _interpolated; }
+
         /**
          * @brief The factor by which to multiply the returned value from xValue.
          *
@@ -85,6 +139,12 @@ namespace galsim {
          */
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
 
+        /// @brief Build the `OneDimensionalDeviate` used by shoot() if necessary.
+        void checkSampler() const;
+
+        /// @brief Estimate the memory used by this object, in bytes.
+        size_t getMemorySize() const;
+
     private:
 
         SersicInfo(const SersicInfo& rhs); ///< Hide the copy constructor.
@@ -100,6 +160,7 @@ namespace galsim {
         double _inv2n;     ///< 1/(2n)
         double _trunc_sq;  ///< trunc^2
         bool _truncated;   ///< True if this Sersic profile is truncated.
+        bool _interpolated; ///< True if the Fourier transform comes from SersicFTGrid.
         double _gamma2n;   ///< Gamma(2n) = 1/n * int(exp(-r^1/n)*r,r=0..inf)
 
         // Parameters calculated when they are first needed, and then stored:
@@ -126,6 +187,8 @@ namespace galsim {
         void buildFT() const;
         void calculateHLR() const;
         double calculateMissingFluxRadius(double missing_flux_frac) const;
+
+        friend class SersicFTGrid;
     };
 
     class SBSersic::SBSersicImpl : public SBProfileImpl
@@ -175,10 +238,17 @@ namespace galsim {
 
         /// @brief Returns the true flux (may be different from the specified flux)
         double getFlux() const { return _flux; }
+        bool getStructure(ProfileStructure& key) const
+        {
+            key.add("Sersic").add(_n).add(_r0).add(_flux).add(_trunc);
+            key.add(_info->isInterpolated());
+            return true;
+        }
         double maxSB() const { return _xnorm; }
 
         /// @brief Sersic photon shooting done by rescaling photons from appropriate `SersicInfo`
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
+        void prepareShoot() const { _info->checkSampler(); }
 
         /// @brief Returns the Sersic index n
         double getN() const { return _n; }
@@ -261,7 +331,7 @@ namespace galsim {
         SBSersicImpl(const SBSersicImpl& rhs);
         void operator=(const SBSersicImpl& rhs);
 
-        static LRUCache<Tuple<double, double, GSParamsPtr>, SersicInfo> cache;
+        static LRUCache<Tuple<double, double, GSParamsPtr, bool>, SersicInfo> cache;
 
         friend class SBInclinedSersic;
         friend class SBInclinedSersic::SBInclinedSersicImpl;
@@ -49,6 +49,12 @@ namespace galsim {
         double getSigma() const;
         const LVector& getBVec() const;
         LVector& getBVec();
+        bool getStructure(ProfileStructure& key) const
+        {
+            key.add("Shapelet").add(_sigma).add(_bvec.getOrder());
+            for (int i=0; i<_bvec.size(); ++i) key.add(_bvec[i]);
+            return true;
+        }
         double maxSB() const;
 
         /// @brief Photon-shooting is not implemented for SBShapelet, will throw an exception.
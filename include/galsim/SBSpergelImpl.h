@@ -28,7 +28,7 @@
 namespace galsim {
 
     /// @brief A private class that caches the needed parameters for each Spergel index `nu`.
-    class SpergelInfo
+    class SpergelInfo : public LRUCacheValue
     {
     public:
         /// @brief Constructor
@@ -77,6 +77,12 @@ namespace galsim {
          */
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
 
+        /// @brief Build the `OneDimensionalDeviate` used by shoot() if necessary.
+        void checkSampler() const;
+
+        /// @brief Estimate the memory used by this object, in bytes.
+        size_t getMemorySize() const;
+
         double calculateIntegratedFlux(double r) const;
         double calculateFluxRadius(double f) const;
 
@@ -149,10 +155,13 @@ namespace galsim {
         { return Position<double>(0., 0.); }
 
         double getFlux() const { return _flux; }
+        bool getStructure(ProfileStructure& key) const
+        { key.add("Spergel").add(_nu).add(_r0).add(_flux); return true; }
         double maxSB() const { return std::abs(_xnorm) * _info->xValue(0.); }
 
         /// @brief Spergel photon shooting done by rescaling photons from appropriate `SpergelInfo`
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
+        void prepareShoot() const { _info->checkSampler(); }
 
         /// @brief Returns the Spergel index nu
         double getNu() const { return _nu; }
@@ -36,6 +36,9 @@ namespace galsim {
 
         double xValue(const Position<double>& p) const;
         std::complex<double> kValue(const Position<double>& k) const;
+        void xValueMany(const double* x, const double* y, double* val, int N) const;
+        void kValueMany(const double* kx, const double* ky, std::complex<double>* val,
+                        int N) const;
 
         bool isAxisymmetric() const {
             return _adaptee.isAxisymmetric()
@@ -58,6 +61,12 @@ namespace galsim {
         Position<double> centroid() const { return _cen + fwd(_adaptee.centroid()); }
 
         double getFlux() const { return _adaptee.getFlux() * _fluxScaling; }
+        bool getStructure(ProfileStructure& key) const
+        {
+            key.add("Transform").add(_mA).add(_mB).add(_mC).add(_mD);
+            key.add(_cen.x).add(_cen.y).add(_ampScaling);
+            return _adaptee.getStructure(key);
+        }
         double maxSB() const { return _adaptee.maxSB() * _ampScaling; }
 
         double getPositiveFlux() const { return _adaptee.getPositiveFlux() * _fluxScaling; }
@@ -74,6 +83,7 @@ namespace galsim {
          * @param[in] ud UniformDeviate that will be used to draw photons from distribution.
          */
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
+        void prepareShoot() const { GetImpl(_adaptee)->prepareShoot(); }
 
         SBProfile getObj() const { return _adaptee; }
         void getJac(double& mA, double& mB, double& mC, double& mD) const
@@ -98,6 +108,14 @@ namespace galsim {
         void fillKImage(ImageView<std::complex<T> > im,
                         double kx0, double dkx, double dkxy,
                         double ky0, double dky, double dkyx) const;
+        template <typename T>
+        void multiplyKImage(ImageView<std::complex<T> > im,
+                            double kx0, double dkx, int izero,
+                            double ky0, double dky, int jzero) const;
+        template <typename T>
+        void multiplyKImage(ImageView<std::complex<T> > im,
+                            double kx0, double dkx, double dkxy,
+                            double ky0, double dky, double dkyx) const;
 
     private:
         SBProfile _adaptee; ///< SBProfile being adapted/transformed
@@ -208,6 +226,32 @@ namespace galsim {
                           double kx0, double dkx, double dkxy,
                           double ky0, double dky, double dkyx) const
         { fillKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx); }
+        void doMultiplyKImage(ImageView<std::complex<double> > im,
+                              double kx0, double dkx, int izero,
+                              double ky0, double dky, int jzero) const
+        { multiplyKImage(im,kx0,dkx,izero,ky0,dky,jzero); }
+        void doMultiplyKImage(ImageView<std::complex<double> > im,
+                              double kx0, double dkx, double dkxy,
+                              double ky0, double dky, double dkyx) const
+        { multiplyKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx); }
+        void doMultiplyKImage(ImageView<std::complex<float> > im,
+                              double kx0, double dkx, int izero,
+                              double ky0, double dky, int jzero) const
+        { multiplyKImage(im,kx0,dkx,izero,ky0,dky,jzero); }
+        void doMultiplyKImage(ImageView<std::complex<float> > im,
+                              double kx0, double dkx, double dkxy,
+                              double ky0, double dky, double dkyx) const
+        { multiplyKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx); }
+
+        // The shared implementation of fillKImage and multiplyKImage.
+        template <typename T>
+        void fillOrMultiplyKImage(ImageView<std::complex<T> > im,
+                                  double kx0, double dkx, int izero,
+                                  double ky0, double dky, int jzero, bool multiply) const;
+        template <typename T>
+        void fillOrMultiplyKImage(ImageView<std::complex<T> > im,
+                                  double kx0, double dkx, double dkxy,
+                                  double ky0, double dky, double dkyx, bool multiply) const;
 
         // Copy constructor and op= are undefined.
         SBTransformImpl(const SBTransformImpl& rhs);
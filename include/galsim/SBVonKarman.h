@@ -27,9 +27,27 @@
 
 namespace galsim {
 
+    /**
+     * @brief Set whether SBVonKarman interpolates its tables on a grid in L0/r0.
+     *
+     * Normally each new combination of lam/r0 and L0/r0 requires new tables, so a PSF whose
+     * parameters vary across the field almost never hits the cache.  When this is turned on,
+     * the tables are only built at a reference lam/r0, which just sets the size of the profile,
+     * and at grid values of log(L0/r0).  Each profile then rescales the two nearest tables and
+     * interpolates linearly between them.  The interpolated kValues are accurate to about
+     * 1.e-5.
+     */
+    PUBLIC_API void SetVonKarmanInterpolated(bool interpolated);
+    PUBLIC_API bool GetVonKarmanInterpolated();
+
     namespace sbp {
         // How many VonKarman profiles to save in the cache
         const int max_vonKarman_cache = 100;
+
+        // The reference lam/r0 and the spacing in log(L0/r0) of the grid used by
+        // SetVonKarmanInterpolated.
+        const double vonKarman_grid_lam = 2.5e-6;
+        const double vonKarman_grid_dlogL0 = 0.03;
     }
 
     class PUBLIC_API SBVonKarman : public SBProfile
@@ -36,7 +36,7 @@ namespace galsim {
     //
     //
 
-    class VonKarmanInfo
+    class VonKarmanInfo : public LRUCacheValue
     {
     public:
         VonKarmanInfo(double lam, double L0, bool doDelta, const GSParamsPtr& gsparams,
@@ -60,6 +60,12 @@ namespace galsim {
         double structureFunction(double rho) const;
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
 
+        /// @brief Build the `OneDimensionalDeviate` used by shoot() if necessary.
+        void checkSampler() const { if (!_sampler) _buildRadialFunc(); }
+
+        /// @brief Estimate the memory used by this object, in bytes.
+        size_t getMemorySize() const;
+
         double kValueNoTrunc(double) const;
         double rawXValue(double) const;
 
@@ -120,7 +126,13 @@ namespace galsim {
         double getL0() const { return _L0; }
         double getScale() const { return _scale; }
         bool getDoDelta() const { return _doDelta; }
-        double maxSB() const { return _flux * _info->xValue(0.); }
+        bool getStructure(ProfileStructure& key) const
+        {
+            key.add("VonKarman").add(_lam).add(_r0).add(_L0).add(_flux).add(_scale);
+            key.add(_doDelta).add(_interpolated).add(_c).add(_w);
+            return true;
+        }
+        double maxSB() const { return _flux * infoXValue(0.); }
 
         /**
          * @brief SBVonKarman photon-shooting is done numerically with `OneDimensionalDeviate`
@@ -131,6 +143,11 @@ namespace galsim {
          * @returns PhotonArray containing all the photons' info.
          */
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
+        void prepareShoot() const
+        {
+            _info->checkSampler();
+            if (_info2) _info2->checkSampler();
+        }
 
         double xValue(const Position<double>& p) const;
         double xValue(double r) const;
@@ -165,8 +182,61 @@ namespace galsim {
         double _flux;
         double _scale;
         bool _doDelta;
+        bool _interpolated;  // Whether the infos are on the grid in L0/r0.
+        double _c;  // Size of this profile relative to _info, when interpolating.
+        double _w;  // Weight of _info2, when interpolating.
 
         shared_ptr<VonKarmanInfo> _info;
+        shared_ptr<VonKarmanInfo> _info2;  // Only set when interpolating in L0.
+
+        // The (possibly interpolated) values of the info at r or k in arcsec.
+        double infoXValue(double r) const
+        {
+            r /= _c;
+            double val = _info->xValue(r);
+            if (_info2) val = (1.-_w) * val + _w * _info2->xValue(r);
+            return val / (_c*_c);
+        }
+        double infoKValue(double k) const
+        {
+            k *= _c;
+            double val = _info->kValue(k);
+            if (_info2) val = (1.-_w) * val + _w * _info2->kValue(k);
+            return val;
+        }
+
+        void doFillXImage(ImageView<double> im,
+                          double x0, double dx, int izero,
+                          double y0, double dy, int jzero) const
+        { fillXImage(im,x0,dx,izero,y0,dy,jzero); }
+        void doFillXImage(ImageView<double> im,
+                          double x0, double dx, double dxy,
+                          double y0, double dy, double dyx) const
+        { fillXImage(im,x0,dx,dxy,y0,dy,dyx); }
+        void doFillXImage(ImageView<float> im,
+                          double x0, double dx, int izero,
+                          double y0, double dy, int jzero) const
+        { fillXImage(im,x0,dx,izero,y0,dy,jzero); }
+        void doFillXImage(ImageView<float> im,
+                          double x0, double dx, double dxy,
+                          double y0, double dy, double dyx) const
+        { fillXImage(im,x0,dx,dxy,y0,dy,dyx); }
+        void doFillKImage(ImageView<std::complex<double> > im,
+                          double kx0, double dkx, int izero,
+                          double ky0, double dky, int jzero) const
+        { fillKImage(im,kx0,dkx,izero,ky0,dky,jzero); }
+        void doFillKImage(ImageView<std::complex<double> > im,
+                          double kx0, double dkx, double dkxy,
+                          double ky0, double dky, double dkyx) const
+        { fillKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx); }
+        void doFillKImage(ImageView<std::complex<float> > im,
+                          double kx0, double dkx, int izero,
+                          double ky0, double dky, int jzero) const
+        { fillKImage(im,kx0,dkx,izero,ky0,dky,jzero); }
+        void doFillKImage(ImageView<std::complex<float> > im,
+                          double kx0, double dkx, double dkxy,
+                          double ky0, double dky, double dkyx) const
+        { fillKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx); }
 
         // Copy constructor and op= are undefined.
         SBVonKarmanImpl(const SBVonKarmanImpl& rhs);
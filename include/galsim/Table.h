@@ -56,6 +56,10 @@ namespace galsim {
         double argMax() const;
         size_t size() const;
 
+        /// The memory used by the table, in bytes, including sizeof(Table).
+        /// (Not counting the args and vals arrays, which are owned by the caller.)
+        size_t getMemorySize() const;
+
         /// interp, return double(0) if beyond bounds
         /// This is a virtual function from FluxDensity, which lets a Table be a FluxDensity.
         double operator()(double a) const;
@@ -111,6 +115,18 @@ namespace galsim {
 
         void finalize();
 
+        /// The args and vals that have been added so far.
+        const std::vector<double>& getArgs() const { return _xvec; }
+        const std::vector<double>& getVals() const { return _fvec; }
+
+        /// The memory used by the table, in bytes, including sizeof(TableBuilder) and its own
+        /// arg/val storage.
+        size_t getMemorySize() const
+        {
+            return Table::getMemorySize() + sizeof(*this) - sizeof(Table) +
+                (_xvec.capacity() + _fvec.capacity()) * sizeof(double);
+        }
+
     private:
 
         bool _final;
@@ -131,8 +147,12 @@ namespace galsim {
         /// Table from xargs, yargs, vals
         Table2D(const double* xargs, const double* yargs, const double* vals,
                 int Nx, int Ny, interpolant in);
+        /// Spline table from xargs, yargs, vals and the derivatives at the grid points.
+        /// If precompute is true, the 16 bicubic coefficients of each grid cell are calculated
+        /// up front, which makes lookups faster at the cost of 16 doubles of memory per cell.
         Table2D(const double* xargs, const double* yargs, const double* vals,
-                int Nx, int Ny, const double* dfdx, const double* dfdy, const double* d2fdxdy);
+                int Nx, int Ny, const double* dfdx, const double* dfdy, const double* d2fdxdy,
+                bool precompute=false);
         Table2D(const double* xargs, const double* yargs, const double* vals,
                 int Nx, int Ny, const Interpolant* gsinterp);
 
@@ -154,6 +174,10 @@ namespace galsim {
         void gradientGrid(const double* xvec, const double* yvec,
                           double* dfdxvec, double* dfdyvec, int Nx, int Ny) const;
 
+        /// The memory used by the table, in bytes, including sizeof(Table2D).
+        /// (Not counting the args, vals and derivative arrays, which are owned by the caller.)
+        size_t getMemorySize() const;
+
         class Table2DImpl;
     protected:
         const shared_ptr<Table2DImpl> _pimpl;
@@ -164,7 +188,7 @@ namespace galsim {
         static std::shared_ptr<Table2DImpl> _makeImpl(
             const double* xargs, const double* yargs, const double* vals,
             int Nx, int Ny,
-            const double* dfdx, const double* dfdy, const double* d2fdxdy);
+            const double* dfdx, const double* dfdy, const double* d2fdxdy, bool precompute);
         static std::shared_ptr<Table2DImpl> _makeImpl(
             const double* xargs, const double* yargs, const double* vals,
             int Nx, int Ny, const Interpolant* gsinterp);
@@ -0,0 +1,108 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2023 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#ifndef GalSim_TableCache_H
+#define GalSim_TableCache_H
+
+#include <string>
+#include <vector>
+#include "Std.h"
+#include "GSParams.h"
+#include "Table.h"
+
+namespace galsim {
+
+    /**
+     * @brief An optional on-disk cache of the lookup tables that some profiles build.
+     *
+     * Profiles like Sersic, Kolmogorov, VonKarman and SecondKick build a lookup table the first
+     * time they are used, typically by doing a numerical Hankel transform at hundreds of points.
+     * The LRUCache keeps these within one process, but each new process has to do this again.
+     *
+     * If a cache directory is set (either with SetTableCacheDir or with the environment variable
+     * GALSIM_TABLE_CACHE_DIR), then finished tables are also written to that directory, one file
+     * per table, and other processes load them from there instead of building them again.
+     *
+     * The files are binary, with a header that records a format version and the full key.  The
+     * key includes the GalSim version, a version number for the algorithm that builds the
+     * table, the GSParams, and the parameters of the profile, so a file is only used if
+     * everything that went into building the table is the same.  The GalSim version doesn't
+     * change between releases, so each builder must increment its own version number whenever
+     * it changes how the table is computed.  Files are
+     * written to a temporary name and then renamed, so processes that start at the same time
+     * never see partial files.  Any problem reading or writing a file just means the table is
+     * built as usual.
+     */
+    class PUBLIC_API TableCacheKey
+    {
+    public:
+        /**
+         * @brief Start a key for the given kind of table.
+         *
+         * @param[in] name      A name for the kind of table, e.g. "SersicFT".  This is also
+         *                      used as the start of the file name.
+         * @param[in] version   The version of the algorithm used to build this kind of table.
+         * @param[in] gsparams  The GSParams used to build the table.
+         */
+        TableCacheKey(const std::string& name, int version, const GSParams& gsparams);
+
+        /// @brief Add a parameter of the profile to the key.
+        TableCacheKey& add(double x);
+
+        const std::string& getName() const { return _name; }
+        const std::string& str() const { return _key; }
+
+    private:
+        std::string _name;
+        std::string _key;
+    };
+
+    /// @brief Set the directory for the table cache.  An empty string turns the cache off.
+    PUBLIC_API void SetTableCacheDir(const std::string& dir);
+
+    /// @brief Get the directory for the table cache.  An empty string means the cache is off.
+    PUBLIC_API std::string GetTableCacheDir();
+
+    /**
+     * @brief Try to load a table from the cache.
+     *
+     * @param[in]  key      The key for this table.
+     * @param[out] table    The table to fill.  It must be empty on input.  On success, it is
+     *                      finalized.
+     * @param[in,out] values   Any other values that were saved along with the table.  On input,
+     *                          it should have the size that is expected.
+     *
+     * @returns whether the table was found.
+     */
+    PUBLIC_API bool LoadCachedTable(const TableCacheKey& key, TableBuilder& table,
+                                    std::vector<double>& values);
+
+    /**
+     * @brief Save a table to the cache, if the cache is turned on.
+     *
+     * @param[in] key       The key for this table.
+     * @param[in] table     The finished table.
+     * @param[in] values    Any other values that should be saved along with the table.
+     */
+    PUBLIC_API void SaveCachedTable(const TableCacheKey& key, const TableBuilder& table,
+                                    const std::vector<double>& values);
+
+}
+
+#endif
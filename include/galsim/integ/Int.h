@@ -119,6 +119,18 @@
  *     (It is intended to be an overestimate of the actual error,
  *     but it doesn't always get it completely right.)
  *
+ *     If evaluating the function at many points at once is cheaper than one at a time,
+ *     the function object may also define
+ *
+ *     void evalMany(const double* x, double* f, int n) const;
+ *
+ *     Then each set of new Gauss-Kronrod-Patterson abscissae is evaluated with a single call.
+ *     For int2d, the corresponding method of the 2-d function is
+ *
+ *     void evalMany(double x, const double* y, double* f, int n) const;
+ *
+ *     which evaluates f(x,y[i]) for the inner integral over y.
+ *
  *
  *
  * Two- and Three-Dimensional Integrals:
@@ -392,6 +404,45 @@ namespace integ {
     };
 
     namespace {
+        /**
+         * @brief Evaluate a function at many points.
+         *
+         * A function object may optionally provide a batched version of operator():
+         *
+         *     void evalMany(const double* x, double* f, int n) const;
+         *
+         * in which case intGKPNA evaluates all of the new abscissae at each level with a
+         * single call.  Otherwise this just calls func(x) for each point.
+         */
+        template <class UF>
+        struct HasEvalMany
+        {
+            template <class U> static char test(decltype(&U::evalMany));
+            template <class U> static long test(...);
+            static const bool value = sizeof(test<UF>(0)) == 1;
+        };
+
+        template <class UF, bool batched=HasEvalMany<UF>::value>
+        struct EvalMany
+        {
+            static void call(const UF& func, const double* x, double* f, int n)
+            { for (int i=0; i<n; ++i) f[i] = func(x[i]); }
+        };
+
+        template <class UF>
+        struct EvalMany<UF,true>
+        {
+            static void call(const UF& func, const double* x, double* f, int n)
+            { func.evalMany(x,f,n); }
+        };
+
+        /// The largest number of new abscissae at any one level of the GKP rule
+        constexpr int gkpMaxN(int level=0)
+        {
+            return level == NGKPLEVELS ? 0 :
+                gkp_ngkp[level] > gkpMaxN(level+1) ? gkp_ngkp[level] : gkpMaxN(level+1);
+        }
+
         /// Rescale the error if int |f| dx or int |f-mean| dx are too large
         template <class T>
         inline T rescaleError(
@@ -455,6 +506,9 @@ namespace integ {
 #endif
             const int nmax = 2*gkp_x<T>(NGKPLEVELS-1).size()-1;
             std::vector<T> fv1(nmax), fv2(nmax);
+            // The abscissae and function values for each level, evaluated together.
+            // These are sized for the level with the most points, so they can live on the stack.
+            T xv[2*gkpMaxN()], fv[2*gkpMaxN()];
 
             fv1.clear();
             fv2.clear();
@@ -466,16 +520,22 @@ namespace integ {
             assert(gkp_wb<T>(0).size() == gkp_x<T>(0).size()+1);
             T area1 = gkp_wb<T>(0).back() * f_center;
             int n0 = gkp_x<T>(0).size();
+            assert(n0 == gkp_n(0));
             for (int k=0; k<n0; k++) {
                 const T abscissa = half_length * gkp_x<T>(0)[k];
-                const T fval1 = func(center - abscissa);
-                const T fval2 = func(center + abscissa);
+                xv[2*k] = center - abscissa;
+                xv[2*k+1] = center + abscissa;
+            }
+            EvalMany<UF>::call(func, xv, fv, 2*n0);
+            for (int k=0; k<n0; k++) {
+                const T fval1 = fv[2*k];
+                const T fval2 = fv[2*k+1];
                 area1 += gkp_wb<T>(0)[k] * (fval1+fval2);
                 fv1.push_back(fval1);
                 fv2.push_back(fval2);
                 if (reg.fxmap) {
-                    (*reg.fxmap)[center-abscissa] = fval1;
-                    (*reg.fxmap)[center+abscissa] = fval2;
+                    (*reg.fxmap)[xv[2*k]] = fval1;
+                    (*reg.fxmap)[xv[2*k+1]] = fval2;
                 }
             }
             area1 *= half_length;
@@ -502,10 +562,16 @@ namespace integ {
                             (std::abs(fv1[k]) + std::abs(fv2[k]));
                 }
                 int nl = gkp_x<T>(level).size();
+                assert(nl == gkp_n(level));
                 for (int k=0; k<nl; k++) {
                     const T abscissa = half_length * gkp_x<T>(level)[k];
-                    const T fval1 = func(center - abscissa);
-                    const T fval2 = func(center + abscissa);
+                    xv[2*k] = center - abscissa;
+                    xv[2*k+1] = center + abscissa;
+                }
+                EvalMany<UF>::call(func, xv, fv, 2*nl);
+                for (int k=0; k<nl; k++) {
+                    const T fval1 = fv[2*k];
+                    const T fval2 = fv[2*k+1];
                     const T fval = fval1 + fval2;
                     area2 += gkp_wb<T>(level)[k] * fval;
                     if (calc_int_abs)
@@ -513,8 +579,8 @@ namespace integ {
                     fv1.push_back(fval1);
                     fv2.push_back(fval2);
                     if (reg.fxmap) {
-                        (*reg.fxmap)[center-abscissa] = fval1;
-                        (*reg.fxmap)[center+abscissa] = fval2;
+                        (*reg.fxmap)[xv[2*k]] = fval1;
+                        (*reg.fxmap)[xv[2*k+1]] = fval2;
                     }
                 }
 #ifdef COUNTFEVAL
@@ -747,8 +813,16 @@ namespace integ {
             AuxFunc1(const UF& _f) : f(_f) {}
             double operator()(double x) const
             { return f(1./x-1.)/(x*x); }
+            void evalMany(const double* x, double* fx, int n) const
+            {
+                t.resize(n);
+                for (int i=0; i<n; ++i) t[i] = 1./x[i]-1.;
+                EvalMany<UF>::call(f, &t[0], fx, n);
+                for (int i=0; i<n; ++i) fx[i] /= x[i]*x[i];
+            }
         private:
             const UF& f;
+            mutable std::vector<double> t;
         };
 
         template <class UF>
@@ -762,8 +836,16 @@ namespace integ {
             AuxFunc2(const UF& _f) : f(_f) {}
             double operator()(double x) const
             { return f(1./x+1.)/(x*x); }
+            void evalMany(const double* x, double* fx, int n) const
+            {
+                t.resize(n);
+                for (int i=0; i<n; ++i) t[i] = 1./x[i]+1.;
+                EvalMany<UF>::call(f, &t[0], fx, n);
+                for (int i=0; i<n; ++i) fx[i] /= x[i]*x[i];
+            }
         private:
             const UF& f;
+            mutable std::vector<double> t;
         };
 
         template <class UF> AuxFunc2<UF>
@@ -849,6 +931,35 @@ namespace integ {
     }
 
     namespace {
+        /**
+         * @brief The inner integrand of int2d, f(x,y) at fixed x as a function of y.
+         *
+         * If the 2-d function provides
+         *
+         *     void evalMany(double x, const double* y, double* f, int n) const;
+         *
+         * then this passes the batched evaluation along.
+         */
+        template <class BF, bool batched=HasEvalMany<BF>::value>
+        struct Int2DInner
+        {
+            Int2DInner(const BF& _func, double _x) : func(_func), x(_x) {}
+            double operator()(double y) const { return func(x,y); }
+            const BF& func;
+            double x;
+        };
+
+        template <class BF>
+        struct Int2DInner<BF,true>
+        {
+            Int2DInner(const BF& _func, double _x) : func(_func), x(_x) {}
+            double operator()(double y) const { return func(x,y); }
+            void evalMany(const double* y, double* f, int n) const
+            { func.evalMany(x,y,f,n); }
+            const BF& func;
+            double x;
+        };
+
         template <class BF, class YREG>
         class Int2DAuxType
         {
@@ -860,9 +971,8 @@ namespace integ {
 
             double operator()(double x) const
             {
-                using namespace std::placeholders;
                 auto tempreg = yreg(x);
-                double result = int1d(std::bind(func,x,_1), tempreg, relerr, abserr);
+                double result = int1d(Int2DInner<BF>(func,x), tempreg, relerr, abserr);
                 integ_dbg3<<"Evaluated int2dAux at x = "<<x;
                 integ_dbg3<<": f = "<<result<<" +- "<<tempreg.getErr()<<std::endl;
                 return result;
@@ -34,11 +34,13 @@ namespace integ {
 
     static const int NGKPLEVELS = 7;
 
+    /// The number of evaluation points at each level
+    static constexpr int gkp_ngkp[NGKPLEVELS] = {0,1,2,4,8,16,32};
+
     inline int gkp_n(int level) 
     { 
         assert(level >= 0 && level < NGKPLEVELS);
-        static const int ngkp[NGKPLEVELS] = {0,1,2,4,8,16,32};
-        return ngkp[level]; 
+        return gkp_ngkp[level];
     }
 
     template <class T> 
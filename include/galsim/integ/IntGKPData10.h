@@ -39,11 +39,12 @@ namespace integ {
     static const int NGKPLEVELS = 5;
 
     /// The number of evaluation points at each level
+    static constexpr int gkp_ngkp[NGKPLEVELS] = {5,5,11,22,44};
+
     inline int gkp_n(int level) 
     { 
         assert(level >= 0 && level < NGKPLEVELS);
-        static const int ngkp[NGKPLEVELS] = {5,5,11,22,44};
-        return ngkp[level]; 
+        return gkp_ngkp[level];
     }
 
     /**
@@ -33,6 +33,25 @@ namespace math {
         const std::function<double(double)> f, double k, double nu,
         double relerr=1.e-6, double abserr=1.e-12, int nzeros=10);
 
+    /**
+     * @brief Calculate the Hankel transform at many log-spaced values of k in one call.
+     *
+     * This calculates F(k) = int_0^inf r f(r) J_nu(k r) dr, the same as hankel_inf, for
+     * k_i = exp(logk0 + i*dlogk), i = 0..nk-1, and writes them to result[i].
+     *
+     * The whole set is done at once with the FFTLog algorithm (Hamilton, 2000, MNRAS, 312, 257),
+     * which takes O(N log N) time rather than a separate adaptive integration for each k.
+     * To check the accuracy, the transform is done twice, the second time with half the
+     * spacing and a wider range in r.  Any values where the two disagree by more than
+     * relerr*|F| + abserr are recalculated with hankel_inf.
+     *
+     * f(r) must be smooth and fall off faster than 1/r at large r.  It is evaluated over
+     * a range somewhat wider than [exp(-logk_max), exp(-logk0)].
+     */
+    PUBLIC_API void hankel_inf_many(
+        const std::function<double(double)> f, double logk0, double dlogk, int nk, double nu,
+        double* result, double relerr=1.e-6, double abserr=1.e-12, int nzeros=10);
+
 }
 }
 
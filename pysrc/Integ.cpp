@@ -76,10 +76,21 @@ namespace integ {
         }
     }
 
+    // Do the Hankel transform of a python function at log-spaced k values using FFTLog.
+    void PyHankelFFTLog(const py::function& func, double logk0, double dlogk, int N,
+                        size_t ires, double nu,
+                        double rel_err=DEFRELERR, double abs_err=DEFABSERR)
+    {
+        double* res = reinterpret_cast<double*>(ires);
+        PyFunc pyfunc(func);
+        math::hankel_inf_many(pyfunc, logk0, dlogk, N, nu, res, rel_err, abs_err);
+    }
+
     void pyExportInteg(py::module& _galsim)
     {
         _galsim.def("PyInt1d", &PyInt1d);
         _galsim.def("PyHankel", &PyHankel);
+        _galsim.def("PyHankelFFTLog", &PyHankelFFTLog);
     }
 
 } // namespace integ
@@ -0,0 +1,43 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2023 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include "PyBind11Helper.h"
+#include "PSFAtlas.h"
+
+namespace galsim {
+
+    template <typename T, typename W>
+    static void WrapTemplates(W& wrapper)
+    {
+        typedef void (PSFAtlas::*draw_func)(ImageView<T>, double, double, double) const;
+        wrapper.def("drawStamp", (draw_func)&PSFAtlas::drawStamp);
+    }
+
+    void pyExportPSFAtlas(py::module& _galsim)
+    {
+        py::class_<PSFAtlas> pyPSFAtlas(_galsim, "PSFAtlas");
+        pyPSFAtlas
+            .def(py::init<const BaseImage<double>&, int, double, double, const Interpolant&>())
+            .def("getOversample", &PSFAtlas::getOversample);
+
+        WrapTemplates<float>(pyPSFAtlas);
+        WrapTemplates<double>(pyPSFAtlas);
+    }
+
+} // namespace galsim
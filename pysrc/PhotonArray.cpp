@@ -28,7 +28,9 @@ namespace galsim {
             .def("addTo", (double (PhotonArray::*)(ImageView<T>) const) &PhotonArray::addTo)
             .def("setFrom",
                  (int (PhotonArray::*)(const BaseImage<T>&, double, BaseDeviate))
-                 &PhotonArray::setFrom);
+                 &PhotonArray::setFrom)
+            .def_static("countFrom",
+                        (int (*)(const BaseImage<T>&, double)) &PhotonArray::countFrom);
     }
 
     static PhotonArray* construct(int N, size_t ix, size_t iy, size_t iflux,
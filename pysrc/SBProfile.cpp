@@ -20,6 +20,7 @@
 #include "PyBind11Helper.h"
 #include "SBProfile.h"
 #include "SBTransform.h"
+#include "LRUCache.h"
 
 namespace galsim {
 
@@ -39,6 +40,22 @@ namespace galsim {
         prof.drawK(image, dx, jac);
     }
 
+    static void SBPxValueMany(const SBProfile& prof, size_t ix, size_t iy, size_t ival, int N)
+    {
+        const double* x = reinterpret_cast<const double*>(ix);
+        const double* y = reinterpret_cast<const double*>(iy);
+        double* val = reinterpret_cast<double*>(ival);
+        prof.xValueMany(x, y, val, N);
+    }
+
+    static void SBPkValueMany(const SBProfile& prof, size_t ikx, size_t iky, size_t ival, int N)
+    {
+        const double* kx = reinterpret_cast<const double*>(ikx);
+        const double* ky = reinterpret_cast<const double*>(iky);
+        std::complex<double>* val = reinterpret_cast<std::complex<double>*>(ival);
+        prof.kValueMany(kx, ky, val, N);
+    }
+
     template <typename T, typename W>
     static void WrapTemplates(W& wrapper)
     {
@@ -49,17 +66,38 @@ namespace galsim {
         wrapper.def("drawK", (drawK_func)&SBPdrawK);
     }
 
+    static py::list GetLRUCacheStats()
+    {
+        py::list stats;
+        std::vector<LRUCacheBase*> caches = LRUCacheBase::GetCaches();
+        for (size_t i=0; i<caches.size(); ++i) {
+            const LRUCacheBase& c = *caches[i];
+            stats.append(py::make_tuple(c.getName(), c.size(), c.getMaxSize(),
+                                        c.getMemorySize(), c.getHits(), c.getMisses(),
+                                        c.getEvictions()));
+        }
+        return stats;
+    }
+
+    static void ResetLRUCacheStats()
+    {
+        std::vector<LRUCacheBase*> caches = LRUCacheBase::GetCaches();
+        for (size_t i=0; i<caches.size(); ++i) caches[i]->resetStats();
+    }
+
     void pyExportSBProfile(py::module& _galsim)
     {
         py::class_<GSParams>(_galsim, "GSParams")
             .def(py::init<
                  int, int, double, double, double, double, double, double, double, double,
-                 double, double, double>());
+                 double, double, double, double, bool>());
 
         py::class_<SBProfile> pySBProfile(_galsim, "SBProfile");
         pySBProfile
             .def("xValue", &SBProfile::xValue)
             .def("kValue", &SBProfile::kValue)
+            .def("xValueMany", &SBPxValueMany)
+            .def("kValueMany", &SBPkValueMany)
             .def("maxK", &SBProfile::maxK)
             .def("stepK", &SBProfile::stepK)
             .def("centroid", &SBProfile::centroid)
@@ -70,6 +108,13 @@ namespace galsim {
             .def("shoot", &SBProfile::shoot);
         WrapTemplates<float>(pySBProfile);
         WrapTemplates<double>(pySBProfile);
+
+        _galsim.def("GetLRUCacheStats", &GetLRUCacheStats);
+        _galsim.def("ResetLRUCacheStats", &ResetLRUCacheStats);
+        _galsim.def("SetLRUCacheMemoryBudget", &LRUCacheBase::SetMemoryBudget);
+        _galsim.def("GetLRUCacheMemoryBudget", &LRUCacheBase::GetMemoryBudget);
+        _galsim.def("SetDrawCache", &SetDrawCache);
+        _galsim.def("GetDrawCache", &GetDrawCache);
     }
 
 } // namespace galsim
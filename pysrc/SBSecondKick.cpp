@@ -28,6 +28,8 @@ namespace galsim {
             .def(py::init<double,double,double,GSParams>())
             .def("getDelta", &SBSecondKick::getDelta)
             .def("structureFunction", &SBSecondKick::structureFunction);
+        _galsim.def("SetSecondKickInterpolated", &SetSecondKickInterpolated);
+        _galsim.def("GetSecondKickInterpolated", &GetSecondKickInterpolated);
     }
 
 } // namespace galsim
@@ -30,6 +30,8 @@ namespace galsim {
         _galsim.def("SersicTruncatedScale", &SersicTruncatedScale);
         _galsim.def("SersicIntegratedFlux", &SersicIntegratedFlux);
         _galsim.def("SersicHLR", &SersicHLR);
+        _galsim.def("SetSersicInterpolatedFT", &SetSersicInterpolatedFT);
+        _galsim.def("GetSersicInterpolatedFT", &GetSersicInterpolatedFT);
     }
 
 } // namespace galsim
@@ -29,6 +29,8 @@ namespace galsim {
             .def("getDelta", &SBVonKarman::getDelta)
             .def("getHalfLightRadius", &SBVonKarman::getHalfLightRadius)
             .def("structureFunction", &SBVonKarman::structureFunction);
+        _galsim.def("SetVonKarmanInterpolated", &SetVonKarmanInterpolated);
+        _galsim.def("GetVonKarmanInterpolated", &GetVonKarmanInterpolated);
     }
 
 } // namespace galsim
@@ -20,6 +20,7 @@
 #include "PyBind11Helper.h"
 #include "Table.h"
 #include "Interpolant.h"
+#include "TableCache.h"
 
 namespace galsim {
 
@@ -69,7 +70,8 @@ namespace galsim {
     }
 
     static Table2D* MakeSplineTable2D(size_t ix, size_t iy, size_t ivals, int Nx, int Ny,
-                                      size_t idfdx, size_t idfdy, size_t id2fdxdy)
+                                      size_t idfdx, size_t idfdy, size_t id2fdxdy,
+                                      bool precompute)
     {
         const double* x = reinterpret_cast<const double*>(ix);
         const double* y = reinterpret_cast<const double*>(iy);
@@ -78,7 +80,7 @@ namespace galsim {
         const double* dfdy = reinterpret_cast<const double*>(idfdy);
         const double* d2fdxdy = reinterpret_cast<const double*>(id2fdxdy);
 
-        return new Table2D(x, y, vals, Nx, Ny, dfdx, dfdy, d2fdxdy);
+        return new Table2D(x, y, vals, Nx, Ny, dfdx, dfdy, d2fdxdy, precompute);
     }
 
 
@@ -165,6 +167,9 @@ namespace galsim {
             .def("gradientGrid", &GradientGrid);
 
         _galsim.def("WrapArrayToPeriod", &_WrapArrayToPeriod);
+
+        _galsim.def("SetTableCacheDir", &SetTableCacheDir);
+        _galsim.def("GetTableCacheDir", &GetTableCacheDir);
     }
 
 } // namespace galsim
@@ -48,6 +48,7 @@ namespace galsim {
     void pyExportRandom(py::module&);
     void pyExportTable(py::module&);
     void pyExportInterpolant(py::module&);
+    void pyExportPSFAtlas(py::module&);
     void pyExportCDModel(py::module&);
     void pyExportSilicon(py::module&);
     void pyExportRealGalaxy(py::module&);
@@ -98,6 +99,7 @@ PYBIND11_MODULE(_galsim, _galsim)
     galsim::pyExportRandom(_galsim);
     galsim::pyExportTable(_galsim);
     galsim::pyExportInterpolant(_galsim);
+    galsim::pyExportPSFAtlas(_galsim);
     galsim::pyExportCDModel(_galsim);
     galsim::pyExportSilicon(_galsim);
     galsim::pyExportRealGalaxy(_galsim);
@@ -17,10 +17,69 @@
  *    and/or other materials provided with the distribution.
  */
 
+#include <exception>
 #include "CorrelatedNoise.h"
 
 namespace galsim {
 
+    /*
+     * The lag table needed by calculateCovarianceMatrix for an image with the given bounds.
+     */
+    Bounds<int> covarianceLagBounds(const Bounds<int>& bounds)
+    {
+        int idim = 1 + bounds.getXMax() - bounds.getXMin();
+        int jdim = 1 + bounds.getYMax() - bounds.getYMin();
+        return Bounds<int>(-(jdim-1), idim-1, -(idim-1), jdim-1);
+    }
+
+    /*
+     * Evaluate the correlation function at each pixel separation (k, ell) in the bounds of lags.
+     */
+    void calculateCovarianceLags(ImageView<double> lags, const SBProfile& sbp, double dx)
+    {
+        const int kmin = lags.getXMin();
+        const int ellmin = lags.getYMin();
+        const int nk = lags.getNCol();
+        const int nell = lags.getNRow();
+        if (nk <= 0 || nell <= 0) return;
+
+        std::vector<double> x(nk);
+        for (int k=0; k<nk; ++k) x[k] = double(kmin + k) * dx;
+
+        // Do the first row on its own, so any lazy initialization in the profile is done
+        // before the threads start.  Then the rest are independent, so do them in parallel.
+        std::vector<double> y(nk, double(ellmin) * dx);
+        std::vector<double> row(nk);
+        sbp.xValueMany(&x[0], &y[0], &row[0], nk);
+        for (int k=0; k<nk; ++k) lags(kmin+k, ellmin) = row[k];
+
+        std::exception_ptr eptr;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            std::vector<double> y(nk);
+            std::vector<double> row(nk);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic,1)
+#endif
+            for (int j=1; j<nell; ++j) {
+                try {
+                    const int ell = ellmin + j;
+                    for (int k=0; k<nk; ++k) y[k] = double(ell) * dx;
+                    sbp.xValueMany(&x[0], &y[0], &row[0], nk);
+                    for (int k=0; k<nk; ++k) lags(kmin+k, ell) = row[k];
+                } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical (calculateCovarianceLags)
+#endif
+                    eptr = std::current_exception();
+                }
+            }
+        }
+        if (eptr) std::rethrow_exception(eptr);
+    }
+
     /*
      * Covariance matrix calculation using the input SBProfile, the dimensions of the image for
      * which a covariance matrix is desired (in the form of a Bounds), and a scale dx
@@ -33,20 +92,35 @@ namespace galsim {
         int jdim = 1 + bounds.getYMax() - bounds.getYMin();
         int covdim = idim * jdim;
 
-        int k, ell; // k and l are indices that refer to image pixel separation vectors in the
-                    // correlation func.
-        double x_k, y_ell; // physical vector separations in the correlation func, dx * k etc.
-
-        for (int i=1; i<=covdim; i++) {
-            for (int j=i; j<=covdim; j++) {
-                k = ((j - 1) / jdim) - ((i - 1) / idim);  // using integer division rules here
-                ell = ((j - 1) % jdim) - ((i - 1) % idim);
-                x_k = double(k) * dx;
-                y_ell = double(ell) * dx;
-                Position<double> p = Position<double>(x_k, y_ell);
-                cov.setValue(i, j, sbp.xValue(p));
-            }
+        // The covariance only depends on the pixel separation (k, ell), so evaluate the profile
+        // once for each distinct separation and then copy the values into the matrix.
+        ImageAlloc<double> lags(covarianceLagBounds(bounds));
+        calculateCovarianceLags(lags.view(), sbp, dx);
 
+        const int kmin = lags.getXMin();
+        const int ellmin = lags.getYMin();
+        const int lstride = lags.getStride();
+        const double* ldata = lags.getData();
+        const int step = cov.getStep();
+
+        // Fill one row j of the matrix at a time, so the writes are contiguous.  For element
+        // (i, j), the pixel separation is
+        //     k = (j-1)/jdim - (i-1)/idim
+        //     ell = (j-1)%jdim - (i-1)%idim
+        // Only the upper triangle, i <= j, is filled.
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,16)
+#endif
+        for (int j=1; j<=covdim; j++) {
+            const int kj = (j - 1) / jdim - kmin;
+            const int ellj = (j - 1) % jdim - ellmin;
+            double* ptr = &cov(1, j);
+            int a = 0;  // (i-1) / idim
+            int b = 0;  // (i-1) % idim
+            for (int i=1; i<=j; i++, ptr+=step) {
+                *ptr = ldata[(ellj - b) * lstride + (kj - a)];
+                if (++b == idim) { b = 0; ++a; }
+            }
         }
     }
 
@@ -17,6 +17,7 @@
  *    and/or other materials provided with the distribution.
  */
 
+#include <functional>
 #include "GSParams.h"
 
 namespace galsim {
@@ -33,7 +34,9 @@ namespace galsim {
                        double _realspace_abserr,
                        double _integration_relerr,
                        double _integration_abserr,
-                       double _shoot_accuracy):
+                       double _shoot_accuracy,
+                       double _interpolant_phase_tolerance,
+                       bool _interpolant_tables):
         minimum_fft_size(_minimum_fft_size),
         maximum_fft_size(_maximum_fft_size),
         folding_threshold(_folding_threshold),
@@ -46,7 +49,9 @@ namespace galsim {
         realspace_abserr(_realspace_abserr),
         integration_relerr(_integration_relerr),
         integration_abserr(_integration_abserr),
-        shoot_accuracy(_shoot_accuracy)
+        shoot_accuracy(_shoot_accuracy),
+        interpolant_phase_tolerance(_interpolant_phase_tolerance),
+        interpolant_tables(_interpolant_tables)
     {}
 
     bool GSParams::operator==(const GSParams& rhs) const
@@ -70,6 +75,9 @@ namespace galsim {
         else if (integration_abserr != rhs.integration_abserr) return false;
 
         else if (shoot_accuracy != rhs.shoot_accuracy) return false;
+
+        else if (interpolant_phase_tolerance != rhs.interpolant_phase_tolerance) return false;
+        else if (interpolant_tables != rhs.interpolant_tables) return false;
         else return true;
     }
 
@@ -102,9 +110,39 @@ namespace galsim {
         else if (integration_abserr > rhs.integration_abserr) return false;
         else if (shoot_accuracy < rhs.shoot_accuracy) return true;
         else if (shoot_accuracy > rhs.shoot_accuracy) return false;
+        else if (interpolant_phase_tolerance < rhs.interpolant_phase_tolerance) return true;
+        else if (interpolant_phase_tolerance > rhs.interpolant_phase_tolerance) return false;
+        else if (interpolant_tables < rhs.interpolant_tables) return true;
+        else if (interpolant_tables > rhs.interpolant_tables) return false;
         else return false;
     }
 
+    // Combine the hash of one more value into h.
+    template <typename T>
+    static void HashAdd(size_t& h, const T& val)
+    { h ^= std::hash<T>()(val) + 0x9e3779b9 + (h<<6) + (h>>2); }
+
+    size_t GSParams::hash() const
+    {
+        size_t h = 0;
+        HashAdd(h, minimum_fft_size);
+        HashAdd(h, maximum_fft_size);
+        HashAdd(h, folding_threshold);
+        HashAdd(h, stepk_minimum_hlr);
+        HashAdd(h, maxk_threshold);
+        HashAdd(h, kvalue_accuracy);
+        HashAdd(h, xvalue_accuracy);
+        HashAdd(h, table_spacing);
+        HashAdd(h, realspace_relerr);
+        HashAdd(h, realspace_abserr);
+        HashAdd(h, integration_relerr);
+        HashAdd(h, integration_abserr);
+        HashAdd(h, shoot_accuracy);
+        HashAdd(h, interpolant_phase_tolerance);
+        HashAdd(h, interpolant_tables);
+        return h;
+    }
+
     std::ostream& operator<<(std::ostream& os, const GSParams& gsp)
     {
         os << gsp.minimum_fft_size << "," << gsp.maximum_fft_size << ",  "
@@ -114,7 +152,9 @@ namespace galsim {
             << gsp.table_spacing << ", "
             << gsp.realspace_relerr << "," << gsp.realspace_abserr << ",  "
             << gsp.integration_relerr << "," << gsp.integration_abserr << ",  "
-            << gsp.shoot_accuracy;
+            << gsp.shoot_accuracy << ",  "
+            << gsp.interpolant_phase_tolerance << ", "
+            << (gsp.interpolant_tables ? "True" : "False");
         return os;
     }
 
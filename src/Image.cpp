@@ -33,6 +33,7 @@
 
 #include "Image.h"
 #include "ImageArith.h"
+#include "FFTWPlanner.h"
 
 namespace galsim {
 
@@ -725,7 +726,6 @@ void wrapImage(ImageView<T> im, const Bounds<int>& b, bool hermx, bool hermy)
     }
 }
 
-
 template <typename T>
 void rfft(const BaseImage<T>& in, ImageView<std::complex<double> > out,
           bool shift_in, bool shift_out)
@@ -793,10 +793,17 @@ void rfft(const BaseImage<T>& in, ImageView<std::complex<double> > out,
     fftw_complex* kdata = reinterpret_cast<fftw_complex*>(out.getData());
     double* xdata = reinterpret_cast<double*>(out.getData());
 
-    fftw_plan plan = fftw_plan_dft_r2c_2d(Ny, Nx, xdata, kdata, FFTW_ESTIMATE);
+    fftw_plan plan;
+    {
+        std::lock_guard<std::mutex> lock(GetFFTWPlannerMutex());
+        plan = fftw_plan_dft_r2c_2d(Ny, Nx, xdata, kdata, FFTW_ESTIMATE);
+    }
     if (plan==NULL) throw std::runtime_error("fftw_plan cannot be created");
     fftw_execute(plan);
-    fftw_destroy_plan(plan);
+    {
+        std::lock_guard<std::mutex> lock(GetFFTWPlannerMutex());
+        fftw_destroy_plan(plan);
+    }
 
     // The resulting image will still have a checkerboard pattern of +-1 on it, which
     // we want to remove.
@@ -904,10 +911,17 @@ void irfft(const BaseImage<T>& in, ImageView<double> out, bool shift_in, bool sh
     double* xdata = out.getData();
     fftw_complex* kdata = reinterpret_cast<fftw_complex*>(xdata);
 
-    fftw_plan plan = fftw_plan_dft_c2r_2d(Ny, Nx, kdata, xdata, FFTW_ESTIMATE);
+    fftw_plan plan;
+    {
+        std::lock_guard<std::mutex> lock(GetFFTWPlannerMutex());
+        plan = fftw_plan_dft_c2r_2d(Ny, Nx, kdata, xdata, FFTW_ESTIMATE);
+    }
     if (plan==NULL) throw std::runtime_error("fftw_plan cannot be created");
     fftw_execute(plan);
-    fftw_destroy_plan(plan);
+    {
+        std::lock_guard<std::mutex> lock(GetFFTWPlannerMutex());
+        fftw_destroy_plan(plan);
+    }
 }
 
 template <typename T>
@@ -980,11 +994,18 @@ void cfft(const BaseImage<T>& in, ImageView<std::complex<double> > out,
 
     fftw_complex* kdata = reinterpret_cast<fftw_complex*>(out.getData());
 
-    fftw_plan plan = fftw_plan_dft_2d(Ny, Nx, kdata, kdata, inverse ? FFTW_BACKWARD : FFTW_FORWARD,
-                                      FFTW_ESTIMATE);
+    fftw_plan plan;
+    {
+        std::lock_guard<std::mutex> lock(GetFFTWPlannerMutex());
+        plan = fftw_plan_dft_2d(Ny, Nx, kdata, kdata, inverse ? FFTW_BACKWARD : FFTW_FORWARD,
+                                FFTW_ESTIMATE);
+    }
     if (plan==NULL) throw std::runtime_error("fftw_plan cannot be created");
     fftw_execute(plan);
-    fftw_destroy_plan(plan);
+    {
+        std::lock_guard<std::mutex> lock(GetFFTWPlannerMutex());
+        fftw_destroy_plan(plan);
+    }
 
     if (shift_in) {
         kptr = out.getData();
@@ -20,18 +20,18 @@
 //#define DEBUGLOGGING
 
 #include "Interpolant.h"
-#include "integ/Int.h"
 #include "SBProfile.h"
 #include "math/Sinc.h"
 #include "math/Angle.h"
+#include "fmath/fmath.hpp"  // For SSE
 
 // Gary's original code used a lot of lookup tables, but most of these have analytic formulae
-// that seem to be generally faster than the lookup table.  Part of this is probably because
-// our lookup table isn't super fast, so I'm leaving the code in, but disabled.  If we manage
-// to massively speed up the lookup table, it might be worth re-enabling this code with the
-// following #define.
-//
-//#define USE_TABLES
+// that are faster than our general-purpose spline Table.  So by default, Cubic and Quintic
+// use the analytic formulae for both xval and uval, and Lanczos uses them for xval.
+// If gsparams.interpolant_tables is set, they instead use an InterpolantTable, which is a
+// finely spaced table with linear interpolation.  This is typically a few times faster than
+// the analytic formulae, especially for Lanczos, and it is accurate to xvalue_accuracy and
+// kvalue_accuracy.
 
 // Gary's Quintic interpolant was designed to exactly interpolate up to 4th order of a Taylor
 // series expansion.  This implies F'(j) = F''(j) = F'''(j) = F''''(j) = 0.  However, it
@@ -86,6 +86,84 @@ namespace galsim {
 
     double InterpolantFunction::operator()(double x) const  { return _interp.xval(x); }
 
+    // The maximum number of cells in an InterpolantTable.
+    static const int MAX_TABLE_CELLS = 1<<20;
+
+    InterpolantTable::InterpolantTable(const std::function<double(double)>& func,
+                                       double xmax, double tol) :
+        _xmax(xmax)
+    {
+        // Start with 16 cells per unit x.  Then keep halving the spacing until linear
+        // interpolation is accurate to tol at the midpoints of the cells, which is where the
+        // error is largest.  The midpoint values become the new entries, so each function
+        // value is only calculated once.
+        int n = std::max(int(std::ceil(16.*xmax)), 1);
+        double dx = xmax / n;
+        std::vector<double> f(n+1);
+        for (int i=0; i<=n; ++i) f[i] = func(i*dx);
+        double maxerr;
+        do {
+            std::vector<double> f2(2*n+1);
+            maxerr = 0.;
+            for (int i=0; i<n; ++i) {
+                double fmid = func((i+0.5)*dx);
+                maxerr = std::max(maxerr, std::abs(fmid - 0.5*(f[i]+f[i+1])));
+                f2[2*i] = f[i];
+                f2[2*i+1] = fmid;
+            }
+            f2[2*n] = f[n];
+            f.swap(f2);
+            n *= 2;
+            dx *= 0.5;
+            dbg<<"InterpolantTable: n = "<<n<<", maxerr = "<<maxerr<<std::endl;
+        } while (maxerr > tol && n < MAX_TABLE_CELLS);
+        f.push_back(0.);
+        _f.swap(f);
+        _invdx = n / xmax;
+        _accurate = maxerr <= tol;
+    }
+
+    // Make an InterpolantTable for func.  If it can't reach the tolerance, return null, so the
+    // interpolant uses its analytic formula instead.  The interpolants cache a null result
+    // the same as a table, so this is only tried once for each tolerance.
+    static shared_ptr<InterpolantTable> MakeInterpolantTable(
+        const std::function<double(double)>& func, double xmax, double tol)
+    {
+        shared_ptr<InterpolantTable> table(new InterpolantTable(func, xmax, tol));
+        if (!table->isAccurate()) {
+            dbg<<"InterpolantTable did not reach tol = "<<tol<<".  Not using it.\n";
+            table.reset();
+        }
+        return table;
+    }
+
+    void InterpolantTable::evalMany(double* x, int N) const
+    {
+#ifdef __SSE2__
+        // Do 2 at a time as far as possible.  Values that are out of range (including NaN)
+        // are clamped to xmax for the table lookup and then masked to 0.
+        const double* f = &_f[0];
+        const __m128d signmask = _mm_set1_pd(-0.);
+        const __m128d xmax = _mm_set1_pd(_xmax);
+        const __m128d invdx = _mm_set1_pd(_invdx);
+        for (; N >= 2; N -= 2, x += 2) {
+            __m128d ax = _mm_andnot_pd(signmask, _mm_loadu_pd(x));
+            __m128d inrange = _mm_cmplt_pd(ax, xmax);
+            // Note: _mm_min_pd returns the second argument if either one is NaN.
+            __m128d t = _mm_mul_pd(_mm_min_pd(ax, xmax), invdx);
+            __m128i it = _mm_cvttpd_epi32(t);
+            __m128d dt = _mm_sub_pd(t, _mm_cvtepi32_pd(it));
+            int i0 = _mm_cvtsi128_si32(it);
+            int i1 = _mm_cvtsi128_si32(_mm_shuffle_epi32(it, 1));
+            __m128d f0 = _mm_set_pd(f[i1], f[i0]);
+            __m128d f1 = _mm_set_pd(f[i1+1], f[i0+1]);
+            __m128d val = _mm_add_pd(f0, _mm_mul_pd(dt, _mm_sub_pd(f1, f0)));
+            _mm_storeu_pd(x, _mm_and_pd(val, inrange));
+        }
+#endif
+        for (; N; --N, ++x) *x = (*this)(*x);
+    }
+
     double Interpolant::getPositiveFlux2d() const
     {
         double p = getPositiveFlux();
@@ -128,14 +206,67 @@ namespace galsim {
     {
         // x is both input and output here.
         // x_i <- xval(x_i)
-        for (; N; --N, ++x) *x = xval(*x);
+        if (_xtable) _xtable->evalMany(x, N);
+        else for (; N; --N, ++x) *x = xval(*x);
     }
 
     void Interpolant::uvalMany(double* u, int N) const
     {
         // u is both input and output here.
         // u_i <- uval(u_i)
-        for (; N; --N, ++u) *u = uval(*u);
+        if (_utable) _utable->evalMany(u, N);
+        else for (; N; --N, ++u) *u = uval(*u);
+    }
+
+    // The maximum number of values in the table of phase weights.
+    static const double MAX_PHASE_WEIGHTS = 1<<22;
+
+    // The number of phases per pixel needed to meet the given tolerance.  Rounding to the
+    // nearest multiple of 1/N has an error of at most 0.5/N.
+    static double NPhase(double tol)
+    { return std::ceil(0.5/tol); }
+
+    bool Interpolant::usePhaseWeights() const
+    {
+        const double tol = _gsparams.interpolant_phase_tolerance;
+        return tol > 0. && NPhase(tol) * nPhaseWeights() <= MAX_PHASE_WEIGHTS;
+    }
+
+    void Interpolant::checkPhaseWeights() const
+    {
+        // This may be called from several threads at once when drawing.
+#ifdef _OPENMP
+#pragma omp critical (Interpolant_phase_weights)
+#endif
+        if (_nPhase == 0) {
+            assert(usePhaseWeights());
+            const int N = int(NPhase(_gsparams.interpolant_phase_tolerance));
+            const int K = int(std::ceil(xrange()));
+            const int nw = 2*K+1;
+            dbg<<"Building phase weights: N = "<<N<<", K = "<<K<<std::endl;
+            std::vector<double> wt(size_t(N) * nw);
+            for (int iq=0; iq<N; ++iq) {
+                double f = double(iq) / N;
+                for (int k=-K; k<=K; ++k) wt[iq*nw + k+K] = xval(k-f);
+            }
+            _phaseWeights.swap(wt);
+            _nPhase = N;
+        }
+    }
+
+    const double* Interpolant::getPhaseWeights(double x, int& p0) const
+    {
+        if (_nPhase == 0) checkPhaseWeights();
+        const int N = _nPhase;
+        const int K = int(std::ceil(xrange()));
+        double t = std::floor(x*N + 0.5);
+        double i = std::floor(t/N);
+        int iq = int(t - i*N);
+        // t/N may round up to the next integer when t is just below a multiple of N.
+        if (iq < 0) { iq += N; i -= 1.; }
+        else if (iq >= N) { iq -= N; i += 1.; }
+        p0 = int(i) - K;
+        return &_phaseWeights[iq * (2*K+1)];
     }
 
     //
@@ -281,42 +412,30 @@ namespace galsim {
     // Cubic
     //
 
-    double Cubic::xval(double x) const
+    double Cubic::xCalc(double x) const
     {
-        x = std::abs(x);
         if (x < 1.) return 1. + x*x*(1.5*x-2.5);
         else if (x < 2.) return -0.5*(x-1.)*(x-2.)*(x-2.);
         else return 0.;
     }
 
-    double Cubic::uval(double u) const
+    double Cubic::uCalc(double u) const
     {
-        u = std::abs(u);
-#ifdef USE_TABLES
-        return u>_uMax ? 0. : (*_tab)(u);
-#else
         double s = math::sinc(u);
         double c = cos(M_PI*u);
         return s*s*s*(3.*s-2.*c);
-#endif
     }
 
-    class CubicIntegrand
+    double Cubic::xval(double x) const
     {
-    public:
-        CubicIntegrand(double u, const Cubic& c): _u(u), _c(c) {}
-        double operator()(double x) const { return _c.xval(x)*std::cos(2*M_PI*_u*x); }
-
-    private:
-        double _u;
-        const Cubic& _c;
-    };
+        if (_xtable) return (*_xtable)(x);
+        else return xCalc(std::abs(x));
+    }
 
-    double Cubic::uCalc(double u, double tolerance) const
+    double Cubic::uval(double u) const
     {
-        CubicIntegrand ci(u, *this);
-        return 2.*( integ::int1d(ci, 0., 1., 0.1*tolerance, 0.1*tolerance)
-                    + integ::int1d(ci, 1., 2., 0.1*tolerance, 0.1*tolerance));
+        if (_utable) return (*_utable)(u);
+        else return uCalc(std::abs(u));
     }
 
     Cubic::Cubic(const GSParams& gsparams) : Interpolant(gsparams)
@@ -324,53 +443,31 @@ namespace galsim {
         dbg<<"Start Cubic\n";
         _range = 2.;
 
-#ifdef USE_TABLES
-        double tol = gsparams.kvalue_accuracy;
-        // Strangely, not all compilers correctly setup an empty map when it is a
-        // static variable, so you can get seg faults using it.
-        // Doing an explicit clear fixes the problem.
-        if (_cache_umax.size() == 0) { _cache_umax.clear(); _cache_tab.clear(); }
-
-        if (_cache_umax.count(tol)) {
-            // Then uMax and tab are already cached.
-            _tab = _cache_tab[tol];
-            _uMax = _cache_umax[tol];
-        } else {
-            // Then need to do the calculation and then cache it.
-            const double uStep =
-                gsparams.table_spacing * std::pow(gsparams.kvalue_accuracy/10.,0.25);
-            _uMax = 0.;
-            _tab.reset(new TableBuilder(Table::spline));
-            for (double u=0.; u - _uMax < 1. || u<1.1; u+=uStep) {
-                double ft = uCalc(u);
-#ifdef DEBUGLOGGING
-                double s = math::sinc(u);
-                double c = cos(M_PI*u);
-                double ft2 = s*s*s*(3.*s-2.*c);
-                dbg<<"u = "<<u<<", ft = "<<ft<<"  "<<ft2<<"  diff = "<<ft-ft2<<std::endl;
-#endif
-                _tab->addEntry(u, ft);
-                if (std::abs(ft) > tol) _uMax = u;
-            }
-            _tab->finalize();
-            // Save these values in the cache.
-            _cache_tab[tol] = _tab;
-            _cache_umax[tol] = _uMax;
-            dbg<<"umax = "<<_uMax<<", alt umax = "<<
-                std::pow((3.*sqrt(3.)/8.)/tol, 1./3.) / M_PI <<std::endl;
-        }
-#else
         // uMax is the value where |ft| <= tolerance
         // ft = sin(pi u)^3/(pi u)^3 * (3*sin(pi u)/(pi u) - 2*cos(pi u))
         // |ft| < 2 max[sin(x)^3 cos(x)] / (pi u)^3
         //      = 2 (3sqrt(3)/16) / (pi u)^3
         // umax = (3sqrt(3)/8 tol)^1/3 / pi
         _uMax = std::pow((3.*sqrt(3.)/8.)/gsparams.kvalue_accuracy, 1./3.) / M_PI;
-#endif
+
+        if (gsparams.interpolant_tables) {
+            const double xtol = gsparams.xvalue_accuracy;
+            const double utol = gsparams.kvalue_accuracy;
+            if (!_cache_xtable.count(xtol)) {
+                _cache_xtable[xtol] = MakeInterpolantTable(
+                        [this](double x) { return xCalc(x); }, _range, xtol);
+            }
+            if (!_cache_utable.count(utol)) {
+                _cache_utable[utol] = MakeInterpolantTable(
+                        [this](double u) { return uCalc(u); }, _uMax, utol);
+            }
+            _xtable = _cache_xtable[xtol];
+            _utable = _cache_utable[utol];
+        }
     }
 
-    std::map<double,shared_ptr<TableBuilder> > Cubic::_cache_tab;
-    std::map<double,double> Cubic::_cache_umax;
+    std::map<double,shared_ptr<InterpolantTable> > Cubic::_cache_xtable;
+    std::map<double,shared_ptr<InterpolantTable> > Cubic::_cache_utable;
 
     std::string Cubic::makeStr() const
     {
@@ -386,9 +483,8 @@ namespace galsim {
     // Quintic
     //
 
-    double Quintic::xval(double x) const
+    double Quintic::xCalc(double x) const
     {
-        x = std::abs(x);
 #ifdef ALT_QUINTIC
         // Gary claims in http://arxiv.org/abs/1401.2636 that his quintic function (below) has the
         // following properties:
@@ -432,12 +528,8 @@ namespace galsim {
 #endif
     }
 
-    double Quintic::uval(double u) const
+    double Quintic::uCalc(double u) const
     {
-        u = std::abs(u);
-#ifdef USE_TABLES
-        return u>_uMax ? 0. : (*_tab)(u);
-#else
         double s = math::sinc(u);
         double piu = M_PI*u;
         double c = cos(piu);
@@ -447,26 +539,19 @@ namespace galsim {
         return ssq*ssq*(ssq*(12.*piusq-50.) + 44.*s*c + 5.);
 #else
         return s*ssq*ssq*(s*(55.-19.*piusq) + 2.*c*(piusq-27.));
-#endif
 #endif
     }
 
-    class QuinticIntegrand
+    double Quintic::xval(double x) const
     {
-    public:
-        QuinticIntegrand(double u, const Quintic& q): _u(u), _q(q) {}
-        double operator()(double x) const { return _q.xval(x)*std::cos(2*M_PI*_u*x); }
-    private:
-        double _u;
-        const Quintic& _q;
-    };
+        if (_xtable) return (*_xtable)(x);
+        else return xCalc(std::abs(x));
+    }
 
-    double Quintic::uCalc(double u, double tolerance) const
+    double Quintic::uval(double u) const
     {
-        QuinticIntegrand qi(u, *this);
-        return 2.*( integ::int1d(qi, 0., 1., 0.1*tolerance, 0.1*tolerance)
-                    + integ::int1d(qi, 1., 2., 0.1*tolerance, 0.1*tolerance)
-                    + integ::int1d(qi, 2., 3., 0.1*tolerance, 0.1*tolerance));
+        if (_utable) return (*_utable)(u);
+        else return uCalc(std::abs(u));
     }
 
     Quintic::Quintic(const GSParams& gsparams) : Interpolant(gsparams)
@@ -474,50 +559,6 @@ namespace galsim {
         dbg<<"Start Quintic\n";
         _range = 3.;
 
-#ifdef USE_TABLES
-        double tol = gsparams.kvalue_accuracy;
-        // Strangely, not all compilers correctly setup an empty map when it is a
-        // static variable, so you can get seg faults using it.
-        // Doing an explicit clear fixes the problem.
-        if (_cache_umax.size() == 0) { _cache_umax.clear(); _cache_tab.clear(); }
-
-        if (_cache_umax.count(tol)) {
-            // Then uMax and tab are already cached.
-            _tab = _cache_tab[tol];
-            _uMax = _cache_umax[tol];
-        } else {
-            // Then need to do the calculation and then cache it.
-            const double uStep =
-                gsparams.table_spacing * std::pow(gsparams.kvalue_accuracy/10.,0.25);
-            _uMax = 0.;
-            _tab.reset(new TableBuilder(Table::spline));
-            for (double u=0.; u - _uMax < 1. || u<1.1; u+=uStep) {
-                dbg<<"u = "<<u<<std::endl;
-                double ft = uCalc(u);
-                _tab->addEntry(u, ft);
-#ifdef DEBUGLOGGING
-                double s = math::sinc(u);
-                double piu = M_PI*u;
-                double c = cos(piu);
-                double ssq = s*s;
-                double piusq = piu*piu;
-#ifdef ALT_QUINTIC
-                double ft2 = ssq*ssq*(ssq*(12.*piusq-50.) + 44.*s*c+5.);
-#else
-                double ft2 = s*ssq*ssq*(s*(55.-19.*piusq) + 2.*c*(piusq-27.));
-#endif
-                dbg<<"u = "<<u<<", ft = "<<ft<<"  "<<ft2<<"  diff = "<<ft-ft2<<std::endl;
-#endif
-                if (std::abs(ft) > tol) _uMax = u;
-            }
-            _tab->finalize();
-            // Save these values in the cache.
-            _cache_tab[tol] = _tab;
-            _cache_umax[tol] = _uMax;
-            dbg<<"umax = "<<_uMax<<", alt umax = "<<
-                std::pow((25.*sqrt(5.)/108.)/tol, 1./3.) / M_PI <<std::endl;
-        }
-#else
         // uMax is the value where |ft| <= tolerance
         // ft = sin(pi u)^5/(pi u)^5 * (sin(pi u)/(pi u)*(55.-19 pi^2 u^2)
         //                              + 2*cos(pi u)*(pi^2 u^2-27)))
@@ -525,26 +566,41 @@ namespace galsim {
         //      = 2 (25sqrt(5)/216) / (pi u)^3
         // umax = (25sqrt(5)/108 tol)^1/3 / pi
         _uMax = std::pow((25.*sqrt(5.)/108.)/gsparams.kvalue_accuracy, 1./3.) / M_PI;
-#endif
+
+        if (gsparams.interpolant_tables) {
+            const double xtol = gsparams.xvalue_accuracy;
+            const double utol = gsparams.kvalue_accuracy;
+            if (!_cache_xtable.count(xtol)) {
+                _cache_xtable[xtol] = MakeInterpolantTable(
+                        [this](double x) { return xCalc(x); }, _range, xtol);
+            }
+            if (!_cache_utable.count(utol)) {
+                _cache_utable[utol] = MakeInterpolantTable(
+                        [this](double u) { return uCalc(u); }, _uMax, utol);
+            }
+            _xtable = _cache_xtable[xtol];
+            _utable = _cache_utable[utol];
+        }
     }
 
     // Override default sampler configuration because Quintic filter has sign change in
     // outer interval
     void Quintic::checkSampler() const
     {
-        if (_sampler.get()) return;
-        std::vector<double> ranges(8);
-        ranges[0] = -3.;
-        ranges[1] = -(1./11.)*(25.+sqrt(31.));  // This is the extra zero-crossing
-        ranges[2] = -2.;
-        ranges[3] = -1.;
-        for (int i=0; i<4; i++)
-            ranges[7-i] = -ranges[i];
-        _sampler.reset(new OneDimensionalDeviate(_interp, ranges, false, 1.0, _gsparams));
+        if (!_sampler.get()) {
+            std::vector<double> ranges(8);
+            ranges[0] = -3.;
+            ranges[1] = -(1./11.)*(25.+sqrt(31.));  // This is the extra zero-crossing
+            ranges[2] = -2.;
+            ranges[3] = -1.;
+            for (int i=0; i<4; i++)
+                ranges[7-i] = -ranges[i];
+            _sampler.reset(new OneDimensionalDeviate(_interp, ranges, false, 1.0, _gsparams));
+        }
     }
 
-    std::map<double,shared_ptr<TableBuilder> > Quintic::_cache_tab;
-    std::map<double,double> Quintic::_cache_umax;
+    std::map<double,shared_ptr<InterpolantTable> > Quintic::_cache_xtable;
+    std::map<double,shared_ptr<InterpolantTable> > Quintic::_cache_utable;
 
     std::string Quintic::makeStr() const
     {
@@ -843,9 +899,6 @@ namespace galsim {
         // Doing an explicit clear fixes the problem.
         if (_cache_umax.size() == 0) {
             _cache_umax.clear();
-#ifdef USE_TABLES
-            _cache_xtab.clear();
-#endif
             _cache_utab.clear();
         }
 
@@ -853,24 +906,9 @@ namespace galsim {
 
         if (_cache_umax.count(key)) {
             // Then uMax and tab are already cached.
-#ifdef USE_TABLES
-            _xtab = _cache_xtab[key];
-#endif
             _utab = _cache_utab[key];
             _uMax = _cache_umax[key];
         } else {
-#ifdef USE_TABLES
-            // Build xtab = table of x values
-            _xtab.reset(new TableBuilder(Table::spline));
-            // Spline is accurate to O(dx^3), so errors should be ~dx^4.
-            const double xStep1 =
-                gsparams.table_spacing * std::pow(gsparams.xvalue_accuracy/10.,0.25);
-            // Make sure steps hit the integer values exactly.
-            const double xStep = 1. / std::ceil(1./xStep1);
-            for(double x=0.; x<_nd; x+=xStep) _xtab->addEntry(x, xCalc(x));
-            _xtab->finalize();
-#endif
-
             // Build utab = table of u values
             _utab.reset(new TableBuilder(Table::spline));
             // The peak second derivative of the Lanczos kernel if Fourier space empirically
@@ -886,34 +924,43 @@ namespace galsim {
             }
             _utab->finalize();
             // Save these values in the cache.
-#ifdef USE_TABLES
-            _cache_xtab[key] = _xtab;
-#endif
             _cache_utab[key] = _utab;
             _cache_umax[key] = _uMax;
         }
+
+        if (gsparams.interpolant_tables) {
+            // The x table depends on xvalue_accuracy rather than kvalue_accuracy.
+            KeyType xkey(n,std::pair<bool,double>(_conserve_dc,gsparams.xvalue_accuracy));
+            if (!_cache_xtable.count(xkey)) {
+                _cache_xtable[xkey] = MakeInterpolantTable(
+                        [this](double x) { return xCalc(x); }, _nd, gsparams.xvalue_accuracy);
+            }
+            if (!_cache_utable.count(key)) {
+                _cache_utable[key] = MakeInterpolantTable(
+                        [this](double u) { return uCalc(u); }, _uMax, tol);
+            }
+            _xtable = _cache_xtable[xkey];
+            _utable = _cache_utable[key];
+        }
     }
 
-    std::map<Lanczos::KeyType,shared_ptr<TableBuilder> > Lanczos::_cache_xtab;
     std::map<Lanczos::KeyType,shared_ptr<TableBuilder> > Lanczos::_cache_utab;
     std::map<Lanczos::KeyType,double> Lanczos::_cache_umax;
+    std::map<Lanczos::KeyType,shared_ptr<InterpolantTable> > Lanczos::_cache_xtable;
+    std::map<Lanczos::KeyType,shared_ptr<InterpolantTable> > Lanczos::_cache_utable;
 
     double Lanczos::xval(double x) const
     {
+        if (_xtable) return (*_xtable)(x);
         x = std::abs(x);
         if (x >= _nd) return 0.;
-        else {
-#ifdef USE_TABLES
-            return (*_xtab)(x);
-#else
-            return xCalc(x);
-#endif
-        }
+        else return xCalc(x);
     }
 
     double Lanczos::uval(double u) const
     {
-        // For this one, we always use the lookup table.
+        if (_utable) return (*_utable)(u);
+        // Otherwise, we use the spline lookup table.
         u = std::abs(u);
         return u>_uMax ? 0. : (*_utab)(u);
     }
@@ -0,0 +1,114 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2023 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <algorithm>
+#include "LRUCache.h"
+
+namespace galsim {
+
+    // The list of all existing caches.  This is deliberately never deleted, since the caches
+    // are static objects, and some of them may be destroyed after this list would be.
+    static std::vector<LRUCacheBase*>& CacheRegistry()
+    {
+        static std::vector<LRUCacheBase*>* registry = new std::vector<LRUCacheBase*>();
+        return *registry;
+    }
+
+    static std::mutex& CacheRegistryMutex()
+    {
+        static std::mutex* mutex = new std::mutex();
+        return *mutex;
+    }
+
+    // The default memory budget for all the caches together.
+    static std::atomic<size_t> memory_budget(size_t(256) * 1024 * 1024);
+
+    static std::atomic<long> current_time(0);
+
+    LRUCacheBase::LRUCacheBase(const std::string& name) :
+        _hits(0), _misses(0), _evictions(0), _bytes(0), _name(name)
+    {
+        std::lock_guard<std::mutex> lock(CacheRegistryMutex());
+        CacheRegistry().push_back(this);
+    }
+
+    LRUCacheBase::~LRUCacheBase()
+    {
+        std::lock_guard<std::mutex> lock(CacheRegistryMutex());
+        std::vector<LRUCacheBase*>& registry = CacheRegistry();
+        registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+    }
+
+    std::vector<LRUCacheBase*> LRUCacheBase::GetCaches()
+    {
+        std::lock_guard<std::mutex> lock(CacheRegistryMutex());
+        return CacheRegistry();
+    }
+
+    void LRUCacheBase::SetMemoryBudget(size_t nbytes)
+    {
+        memory_budget = nbytes;
+        EnforceMemoryBudget();
+    }
+
+    size_t LRUCacheBase::GetMemoryBudget()
+    { return memory_budget; }
+
+    size_t LRUCacheBase::GetTotalMemorySize()
+    {
+        std::lock_guard<std::mutex> lock(CacheRegistryMutex());
+        const std::vector<LRUCacheBase*>& registry = CacheRegistry();
+        size_t total = 0;
+        for (size_t i=0; i<registry.size(); ++i) total += registry[i]->_bytes;
+        return total;
+    }
+
+    long LRUCacheBase::NextTime()
+    { return ++current_time; }
+
+    void LRUCacheBase::EnforceMemoryBudget()
+    {
+        const size_t budget = memory_budget;
+        if (budget == 0) return;
+        std::lock_guard<std::mutex> lock(CacheRegistryMutex());
+        const std::vector<LRUCacheBase*>& registry = CacheRegistry();
+        while (true) {
+            size_t total = 0;
+            for (size_t i=0; i<registry.size(); ++i) total += registry[i]->_bytes;
+            if (total <= budget) break;
+            dbg<<"Cache memory "<<total<<" is over budget "<<budget<<std::endl;
+
+            // Find the least recently used value in any cache.
+            LRUCacheBase* oldest_cache = 0;
+            long oldest_time = -1;
+            for (size_t i=0; i<registry.size(); ++i) {
+                long t = registry[i]->oldestTime();
+                if (t >= 0 && (oldest_time < 0 || t < oldest_time)) {
+                    oldest_cache = registry[i];
+                    oldest_time = t;
+                }
+            }
+            // Nothing left that we can remove.
+            if (!oldest_cache) break;
+            dbg<<"Evict value from "<<oldest_cache->getName()<<" cache\n";
+            oldest_cache->evictOldest(oldest_time);
+        }
+    }
+
+}
@@ -0,0 +1,146 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2023 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+//#define DEBUGLOGGING
+
+#include <cmath>
+#include "PSFAtlas.h"
+
+namespace galsim {
+
+    PSFAtlas::PSFAtlas(const BaseImage<double>& image, int oversample, double x0, double y0,
+                       const Interpolant& interp) :
+        _interp(interp.clone()), _oversample(oversample)
+    {
+        if (oversample < 1) throw std::runtime_error("PSFAtlas oversample must be >= 1");
+        _n = int(std::ceil(interp.xrange()));
+        // The weights cover offsets -_n..._n+1 from the pixel just below the sample point.
+        // With this much padding, any stamp pixel that needs an index outside the stored
+        // array only touches padding, so it is zero.
+        _pad = 2*_n + 2;
+        const Bounds<int>& b = image.getBounds();
+        const int nx = b.getXMax() - b.getXMin() + 1;
+        const int ny = b.getYMax() - b.getYMin() + 1;
+        _nx = nx + 2*_pad;
+        _ny = ny + 2*_pad;
+        _x0 = x0 - b.getXMin() + _pad;
+        _y0 = y0 - b.getYMin() + _pad;
+        dbg<<"PSFAtlas: oversample = "<<oversample<<", n = "<<_n<<std::endl;
+        dbg<<"nx,ny = "<<_nx<<','<<_ny<<", x0,y0 = "<<_x0<<','<<_y0<<std::endl;
+
+        _data.assign(size_t(_nx) * _ny, 0.);
+        for (int j=0; j<ny; ++j) {
+            double* row = &_data[size_t(j + _pad) * _nx + _pad];
+            for (int i=0; i<nx; ++i) row[i] = image(b.getXMin()+i, b.getYMin()+j);
+        }
+    }
+
+    void PSFAtlas::getWeights(double frac, std::vector<double>& w) const
+    {
+        w.resize(2*_n+2);
+        for (int k=-_n; k<=_n+1; ++k) w[k+_n] = _interp->xval(frac - k);
+    }
+
+    template <typename T>
+    void PSFAtlas::drawStamp(ImageView<T> stamp, double x0, double y0, double flux) const
+    {
+        const int xmin = stamp.getXMin();
+        const int ymin = stamp.getYMin();
+        const int m = stamp.getNCol();
+        const int n = stamp.getNRow();
+        const int step = stamp.getStep();
+        const int stride = stamp.getStride();
+        const int os = _oversample;
+        const int nw = 2*_n+2;
+
+        // Atlas position of the first stamp pixel.  Every other pixel is an integer number of
+        // atlas pixels away from it, so they all have the same sub-pixel phase.
+        const double xa = _x0 + (xmin - x0) * os;
+        const double ya = _y0 + (ymin - y0) * os;
+        const int ia0 = int(std::floor(xa));
+        const int ja0 = int(std::floor(ya));
+        std::vector<double> wx, wy;
+        getWeights(xa - ia0, wx);
+        getWeights(ya - ja0, wy);
+        xdbg<<"drawStamp: ia0 = "<<ia0<<", ja0 = "<<ja0<<std::endl;
+
+        // The range of stamp columns whose support is entirely within the stored atlas.
+        // Columns outside this range only see padding.
+        int i1 = 0;
+        while (i1 < m && ia0 + i1*os - _n < 0) ++i1;
+        int i2 = m;
+        while (i2 > i1 && ia0 + (i2-1)*os + _n + 1 >= _nx) --i2;
+
+        // If the supports of neighboring stamp pixels overlap, it's faster to interpolate
+        // a contiguous run of atlas columns in y first and then reuse them in x.
+        const bool contiguous = os < nw;
+        const int c1 = ia0 + i1*os - _n;
+        const int nc = (i2 > i1) ? (i2-1-i1)*os + nw : 0;
+        std::vector<double> tmp(contiguous ? nc : nw);
+
+        const double fscale = flux * os * os;
+        T* ptr = stamp.getData();
+        for (int j=0; j<n; ++j, ptr += stride) {
+            T* p = ptr;
+            const int jb = ja0 + j*os;
+            if (jb - _n < 0 || jb + _n + 1 >= _ny || i2 <= i1) {
+                for (int i=0; i<m; ++i, p+=step) *p = T(0);
+                continue;
+            }
+            const double* rows = &_data[size_t(jb - _n) * _nx];
+            int i=0;
+            for (; i<i1; ++i, p+=step) *p = T(0);
+            if (contiguous) {
+                const double* r = rows + c1;
+                for (int c=0; c<nc; ++c) tmp[c] = wy[0] * r[c];
+                for (int l=1; l<nw; ++l) {
+                    r += _nx;
+                    const double w = wy[l];
+                    for (int c=0; c<nc; ++c) tmp[c] += w * r[c];
+                }
+                for (; i<i2; ++i, p+=step) {
+                    const double* t = &tmp[(i-i1)*os];
+                    double sum = 0.;
+                    for (int k=0; k<nw; ++k) sum += wx[k] * t[k];
+                    *p = T(fscale * sum);
+                }
+            } else {
+                for (; i<i2; ++i, p+=step) {
+                    const double* r = rows + ia0 + i*os - _n;
+                    for (int k=0; k<nw; ++k) tmp[k] = wy[0] * r[k];
+                    for (int l=1; l<nw; ++l) {
+                        r += _nx;
+                        const double w = wy[l];
+                        for (int k=0; k<nw; ++k) tmp[k] += w * r[k];
+                    }
+                    double sum = 0.;
+                    for (int k=0; k<nw; ++k) sum += wx[k] * tmp[k];
+                    *p = T(fscale * sum);
+                }
+            }
+            for (; i<m; ++i, p+=step) *p = T(0);
+        }
+    }
+
+    template void PSFAtlas::drawStamp(ImageView<float> stamp, double x0, double y0,
+                                      double flux) const;
+    template void PSFAtlas::drawStamp(ImageView<double> stamp, double x0, double y0,
+                                      double flux) const;
+
+}
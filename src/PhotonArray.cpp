@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <numeric>
+#include <vector>
 #include "PhotonArray.h"
 
 namespace galsim {
@@ -41,36 +42,49 @@ namespace galsim {
         _flux = &_vflux[0];
     }
 
-    template <typename T>
-    struct AddImagePhotons
-    {
-        AddImagePhotons(double* x, double* y, double* f,
-                        double maxFlux, BaseDeviate rng) :
-            _x(x), _y(y), _f(f), _maxFlux(maxFlux), _ud(rng), _count(0) {}
-
-        void operator()(T flux, int i, int j)
-        {
-            int N = (std::abs(flux) <= _maxFlux) ? 1 : int(std::ceil(std::abs(flux) / _maxFlux));
-            double fluxPer = double(flux) / N;
-            for (int k=0; k<N; ++k) {
-                double x = i + _ud() - 0.5;
-                double y = j + _ud() - 0.5;
-                _x[_count] = x;
-                _y[_count] = y;
-                _f[_count] = fluxPer;
-                ++_count;
-            }
+    // The number of photons that setFrom uses for a pixel with the given flux.
+    inline int NPhotonsForFlux(double flux, double maxFlux)
+    {
+        double absFlux = std::abs(flux);
+        return (absFlux <= maxFlux) ? 1 : int(std::ceil(absFlux / maxFlux));
+    }
+
+    // Count the photons that setFrom needs for each row of the image.  The returned vector
+    // has length nrow+1 and holds the number of photons before the start of each row, so the
+    // last element is the total number of photons.
+    template <class T>
+    std::vector<long> RowPhotonOffsets(const BaseImage<T>& image, double maxFlux)
+    {
+        const T* data = image.getData();
+        if (!data) return std::vector<long>(1,0);
+
+        const int step = image.getStep();
+        const int stride = image.getStride();
+        const int ncol = image.getNCol();
+        const int nrow = image.getNRow();
+        std::vector<long> offsets(nrow+1, 0);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int j=0; j<nrow; ++j) {
+            const T* ptr = data + ptrdiff_t(j)*stride;
+            long count = 0;
+            for (int i=0; i<ncol; ++i, ptr+=step) count += NPhotonsForFlux(*ptr, maxFlux);
+            offsets[j+1] = count;
         }
+        for (int j=0; j<nrow; ++j) offsets[j+1] += offsets[j];
+        return offsets;
+    }
 
-        int getCount() const { return _count; }
+    template <class T>
+    int PhotonArray::countFrom(const BaseImage<T>& image, double maxFlux)
+    {
+        return RowPhotonOffsets(image, maxFlux).back();
+    }
 
-        double* _x;
-        double* _y;
-        double* _f;
-        const double _maxFlux;
-        UniformDeviate _ud;
-        int _count;
-    };
+    // The maximum number of photons to make in each block of rows in setFrom.  This limits
+    // the size of the temporary array of uniform deviates.
+    static const long SET_FROM_BLOCK_SIZE = 1<<20;
 
     template <class T>
     int PhotonArray::setFrom(const BaseImage<T>& image, double maxFlux, BaseDeviate rng)
@@ -78,11 +92,62 @@ namespace galsim {
         dbg<<"bounds = "<<image.getBounds()<<std::endl;
         dbg<<"maxflux = "<<maxFlux<<std::endl;
         dbg<<"photon array size = "<<this->size()<<std::endl;
-        AddImagePhotons<T> adder(_x, _y, _flux, maxFlux, rng);
-        for_each_pixel_ij_ref(image, adder);
-        dbg<<"Done: size = "<<adder.getCount()<<std::endl;
-        assert(adder.getCount() <= _N);  // Else we've overrun the photon's arrays.
-        _N = adder.getCount();
+
+        // First pass: count the photons in each row, so we know exactly where each row's
+        // photons go in the output arrays.
+        std::vector<long> offsets = RowPhotonOffsets(image, maxFlux);
+        const int nrow = offsets.size()-1;
+        const long Ntot = offsets.back();
+        dbg<<"Ntot = "<<Ntot<<std::endl;
+        if (Ntot > _N)
+            throw std::runtime_error("PhotonArray::setFrom: array is too small for image");
+
+        // Second pass: fill in the photons.  Each photon uses two uniform deviates (x then y),
+        // taken in the order the photons are stored.  We generate these in bulk for a block of
+        // rows at a time, which lets the rows be filled in parallel while giving the same
+        // result as drawing the deviates one photon at a time.
+        const T* data = image.getData();
+        const int step = image.getStep();
+        const int stride = image.getStride();
+        const int ncol = image.getNCol();
+        const int xmin = image.getXMin();
+        const int ymin = image.getYMin();
+        UniformDeviate ud(rng);
+        std::vector<double> u;
+        int j1 = 0;
+        while (j1 < nrow) {
+            int j2 = j1+1;
+            while (j2 < nrow && offsets[j2+1] - offsets[j1] <= SET_FROM_BLOCK_SIZE) ++j2;
+            const long nblock = offsets[j2] - offsets[j1];
+            if (nblock > 0) {
+                u.resize(2*nblock);
+                ud.generate(2*nblock, u.data());
+            }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int j=j1; j<j2; ++j) {
+                const T* ptr = data + ptrdiff_t(j)*stride;
+                long k = offsets[j];
+                // A row with no photons at the end of the block starts at u.size(), so use
+                // pointer arithmetic rather than indexing past the end.
+                const double* uptr = u.data() + 2*(k-offsets[j1]);
+                const int y = ymin + j;
+                for (int i=0; i<ncol; ++i, ptr+=step) {
+                    const int N = NPhotonsForFlux(*ptr, maxFlux);
+                    const double fluxPer = double(*ptr) / N;
+                    const int x = xmin + i;
+                    for (int m=0; m<N; ++m, ++k) {
+                        _x[k] = x + *uptr++ - 0.5;
+                        _y[k] = y + *uptr++ - 0.5;
+                        _flux[k] = fluxPer;
+                    }
+                }
+            }
+            j1 = j2;
+        }
+        dbg<<"Done: size = "<<Ntot<<std::endl;
+        _N = Ntot;
         return _N;
     }
 
@@ -117,6 +182,65 @@ namespace galsim {
         std::transform(_y, _y+_N, _y, Scaler(scale));
     }
 
+    // Apply the 2x2 matrix [(mA mB), (mC mD)] in place to the vectors (u[i],v[i]).
+    static void ApplyMatrix(double* u, double* v, int N,
+                            double mA, double mB, double mC, double mD)
+    {
+        if (mB == 0. && mC == 0.) {
+            if (mA == 1. && mD == 1.) return;
+            if (mA == mD) {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+                for (int i=0; i<N; ++i) {
+                    u[i] *= mA;
+                    v[i] *= mA;
+                }
+            } else {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+                for (int i=0; i<N; ++i) {
+                    u[i] *= mA;
+                    v[i] *= mD;
+                }
+            }
+        } else {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+            for (int i=0; i<N; ++i) {
+                double ui = u[i];
+                double vi = v[i];
+                u[i] = mA*ui + mB*vi;
+                v[i] = mC*ui + mD*vi;
+            }
+        }
+    }
+
+    void PhotonArray::transform(double mA, double mB, double mC, double mD,
+                                double dx, double dy, double fluxScale)
+    {
+        const int N = _N;
+        ApplyMatrix(_x, _y, N, mA, mB, mC, mD);
+        if (hasAllocatedAngles()) ApplyMatrix(_dxdz, _dydz, N, mA, mB, mC, mD);
+        if (dx != 0. || dy != 0.) {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+            for (int i=0; i<N; ++i) {
+                _x[i] += dx;
+                _y[i] += dy;
+            }
+        }
+        if (fluxScale != 1.) {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+            for (int i=0; i<N; ++i) _flux[i] *= fluxScale;
+        }
+    }
+
     void PhotonArray::assignAt(int istart, const PhotonArray& rhs)
     {
         if (istart + rhs.size() > size())
@@ -169,30 +293,45 @@ namespace galsim {
         UniformDeviate ud(rng);
         if (rhs.size() != size())
             throw std::runtime_error("PhotonArray::convolve with unequal size arrays");
-        double xSave=0.;
-        double ySave=0.;
-        double fluxSave=0.;
+        if (_N == 0) return;
+
+        // Draw all the deviates we need at once.  generate() does this in parallel when
+        // OpenMP is available, but the values are the same as N successive calls to ud().
+        std::vector<double> u(_N);
+        ud.generate(_N, u.data());
 
-        for (int iOut = _N-1; iOut>=0; iOut--) {
+        // Build the shuffle as a permutation of indices rather than moving the x,y,flux values
+        // around in place.  This consumes the deviates in the same order as the in-place
+        // backward shuffle, so the result is identical, but the random access is confined to
+        // a compact int array.
+        //
+        // The shuffle itself stays serial.  Each swap depends on the ones before it, and the
+        // parallel shuffle algorithms produce a different permutation for the same deviates,
+        // which would change the photons for a given seed.  The swaps only touch the int
+        // array, so this loop is a small part of the total time compared with the gather below.
+        std::vector<int> perm(_N);
+        for (int i=0; i<_N; ++i) perm[i] = i;
+        for (int iOut=_N-1, k=0; iOut>=0; --iOut, ++k) {
             // Randomly select an input photon to use at this output
             // NB: don't need floor, since rhs is positive, so floor is superfluous.
-            int iIn = int((iOut+1)*ud());
+            int iIn = int((iOut+1)*u[k]);
             if (iIn > iOut) iIn=iOut;  // should not happen, but be safe
-            if (iIn < iOut) {
-                // Save input information
-                xSave = _x[iOut];
-                ySave = _y[iOut];
-                fluxSave = _flux[iOut];
-            }
-            _x[iOut] = _x[iIn] + rhs._x[iOut];
-            _y[iOut] = _y[iIn] + rhs._y[iOut];
-            _flux[iOut] = _flux[iIn] * rhs._flux[iOut] * _N;
-            if (iIn < iOut) {
-                // Move saved info to new location in array
-                _x[iIn] = xSave;
-                _y[iIn] = ySave ;
-                _flux[iIn] = fluxSave;
-            }
+            std::swap(perm[iIn], perm[iOut]);
+        }
+
+        // Now the convolution itself is a straight gather, which we can do in parallel.
+        std::vector<double> xSave(_x, _x+_N);
+        std::vector<double> ySave(_y, _y+_N);
+        std::vector<double> fluxSave(_flux, _flux+_N);
+        const int N = _N;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int i=0; i<N; ++i) {
+            const int j = perm[i];
+            _x[i] = xSave[j] + rhs._x[i];
+            _y[i] = ySave[j] + rhs._y[i];
+            _flux[i] = fluxSave[j] * rhs._flux[i] * N;
         }
     }
 
@@ -225,4 +364,6 @@ namespace galsim {
                                       BaseDeviate rng);
     template int PhotonArray::setFrom(const BaseImage<double>& image, double maxFlux,
                                       BaseDeviate rng);
+    template int PhotonArray::countFrom(const BaseImage<float>& image, double maxFlux);
+    template int PhotonArray::countFrom(const BaseImage<double>& image, double maxFlux);
 }
@@ -19,7 +19,7 @@
 
 //#define DEBUGLOGGING
 
-#include "SBProfile.h"
+#include "SBConvolve.h"
 #include "integ/Int.h"
 #include "Solve.h"
 
@@ -30,6 +30,7 @@
 #endif
 
 #include <numeric>
+#include <exception>
 
 namespace galsim {
 
@@ -47,6 +48,23 @@ namespace galsim {
             xdbg<<"Value = "<<v1<<" * "<<v2<<" = "<<v1*v2<<std::endl;
             return v1*v2;
         }
+
+        // The batched version used by int2d for the inner integral over y.
+        void evalMany(double x, const double* y, double* f, int n) const
+        {
+            // The GKP levels have at most a few dozen points, so use stack arrays.
+            const int nchunk = 64;
+            double x1[nchunk], x2[nchunk], y2[nchunk], v2[nchunk];
+            const int nx = std::min(nchunk, n);
+            for (int i=0; i<nx; ++i) { x1[i] = x; x2[i] = _pos.x-x; }
+            for (int i0=0; i0<n; i0+=nchunk) {
+                const int m = std::min(nchunk, n-i0);
+                for (int i=0; i<m; ++i) y2[i] = _pos.y-y[i0+i];
+                _p1.xValueMany(x1, y+i0, f+i0, m);
+                _p2.xValueMany(x2, y2, v2, m);
+                for (int i=0; i<m; ++i) f[i0+i] *= v2[i];
+            }
+        }
     private:
         const SBProfile& _p1;
         const SBProfile& _p2;
@@ -250,65 +268,87 @@ namespace galsim {
         }
     }
 
-    double RealSpaceConvolve(
-        const SBProfile& p1, const SBProfile& p2, const Position<double>& pos, double flux,
-        const GSParams& gsparams)
+    // The parts of the calculation that don't depend on the position: the x and y ranges
+    // of the two profiles and their split points.  When drawing an image, these are found
+    // once and then reused for every pixel.
+    class RealSpaceConvolver
     {
-        // Coming in, if only one of them is axisymmetric, it should be p1.
-        // This cuts down on some of the logic below.
-        // Furthermore, the calculation of xmin, xmax isn't optimal if both are
-        // axisymmetric.  But that involves a bit of geometry to get the right cuts,
-        // so I didn't bother, since I don't think we'll be doing that too often.
-        // So p2 is always taken to be a rectangle rather than possibly a circle.
-        assert(p1.isAxisymmetric() || !p2.isAxisymmetric());
+    public:
+        RealSpaceConvolver(const SBProfile& p1, const SBProfile& p2, double flux,
+                           const GSParams& gsparams) :
+            _p1(p1), _p2(p2), _flux(flux), _gsparams(gsparams)
+        {
+            // Coming in, if only one of them is axisymmetric, it should be p1.
+            // This cuts down on some of the logic below.
+            // Furthermore, the calculation of xmin, xmax isn't optimal if both are
+            // axisymmetric.  But that involves a bit of geometry to get the right cuts,
+            // so I didn't bother, since I don't think we'll be doing that too often.
+            // So p2 is always taken to be a rectangle rather than possibly a circle.
+            assert(p1.isAxisymmetric() || !p2.isAxisymmetric());
+
+            p1.getXRange(_xmin1,_xmax1,_xsplits1);
+            p2.getXRange(_xmin2,_xmax2,_xsplits2);
+            dbg<<"p1 X range = "<<_xmin1<<"  "<<_xmax1<<std::endl;
+            dbg<<"p2 X range = "<<_xmin2<<"  "<<_xmax2<<std::endl;
+
+            std::vector<double> ysplits1, ysplits2;
+            p1.getYRange(_ymin1,_ymax1,ysplits1);
+            p2.getYRange(_ymin2,_ymax2,ysplits2);
+            dbg<<"p1 Y range = "<<_ymin1<<"  "<<_ymax1<<std::endl;
+            dbg<<"p2 Y range = "<<_ymin2<<"  "<<_ymax2<<std::endl;
+        }
+
+        double operator()(const Position<double>& pos) const;
+
+    private:
+        const SBProfile& _p1;
+        const SBProfile& _p2;
+        double _flux;
+        const GSParams& _gsparams;
+        double _xmin1, _xmax1, _xmin2, _xmax2;
+        double _ymin1, _ymax1, _ymin2, _ymax2;
+        std::vector<double> _xsplits1, _xsplits2;
+    };
 
+    double RealSpaceConvolver::operator()(const Position<double>& pos) const
+    {
         dbg<<"Start RealSpaceConvolve for pos = "<<pos<<std::endl;
-        double xmin1, xmax1, xmin2, xmax2;
-        std::vector<double> xsplits1, xsplits2;
-        p1.getXRange(xmin1,xmax1,xsplits1);
-        p2.getXRange(xmin2,xmax2,xsplits2);
-        dbg<<"p1 X range = "<<xmin1<<"  "<<xmax1<<std::endl;
-        dbg<<"p2 X range = "<<xmin2<<"  "<<xmax2<<std::endl;
+        const SBProfile& p1 = _p1;
+        const SBProfile& p2 = _p2;
 
         // Check for early exit
-        if (pos.x < xmin1 + xmin2 || pos.x > xmax1 + xmax2) {
+        if (pos.x < _xmin1 + _xmin2 || pos.x > _xmax1 + _xmax2) {
             dbg<<"x is outside range, so trivially 0\n";
             return 0;
         }
 
-        double ymin1, ymax1, ymin2, ymax2;
-        std::vector<double> ysplits1, ysplits2;
-        p1.getYRange(ymin1,ymax1,ysplits1);
-        p2.getYRange(ymin2,ymax2,ysplits2);
-        dbg<<"p1 Y range = "<<ymin1<<"  "<<ymax1<<std::endl;
-        dbg<<"p2 Y range = "<<ymin2<<"  "<<ymax2<<std::endl;
         // Second check for early exit
-        if (pos.y < ymin1 + ymin2 || pos.y > ymax1 + ymax2) {
+        if (pos.y < _ymin1 + _ymin2 || pos.y > _ymax1 + _ymax2) {
             dbg<<"y is outside range, so trivially 0\n";
             return 0;
         }
 
-        double xmin = std::max(xmin1, pos.x - xmax2);
-        double xmax = std::min(xmax1, pos.x - xmin2);
+        double xmin = std::max(_xmin1, pos.x - _xmax2);
+        double xmax = std::min(_xmax1, pos.x - _xmin2);
         xdbg<<"xmin..xmax = "<<xmin<<" ... "<<xmax<<std::endl;
 
         // Consolidate the splits from each profile in to a single list to use.
         std::vector<double> xsplits;
-        for(size_t k=0;k<xsplits1.size();++k) {
-            double s = xsplits1[k];
+        for(size_t k=0;k<_xsplits1.size();++k) {
+            double s = _xsplits1[k];
             xdbg<<"p1 has split at "<<s<<std::endl;
             if (s > xmin && s < xmax) xsplits.push_back(s);
         }
-        for(size_t k=0;k<xsplits2.size();++k) {
-            double s = pos.x-xsplits2[k];
-            xdbg<<"p2 has split at "<<xsplits2[k]<<", which is really (pox.x-s) "<<s<<std::endl;
+        for(size_t k=0;k<_xsplits2.size();++k) {
+            double s = pos.x-_xsplits2[k];
+            xdbg<<"p2 has split at "<<_xsplits2[k]<<", which is really (pox.x-s) "<<s<<std::endl;
             if (s > xmin && s < xmax) xsplits.push_back(s);
         }
 
         // If either profile is infinite, then we don't need to worry about any boundary
         // overlaps, so can skip this section.
-        if ( (xmin1 == -integ::MOCK_INF || xmax2 == integ::MOCK_INF) &&
-             (xmax1 == integ::MOCK_INF || xmin2 == -integ::MOCK_INF) ) {
+        if ( (_xmin1 == -integ::MOCK_INF || _xmax2 == integ::MOCK_INF) &&
+             (_xmax1 == integ::MOCK_INF || _xmin2 == -integ::MOCK_INF) ) {
 
             // Update the xmin and xmax values if the top of one profile crosses through
             // the bottom of the other.  Then part of the nominal range will in fact
@@ -363,8 +403,8 @@ namespace galsim {
 #endif
 
         double result = integ::int2d(conv, xreg, yreg,
-                                     gsparams.realspace_relerr,
-                                     gsparams.realspace_abserr * flux);
+                                     _gsparams.realspace_relerr,
+                                     _gsparams.realspace_abserr * _flux);
 
 #ifdef TIMING
         gettimeofday(&tp,0);
@@ -376,4 +416,66 @@ namespace galsim {
         return result;
     }
 
+    double RealSpaceConvolve(
+        const SBProfile& p1, const SBProfile& p2, const Position<double>& pos, double flux,
+        const GSParams& gsparams)
+    {
+        return RealSpaceConvolver(p1,p2,flux,gsparams)(pos);
+    }
+
+    template <typename T>
+    void RealSpaceConvolve(
+        const SBProfile& p1, const SBProfile& p2, ImageView<T> im,
+        double x0, double dx, double dxy, double y0, double dy, double dyx,
+        double flux, const GSParams& gsparams)
+    {
+        dbg<<"Start RealSpaceConvolve image\n";
+        dbg<<"x = "<<x0<<" + i * "<<dx<<" + j * "<<dxy<<std::endl;
+        dbg<<"y = "<<y0<<" + i * "<<dyx<<" + j * "<<dy<<std::endl;
+        const int m = im.getNCol();
+        const int n = im.getNRow();
+        if (m <= 0 || n <= 0) return;
+        T* data = im.getData();
+        const int stride = im.getStride();
+        assert(im.getStep() == 1);
+
+        RealSpaceConvolver conv(p1,p2,flux,gsparams);
+
+        // Do the first pixel on its own, so any lazy initialization in the profiles is done
+        // before the threads start.  Then each pixel is an independent integral, so do the
+        // rows in parallel.  The time per row varies a lot, so use dynamic scheduling.
+        data[0] = conv(Position<double>(x0,y0));
+
+        std::exception_ptr eptr;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,1)
+#endif
+        for (int j=0; j<n; ++j) {
+            try {
+                T* ptr = data + j*stride;
+                double x = x0 + j*dxy;
+                double y = y0 + j*dy;
+                int i=0;
+                if (j == 0) { ++ptr; ++i; x += dx; y += dyx; }
+                for (; i<m; ++i,x+=dx,y+=dyx)
+                    *ptr++ = conv(Position<double>(x,y));
+            } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical (RealSpaceConvolve)
+#endif
+                eptr = std::current_exception();
+            }
+        }
+        if (eptr) std::rethrow_exception(eptr);
+    }
+
+    template void RealSpaceConvolve(
+        const SBProfile& p1, const SBProfile& p2, ImageView<double> im,
+        double x0, double dx, double dxy, double y0, double dy, double dyx,
+        double flux, const GSParams& gsparams);
+    template void RealSpaceConvolve(
+        const SBProfile& p1, const SBProfile& p2, ImageView<float> im,
+        double x0, double dx, double dxy, double y0, double dy, double dyx,
+        double flux, const GSParams& gsparams);
+
 }
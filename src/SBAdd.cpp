@@ -19,6 +19,8 @@
 
 //#define DEBUGLOGGING
 
+#include <exception>
+
 #include "SBAdd.h"
 #include "SBAddImpl.h"
 
@@ -113,6 +115,34 @@ namespace galsim {
         return kv;
     }
 
+    void SBAdd::SBAddImpl::xValueMany(const double* x, const double* y, double* val,
+                                      int N) const
+    {
+        ConstIter pptr = _plist.begin();
+        assert(pptr != _plist.end());
+        pptr->xValueMany(x, y, val, N);
+        if (++pptr == _plist.end()) return;
+        std::vector<double> tmp(N);
+        for (; pptr != _plist.end(); ++pptr) {
+            pptr->xValueMany(x, y, &tmp[0], N);
+            for (int i=0; i<N; ++i) val[i] += tmp[i];
+        }
+    }
+
+    void SBAdd::SBAddImpl::kValueMany(const double* kx, const double* ky,
+                                      std::complex<double>* val, int N) const
+    {
+        ConstIter pptr = _plist.begin();
+        assert(pptr != _plist.end());
+        pptr->kValueMany(kx, ky, val, N);
+        if (++pptr == _plist.end()) return;
+        std::vector<std::complex<double> > tmp(N);
+        for (; pptr != _plist.end(); ++pptr) {
+            pptr->kValueMany(kx, ky, &tmp[0], N);
+            for (int i=0; i<N; ++i) val[i] += tmp[i];
+        }
+    }
+
     template <typename T>
     void SBAdd::SBAddImpl::fillXImage(ImageView<T> im,
                                       double x0, double dx, int izero,
@@ -219,12 +249,20 @@ namespace galsim {
         double totalAbsoluteFlux = getPositiveFlux() + getNegativeFlux();
         double fluxPerPhoton = totalAbsoluteFlux / N;
 
+        // Decide how many photons to shoot from each summand, using BinomialDeviate to
+        // randomize distribution of photons among summands.  (This is a multinomial draw.)
+        //
+        // We then give each summand its own rng, seeded from ud, so the summands can be shot
+        // concurrently.  The seeds don't depend on the number of threads, so the photons are the
+        // same for a given ud however many threads are used, including just one.
+        std::vector<const SBProfile*> objs;
+        std::vector<int> nphot;
+        std::vector<int> starts;
+        std::vector<double> fluxScales;
+        std::vector<long> seeds;
         double remainingAbsoluteFlux = totalAbsoluteFlux;
         int remainingN = N;
         int istart = 0;  // The location in the result array where we assign the component arrays.
-
-        // Get photons from each summand, using BinomialDeviate to
-        // randomize distribution of photons among summands
         for (ConstIter pptr = _plist.begin(); pptr!= _plist.end(); ++pptr) {
             double thisAbsoluteFlux = pptr->getPositiveFlux() + pptr->getNegativeFlux();
 
@@ -238,13 +276,13 @@ namespace galsim {
                 thisN = bd();
             }
             if (thisN > 0) {
-                PhotonArray thisPA(thisN);
-                pptr->shoot(thisPA, ud);
-                // Now rescale the photon fluxes so that they are each nominally fluxPerPhoton
-                // whereas the shoot() routine would have made them each nominally
+                // We need to rescale the photon fluxes so that they are each nominally
+                // fluxPerPhoton whereas the shoot() routine would have made them each nominally
                 // thisAbsoluteFlux/thisN
-                thisPA.scaleFlux(fluxPerPhoton*thisN/thisAbsoluteFlux);
-                photons.assignAt(istart, thisPA);
+                objs.push_back(&*pptr);
+                nphot.push_back(thisN);
+                starts.push_back(istart);
+                fluxScales.push_back(fluxPerPhoton*thisN/thisAbsoluteFlux);
                 istart += thisN;
             }
             remainingN -= thisN;
@@ -252,6 +290,33 @@ namespace galsim {
             if (remainingN <=0) break;
             if (remainingAbsoluteFlux <= 0.) break;
         }
+        const int ncomp = objs.size();
+        // Build any lazily constructed state (e.g. photon samplers in shared infos) now, so
+        // the summands' shoot functions don't race to do it.
+        for (int i=0; i<ncomp; ++i) GetImpl(*objs[i])->prepareShoot();
+        // NB. Add 1 to the seeds to avoid 0, which would mean to seed from the system.
+        for (int i=0; i<ncomp; ++i) seeds.push_back(ud.raw() + 1);
+
+        // Now shoot the summands.  They each go into a separate range of the output array, so
+        // this is safe to do in parallel.
+        std::exception_ptr eptr;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,1) if (ncomp > 1)
+#endif
+        for (int i=0; i<ncomp; ++i) {
+            try {
+                PhotonArray thisPA(nphot[i]);
+                objs[i]->shoot(thisPA, UniformDeviate(seeds[i]));
+                thisPA.scaleFlux(fluxScales[i]);
+                photons.assignAt(starts[i], thisPA);
+            } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical (SBAdd_shoot)
+#endif
+                eptr = std::current_exception();
+            }
+        }
+        if (eptr) std::rethrow_exception(eptr);
 
         dbg<<"Add Realized flux = "<<photons.getTotalFlux()<<std::endl;
 
@@ -259,4 +324,10 @@ namespace galsim {
         if (_plist.size() > 1) photons.setCorrelated();
     }
 
+    void SBAdd::SBAddImpl::prepareShoot() const
+    {
+        for (ConstIter pptr = _plist.begin(); pptr != _plist.end(); ++pptr)
+            GetImpl(*pptr)->prepareShoot();
+    }
+
 }
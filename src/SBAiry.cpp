@@ -80,7 +80,8 @@ namespace galsim {
         xdbg<<"SBAiryImpl constructor: gsparams = "<<gsparams<<std::endl;
     }
 
-    LRUCache<Tuple<double, GSParamsPtr>, AiryInfo> SBAiry::SBAiryImpl::cache(sbp::max_airy_cache);
+    LRUCache<Tuple<double, GSParamsPtr>, AiryInfo> SBAiry::SBAiryImpl::cache(
+        "Airy", sbp::max_airy_cache);
 
     // This is a scale-free version of the Airy radial function.
     // Input radius is in units of lambda/D.  Output normalized
@@ -369,6 +370,11 @@ namespace galsim {
         _sampler->shoot(photons, ud);
     }
 
+    size_t AiryInfo::getMemorySize() const
+    {
+        return sizeof(*this) + (_sampler ? _sampler->getMemorySize() : 0);
+    }
+
     void AiryInfoObs::checkSampler() const
     {
         if (this->_sampler.get()) return;
@@ -386,6 +392,7 @@ namespace galsim {
         ranges.reserve(int((rmax-rmin+2)/0.5+0.5));
         for(double r=rmin; r<=rmax; r+=0.5) ranges.push_back(r);
         this->_sampler.reset(new OneDimensionalDeviate(_radial, ranges, true, 1.0, *_gsparams));
+        this->addMemory(this->_sampler->getMemorySize());
     }
 
     // Now the specializations for when obs = 0
@@ -456,5 +463,6 @@ namespace galsim {
         ranges.reserve(int((rmax-rmin+2)/0.5+0.5));
         for(double r=rmin; r<=rmax; r+=0.5) ranges.push_back(r);
         this->_sampler.reset(new OneDimensionalDeviate(_radial, ranges, true, 1.0, *_gsparams));
+        this->addMemory(this->_sampler->getMemorySize());
     }
 }
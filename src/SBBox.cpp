@@ -71,6 +71,13 @@ namespace galsim {
         else return 0.;  // do not use this function for filling image!
     }
 
+    void SBBox::SBBoxImpl::xValueMany(const double* x, const double* y, double* val,
+                                      int N) const
+    {
+        for (int i=0; i<N; ++i)
+            val[i] = (std::abs(x[i]) < _wo2 && std::abs(y[i]) < _ho2) ? _norm : 0.;
+    }
+
     std::complex<double> SBBox::SBBoxImpl::kValue(const Position<double>& k) const
     {
         return _flux * math::sinc(k.x*_wo2pi)*math::sinc(k.y*_ho2pi);
@@ -280,6 +287,13 @@ namespace galsim {
         else return 0.;
     }
 
+    void SBTopHat::SBTopHatImpl::xValueMany(const double* x, const double* y, double* val,
+                                            int N) const
+    {
+        for (int i=0; i<N; ++i)
+            val[i] = (x[i]*x[i] + y[i]*y[i] < _r0sq) ? _norm : 0.;
+    }
+
     std::complex<double> SBTopHat::SBTopHatImpl::kValue(const Position<double>& k) const
     {
         double kr0sq = (k.x*k.x + k.y*k.y) * _r0sq;
@@ -19,6 +19,8 @@
 
 //#define DEBUGLOGGING
 
+#include <exception>
+
 #include "SBConvolve.h"
 #include "SBConvolveImpl.h"
 #include "SBTransform.h"
@@ -177,6 +179,71 @@ namespace galsim {
         return kv;
     }
 
+    void SBConvolve::SBConvolveImpl::xValueMany(const double* x, const double* y, double* val,
+                                                int N) const
+    {
+        // Only the single-profile case can pass the arrays along.  Otherwise, each point needs
+        // its own real-space integral.
+        if (_plist.size() == 1)
+            _plist.front().xValueMany(x, y, val, N);
+        else
+            SBProfileImpl::xValueMany(x, y, val, N);
+    }
+
+    void SBConvolve::SBConvolveImpl::kValueMany(const double* kx, const double* ky,
+                                                std::complex<double>* val, int N) const
+    {
+        ConstIter pptr = _plist.begin();
+        assert(pptr != _plist.end());
+        pptr->kValueMany(kx, ky, val, N);
+        if (++pptr == _plist.end()) return;
+        std::vector<std::complex<double> > tmp(N);
+        for (; pptr != _plist.end(); ++pptr) {
+            pptr->kValueMany(kx, ky, &tmp[0], N);
+            for (int i=0; i<N; ++i) val[i] *= tmp[i];
+        }
+    }
+
+    template <typename T>
+    void SBConvolve::SBConvolveImpl::fillXImage(ImageView<T> im,
+                                                double x0, double dx, int izero,
+                                                double y0, double dy, int jzero) const
+    {
+        dbg<<"SBConvolve fillXImage\n";
+        dbg<<"x = "<<x0<<" + i * "<<dx<<", izero = "<<izero<<std::endl;
+        dbg<<"y = "<<y0<<" + j * "<<dy<<", jzero = "<<jzero<<std::endl;
+        if (_plist.size() == 1)
+            GetImpl(_plist.front())->fillXImage(im,x0,dx,izero,y0,dy,jzero);
+        else if ((izero != 0 || jzero != 0) && isAxisymmetric())
+            fillXImageQuadrant(im,x0,dx,izero,y0,dy,jzero);
+        else
+            fillXImage(im,x0,dx,0.,y0,dy,0.);
+    }
+
+    template <typename T>
+    void SBConvolve::SBConvolveImpl::fillXImage(ImageView<T> im,
+                                                double x0, double dx, double dxy,
+                                                double y0, double dy, double dyx) const
+    {
+        dbg<<"SBConvolve fillXImage\n";
+        dbg<<"x = "<<x0<<" + i * "<<dx<<" + j * "<<dxy<<std::endl;
+        dbg<<"y = "<<y0<<" + i * "<<dyx<<" + j * "<<dy<<std::endl;
+        // As in xValue, only 2 profiles can be convolved in real space.  The image version
+        // of RealSpaceConvolve shares the setup across pixels and runs them in parallel.
+        if (_plist.size() == 2) {
+            const SBProfile& p1 = _plist.front();
+            const SBProfile& p2 = _plist.back();
+            if (p2.isAxisymmetric())
+                RealSpaceConvolve(p2,p1,im,x0,dx,dxy,y0,dy,dyx,_fluxProduct,this->gsparams);
+            else
+                RealSpaceConvolve(p1,p2,im,x0,dx,dxy,y0,dy,dyx,_fluxProduct,this->gsparams);
+        } else if (_plist.size() == 1) {
+            GetImpl(_plist.front())->fillXImage(im,x0,dx,dxy,y0,dy,dyx);
+        } else {
+            defaultFillXImage(im,x0,dx,dxy,y0,dy,dyx);
+        }
+    }
+
     template <typename T>
     void SBConvolve::SBConvolveImpl::fillKImage(ImageView<std::complex<T> > im,
                                                 double kx0, double dkx, int izero,
@@ -188,13 +255,10 @@ namespace galsim {
         ConstIter pptr = _plist.begin();
         assert(pptr != _plist.end());
         GetImpl(*pptr)->fillKImage(im,kx0,dkx,izero,ky0,dky,jzero);
-        if (++pptr != _plist.end()) {
-            ImageAlloc<std::complex<T> > im2(im.getBounds());
-            for (; pptr != _plist.end(); ++pptr) {
-                GetImpl(*pptr)->fillKImage(im2.view(),kx0,dkx,izero,ky0,dky,jzero);
-                im *= im2;
-            }
-        }
+        // The rest multiply their values directly into im, rather than each filling a
+        // full-sized temporary image.
+        for (++pptr; pptr != _plist.end(); ++pptr)
+            GetImpl(*pptr)->multiplyKImage(im,kx0,dkx,izero,ky0,dky,jzero);
     }
 
     template <typename T>
@@ -208,13 +272,28 @@ namespace galsim {
         ConstIter pptr = _plist.begin();
         assert(pptr != _plist.end());
         GetImpl(*pptr)->fillKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx);
-        if (++pptr != _plist.end()) {
-            ImageAlloc<std::complex<T> > im2(im.getBounds());
-            for (; pptr != _plist.end(); ++pptr) {
-                GetImpl(*pptr)->fillKImage(im2.view(),kx0,dkx,dkxy,ky0,dky,dkyx);
-                im *= im2;
-            }
-        }
+        for (++pptr; pptr != _plist.end(); ++pptr)
+            GetImpl(*pptr)->multiplyKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx);
+    }
+
+    template <typename T>
+    void SBConvolve::SBConvolveImpl::multiplyKImage(ImageView<std::complex<T> > im,
+                                                    double kx0, double dkx, int izero,
+                                                    double ky0, double dky, int jzero) const
+    {
+        dbg<<"SBConvolve multiplyKImage\n";
+        for (ConstIter pptr = _plist.begin(); pptr != _plist.end(); ++pptr)
+            GetImpl(*pptr)->multiplyKImage(im,kx0,dkx,izero,ky0,dky,jzero);
+    }
+
+    template <typename T>
+    void SBConvolve::SBConvolveImpl::multiplyKImage(ImageView<std::complex<T> > im,
+                                                    double kx0, double dkx, double dkxy,
+                                                    double ky0, double dky, double dkyx) const
+    {
+        dbg<<"SBConvolve multiplyKImage\n";
+        for (ConstIter pptr = _plist.begin(); pptr != _plist.end(); ++pptr)
+            GetImpl(*pptr)->multiplyKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx);
     }
 
     double SBConvolve::SBConvolveImpl::getPositiveFlux() const
@@ -255,23 +334,62 @@ namespace galsim {
         const int N = photons.size();
         dbg<<"Convolve shoot: N = "<<N<<std::endl;
         dbg<<"Target flux = "<<getFlux()<<std::endl;
-        std::list<SBProfile>::const_iterator pptr = _plist.begin();
-        if (pptr==_plist.end())
+        if (_plist.empty())
             throw SBError("Cannot shoot() for empty SBConvolve");
-        pptr->shoot(photons, ud);
+
         // It may be necessary to shuffle when convolving because we do
         // do not have a gaurantee that the convolvee's photons are
         // uncorrelated, e.g. they might both have their negative ones
         // at the end.
         // However, this decision is now made by the convolve method.
-        for (++pptr; pptr != _plist.end(); ++pptr) {
-            PhotonArray temp(N);
-            pptr->shoot(temp, ud);
-            photons.convolve(temp, ud);
+
+        // Each factor needs the full N photons.  The first one goes directly into photons, the
+        // rest into temporary arrays.  The factors are independent, so we shoot them
+        // concurrently, each with its own rng seeded from ud.  The seeds don't depend on the
+        // number of threads, so the result is the same for a given ud however many threads are
+        // used.  Any lazily constructed state is built first, so the factors don't race to do it.
+        const int nfact = _plist.size();
+        std::vector<const SBProfile*> objs;
+        std::vector<shared_ptr<PhotonArray> > temps(nfact);
+        std::vector<long> seeds;
+        for (ConstIter pptr = _plist.begin(); pptr != _plist.end(); ++pptr) {
+            objs.push_back(&*pptr);
+            GetImpl(*pptr)->prepareShoot();
+            // NB. Add 1 to the seeds to avoid 0, which would mean to seed from the system.
+            seeds.push_back(ud.raw() + 1);
         }
+
+        std::exception_ptr eptr;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,1) if (nfact > 1)
+#endif
+        for (int i=0; i<nfact; ++i) {
+            try {
+                if (i == 0) {
+                    objs[i]->shoot(photons, UniformDeviate(seeds[i]));
+                } else {
+                    temps[i].reset(new PhotonArray(N));
+                    objs[i]->shoot(*temps[i], UniformDeviate(seeds[i]));
+                }
+            } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical (SBConvolve_shoot)
+#endif
+                eptr = std::current_exception();
+            }
+        }
+        if (eptr) std::rethrow_exception(eptr);
+
+        for (int i=1; i<nfact; ++i) photons.convolve(*temps[i], ud);
         dbg<<"Convolve Realized flux = "<<photons.getTotalFlux()<<std::endl;
     }
 
+    void SBConvolve::SBConvolveImpl::prepareShoot() const
+    {
+        for (ConstIter pptr = _plist.begin(); pptr != _plist.end(); ++pptr)
+            GetImpl(*pptr)->prepareShoot();
+    }
+
     //
     // AutoConvolve
     //
@@ -311,6 +429,30 @@ namespace galsim {
     struct Square
     { T operator()(T x) { return x*x; } };
 
+    template <typename T>
+    void SBAutoConvolve::SBAutoConvolveImpl::fillXImage(ImageView<T> im,
+                                                        double x0, double dx, int izero,
+                                                        double y0, double dy, int jzero) const
+    {
+        dbg<<"SBAutoConvolve fillXImage\n";
+        dbg<<"x = "<<x0<<" + i * "<<dx<<", izero = "<<izero<<std::endl;
+        dbg<<"y = "<<y0<<" + j * "<<dy<<", jzero = "<<jzero<<std::endl;
+        // If the profile is axisymmetric, only one quadrant needs to be convolved.
+        if ((izero != 0 || jzero != 0) && isAxisymmetric())
+            fillXImageQuadrant(im,x0,dx,izero,y0,dy,jzero);
+        else
+            fillXImage(im,x0,dx,0.,y0,dy,0.);
+    }
+
+    template <typename T>
+    void SBAutoConvolve::SBAutoConvolveImpl::fillXImage(ImageView<T> im,
+                                                        double x0, double dx, double dxy,
+                                                        double y0, double dy, double dyx) const
+    {
+        dbg<<"SBAutoConvolve fillXImage\n";
+        RealSpaceConvolve(_adaptee,_adaptee,im,x0,dx,dxy,y0,dy,dyx,getFlux(),this->gsparams);
+    }
+
     template <typename T>
     void SBAutoConvolve::SBAutoConvolveImpl::fillKImage(ImageView<std::complex<T> > im,
                                                         double kx0, double dkx, int izero,
@@ -403,6 +545,32 @@ namespace galsim {
     struct AbsSquare
     { T operator()(T x) { return std::norm(x); } };
 
+    template <typename T>
+    void SBAutoCorrelate::SBAutoCorrelateImpl::fillXImage(ImageView<T> im,
+                                                          double x0, double dx, int izero,
+                                                          double y0, double dy, int jzero) const
+    {
+        dbg<<"SBAutoCorrelate fillXImage\n";
+        dbg<<"x = "<<x0<<" + i * "<<dx<<", izero = "<<izero<<std::endl;
+        dbg<<"y = "<<y0<<" + j * "<<dy<<", jzero = "<<jzero<<std::endl;
+        // If the profile is axisymmetric, only one quadrant needs to be convolved.
+        if ((izero != 0 || jzero != 0) && isAxisymmetric())
+            fillXImageQuadrant(im,x0,dx,izero,y0,dy,jzero);
+        else
+            fillXImage(im,x0,dx,0.,y0,dy,0.);
+    }
+
+    template <typename T>
+    void SBAutoCorrelate::SBAutoCorrelateImpl::fillXImage(ImageView<T> im,
+                                                          double x0, double dx, double dxy,
+                                                          double y0, double dy, double dyx) const
+    {
+        dbg<<"SBAutoCorrelate fillXImage\n";
+        // Only make the flipped profile once for the whole image.
+        SBProfile temp = _adaptee.transform(-1., 0., 0., -1.);
+        RealSpaceConvolve(_adaptee,temp,im,x0,dx,dxy,y0,dy,dyx,getFlux(),this->gsparams);
+    }
+
     template <typename T>
     void SBAutoCorrelate::SBAutoCorrelateImpl::fillKImage(ImageView<std::complex<T> > im,
                                                           double kx0, double dkx, int izero,
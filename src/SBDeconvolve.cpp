@@ -68,6 +68,21 @@ namespace galsim {
         }
     }
 
+    void SBDeconvolve::SBDeconvolveImpl::kValueMany(const double* kx, const double* ky,
+                                                    std::complex<double>* val, int N) const
+    {
+        _adaptee.kValueMany(kx, ky, val, N);
+        for (int i=0; i<N; ++i) {
+            double ksq = kx[i]*kx[i] + ky[i]*ky[i];
+            if (ksq > _maxksq)
+                val[i] = 0.;
+            else if (std::abs(val[i]) < _min_acc_kval)
+                val[i] = 1./_min_acc_kval;
+            else
+                val[i] = 1./val[i];
+        }
+    }
+
     template <typename T>
     void SBDeconvolve::SBDeconvolveImpl::fillKImage(ImageView<std::complex<T> > im,
                                                     double kx0, double dkx, int izero,
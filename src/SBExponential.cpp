@@ -59,7 +59,7 @@ namespace galsim {
     }
 
     LRUCache<GSParamsPtr, ExponentialInfo> SBExponential::SBExponentialImpl::cache(
-        sbp::max_exponential_cache);
+        "Exponential", sbp::max_exponential_cache);
 
     SBExponential::SBExponentialImpl::SBExponentialImpl(
         double r0, double flux, const GSParams& gsparams) :
@@ -115,6 +115,27 @@ namespace galsim {
         }
     }
 
+    void SBExponential::SBExponentialImpl::xValueMany(const double* x, const double* y,
+                                                      double* val, int N) const
+    {
+        for (int i=0; i<N; ++i) val[i] = -sqrt(x[i]*x[i] + y[i]*y[i]) * _inv_r0;
+        for (int i=0; i<N; ++i) val[i] = _norm * fmath::expd(val[i]);
+    }
+
+    void SBExponential::SBExponentialImpl::kValueMany(const double* kx, const double* ky,
+                                                      std::complex<double>* val, int N) const
+    {
+        for (int i=0; i<N; ++i) {
+            double ksq = (kx[i]*kx[i] + ky[i]*ky[i])*_r0_sq;
+            if (ksq < _ksq_min) {
+                val[i] = _flux*(1. - 1.5*ksq*(1. - 1.25*ksq));
+            } else {
+                double ksqp1 = 1. + ksq;
+                val[i] = _flux / (ksqp1 * sqrt(ksqp1));
+            }
+        }
+    }
+
     // A helper class for doing the inner loops in the below fill*Image functions.
     // This lets us do type-specific optimizations on just this portion.
     // First the normal (legible) version that we use if there is no SSE support. (HA!)
@@ -560,6 +581,11 @@ namespace galsim {
         dbg<<"ExponentialInfo Realized flux = "<<photons.getTotalFlux()<<std::endl;
     }
 
+    size_t ExponentialInfo::getMemorySize() const
+    {
+        return sizeof(*this) + (_sampler ? _sampler->getMemorySize() : 0);
+    }
+
     void SBExponential::SBExponentialImpl::shoot(PhotonArray& photons, UniformDeviate ud) const
     {
         const int N = photons.size();
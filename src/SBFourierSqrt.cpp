@@ -53,6 +53,13 @@ namespace galsim {
         return std::sqrt(_adaptee.kValue(k));
     }
 
+    void SBFourierSqrt::SBFourierSqrtImpl::kValueMany(const double* kx, const double* ky,
+                                                      std::complex<double>* val, int N) const
+    {
+        _adaptee.kValueMany(kx, ky, val, N);
+        for (int i=0; i<N; ++i) val[i] = std::sqrt(val[i]);
+    }
+
     template <typename T>
     void SBFourierSqrt::SBFourierSqrtImpl::fillKImage(ImageView<std::complex<T> > im,
                                                       double kx0, double dkx, int izero,
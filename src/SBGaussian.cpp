@@ -114,6 +114,28 @@ namespace galsim {
         }
     }
 
+    void SBGaussian::SBGaussianImpl::xValueMany(const double* x, const double* y, double* val,
+                                                int N) const
+    {
+        const double a = -0.5 * _inv_sigma_sq;
+        for (int i=0; i<N; ++i) val[i] = a * (x[i]*x[i] + y[i]*y[i]);
+        for (int i=0; i<N; ++i) val[i] = _norm * fmath::expd(val[i]);
+    }
+
+    void SBGaussian::SBGaussianImpl::kValueMany(const double* kx, const double* ky,
+                                                std::complex<double>* val, int N) const
+    {
+        for (int i=0; i<N; ++i) {
+            double ksq = (kx[i]*kx[i]+ky[i]*ky[i])*_sigma_sq;
+            if (ksq > _ksq_max)
+                val[i] = 0.;
+            else if (ksq < _ksq_min)
+                val[i] = _flux*(1. - 0.5*ksq*(1. - 0.25*ksq));
+            else
+                val[i] = _flux * fmath::expd(-0.5*ksq);
+        }
+    }
+
     template <typename T>
     void SBGaussian::SBGaussianImpl::fillXImage(ImageView<T> im,
                                                 double x0, double dx, int izero,
@@ -103,7 +103,8 @@ namespace galsim {
                                   // get a better value
         // Start with untruncated SersicInfo regardless of value of trunc
         _info(SBSersic::SBSersicImpl::cache.get(MakeTuple(_n, _trunc/_r0,
-                                                          GSParamsPtr(this->gsparams))))
+                                                          GSParamsPtr(this->gsparams),
+                                                          GetSersicInterpolatedFT())))
     {
         dbg<<"Start SBInclinedSersic constructor:\n";
         dbg<<"n = "<<_n<<std::endl;
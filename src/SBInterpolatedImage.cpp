@@ -23,6 +23,9 @@
 #include <map>
 #include <algorithm>
 #include <cstring>  // For memset
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #ifdef __SSE2__
 #include "xmmintrin.h"
 #endif
@@ -214,6 +217,10 @@ namespace galsim {
         return sum;
     }
 
+    // Whether x is (basically) an integer
+    static bool IsInteger(double x, double small)
+    { return std::abs(x-std::floor(x+0.5)) < small*(std::abs(x)+1); }
+
     int WrapKIndex(int k, int No2, int N)
     {
         k = (k + No2) % N;
@@ -250,6 +257,32 @@ namespace galsim {
         static inline T plus(const T& x, const T2& y) { return x-y; }
     };
 
+    // A helper function for fast calculation of a dot product of two real vectors
+    static double DDot(int n, const double* A, const double* B)
+    {
+#ifdef __SSE2__
+        __m128d xsum1 = _mm_set1_pd(0.);
+        __m128d xsum2 = _mm_set1_pd(0.);
+        for (; n >= 4; n -= 4, A += 4, B += 4) {
+            xsum1 = _mm_add_pd(xsum1, _mm_mul_pd(_mm_loadu_pd(A), _mm_loadu_pd(B)));
+            xsum2 = _mm_add_pd(xsum2, _mm_mul_pd(_mm_loadu_pd(A+2), _mm_loadu_pd(B+2)));
+        }
+        if (n >= 2) {
+            xsum1 = _mm_add_pd(xsum1, _mm_mul_pd(_mm_loadu_pd(A), _mm_loadu_pd(B)));
+            n -= 2; A += 2; B += 2;
+        }
+        union { __m128d xm; double xd[2]; } xsum;
+        xsum.xm = _mm_add_pd(xsum1, xsum2);
+        double sum = xsum.xd[0] + xsum.xd[1];
+        if (n > 0) sum += *A * *B;
+        return sum;
+#else
+        double sum = 0.;
+        for (; n > 0; --n) sum += *A++ * *B++;
+        return sum;
+#endif
+    }
+
     // A helper function for fast calculation of a dot product of real and complex vectors
     template <bool c2>
     static std::complex<double> ZDot(int n, const double* A, const std::complex<double>* B)
@@ -462,6 +495,18 @@ namespace galsim {
         dbg<<"kimage flux = "<<(*_kimage)(0,0).real()<<std::endl;
     }
 
+    // The number of contiguous blocks of rows to split an image of nrow rows into for the
+    // threads.  Each block redoes some setup for its first few rows, so make sure every block
+    // has at least min_rows rows, or the duplicated work can cost more than the threads save.
+    static int NumRowBlocks(int nrow, int min_rows)
+    {
+#ifdef _OPENMP
+        return std::max(1, std::min(omp_get_max_threads(), nrow / std::max(min_rows,1)));
+#else
+        return 1;
+#endif
+    }
+
     template <typename T>
     void SBInterpolatedImage::SBInterpolatedImageImpl::fillXImage(
         ImageView<T> im,
@@ -474,7 +519,6 @@ namespace galsim {
         const int m = im.getNCol();
         const int n = im.getNRow();
         T* ptr = im.getData();
-        int skip = im.getNSkip();
         assert(im.getStep() == 1);
         const double SMALL = 10.*std::numeric_limits<double>::epsilon();
 
@@ -507,7 +551,7 @@ namespace galsim {
         xdbg<<"Old i,j ranges = "<<0<<"  "<<m<<"  "<<0<<"  "<<n<<std::endl;
         xdbg<<"New i,j ranges = "<<i1<<"  "<<i2<<"  "<<j1<<"  "<<j2<<std::endl;
 
-        // Fix up x0, y0, ptr, skip to correspond to these i,j ranges.
+        // Fix up x0, y0, ptr to correspond to these i,j ranges.
         x0 += i1*dx;
         y0 += j1*dy;
         if (x0 < minx || x0 > maxx) { x0 += dx; ++i1; } // First points may be able to increase
@@ -521,7 +565,6 @@ namespace galsim {
 
         ptr += i1 + j1*im.getStride();
         int mm = i2-i1;  // We'll need this new row length a few times below.
-        skip += (m - mm);
 
         // Each point in the output image is going to be
         //
@@ -548,18 +591,32 @@ namespace galsim {
         // compute them once and save them.  Furthermore, the complete rowq calculation for
         // a given q is independent of y, so we save that as well.
 
+        // The workspace for the xwt values can be large for wide interpolants (e.g. Lanczos
+        // with large n) on wide images, so keep it on the heap rather than the stack.
+        // xwt is packed, with the values for column i starting at xwt[koff[i-i1]].
+        //
+        // If gsparams.interpolant_phase_tolerance > 0, the weights come from the interpolant's
+        // table of weights at quantized phases, rather than calling xval.
+        const bool use_phase = _xInterp.usePhaseWeights();
+        const int nxwt = use_phase ? _xInterp.nPhaseWeights() : _xInterp.ixrange();
+        std::vector<double> xwt(size_t(nxwt) * mm);
+        std::vector<int> p1ar(mm);
+        std::vector<int> p2ar(mm);
+        std::vector<int> koff(mm);
         double x = x0;
-        double xwt[_xInterp.ixrange() * mm];
-        double p1ar[mm];
-        double p2ar[mm];
         int k=0;
         for (int i=i1; i<i2; ++i,x+=dx) {
-            int p1,p2;
-            // If x is (basically) an integer, only 1 p value.
-            // Otherwise, have a range based on xInterp.xrange()
-            if (std::abs(x-std::floor(x+0.01)) < SMALL*(std::abs(x)+1)) {
+            int p1,p2,p0=0;
+            const double* w = 0;
+            if (use_phase) {
+                w = _xInterp.getPhaseWeights(x, p0);
+                p1 = p0;
+                p2 = p0 + nxwt - 1;
+            } else if (std::abs(x-std::floor(x+0.01)) < SMALL*(std::abs(x)+1)) {
+                // If x is (basically) an integer, only 1 p value.
                 p1 = p2 = int(std::floor(x+0.01));
             } else {
+                // Otherwise, have a range based on xInterp.xrange()
                 p1 = int(std::ceil(x-_xInterp.xrange()));
                 p2 = int(std::floor(x+_xInterp.xrange()));
             }
@@ -568,85 +625,97 @@ namespace galsim {
             if (p2 > _nonzero_bounds.getXMax()) p2 = _nonzero_bounds.getXMax();
             p1ar[i-i1] = p1;
             p2ar[i-i1] = p2;
+            koff[i-i1] = k;
             xdbg<<"i = "<<i<<"  x = "<<x<<": p1,p2 = "<<p1<<','<<p2<<std::endl;
-            assert(p2-p1+1 <= _xInterp.ixrange());
+            assert(p2-p1+1 <= nxwt);
 
             for (int p=p1; p<=p2; ++p) {
-                xassert(k < _xInterp.ixrange()*mm);
-                xwt[k++] = _xInterp.xval(p-x);
+                xassert(k < nxwt*mm);
+                xwt[k++] = use_phase ? w[p-p0] : _xInterp.xval(p-x);
             }
         }
 
-        // The inner calculation for rowq is the same for multiple y values since it is
-        // independent of y, so each time we use the same q, the rowq array is the same.
-        // Therefore we should cache these calculations to reuse when possible.
-        std::map<int, std::vector<double> > rowq_cache;
-
+        // The output rows are split into contiguous blocks, one per thread.  Within each block,
+        // the rows are built in order, so the rowq cache is still effective.  The only
+        // duplicated work is the up to nxwt rowq values that are needed by two neighboring
+        // blocks, so each block gets several times that many rows.
+        // The y values are calculated directly from j, so the result doesn't depend on the
+        // number of blocks.
         im.setZero();
-        double y = y0;
-        double temp[mm];
-        for (int j=j1; j<j2; ++j,y+=dy,ptr+=skip) {
-            memset(temp, 0, mm * sizeof(double)); // Zero out temp array
-            xdbg<<"j = "<<j<<", y = "<<y<<std::endl;
-            // If y is (basically) an integer, only 1 q value.
-            // Otherwise, have a range based on xInterp.xrange()
-            // Subtlety: also keep track of the minimum q we want to keep in the cache, which
-            // may be less than q1 to account for sometimes y being integer, sometimes not.
-            int q1,q2,qmin;
-            if (std::abs(y-std::floor(y+0.01)) < SMALL*(std::abs(y)+1)) {
-                q1 = q2 = int(std::floor(y+0.01));
-                qmin = int(std::ceil(y-_xInterp.xrange()));
-            } else {
-                qmin = q1 = int(std::ceil(y-_xInterp.xrange()));
-                q2 = int(std::floor(y+_xInterp.xrange()));
-            }
-            xdbg<<"q1,q2 = "<<q1<<','<<q2<<std::endl;
-            // Limit to nonzero region
-            if (q1 < _nonzero_bounds.getYMin()) q1 = _nonzero_bounds.getYMin();
-            if (q2 > _nonzero_bounds.getYMax()) q2 = _nonzero_bounds.getYMax();
-            xdbg<<"q1,q2 => "<<q1<<','<<q2<<std::endl;
+        const int nrow = j2-j1;
+        const int stride = im.getStride();
+        const int nblock = NumRowBlocks(nrow, 8*nxwt);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static,1) if (nblock > 1)
+#endif
+        for (int b=0; b<nblock; ++b) {
+            const int jb1 = j1 + int((long(nrow) * b) / nblock);
+            const int jb2 = j1 + int((long(nrow) * (b+1)) / nblock);
+
+            // The inner calculation for rowq is the same for multiple y values since it is
+            // independent of y, so each time we use the same q, the rowq array is the same.
+            // Therefore we should cache these calculations to reuse when possible.
+            std::map<int, std::vector<double> > rowq_cache;
+            std::vector<double> temp(mm);
+
+            for (int j=jb1; j<jb2; ++j) {
+                double y = y0 + (j-j1)*dy;
+                std::fill(temp.begin(), temp.end(), 0.);
+                xdbg<<"j = "<<j<<", y = "<<y<<std::endl;
+                // If y is (basically) an integer, only 1 q value.
+                // Otherwise, have a range based on xInterp.xrange()
+                // Subtlety: also keep track of the minimum q we want to keep in the cache, which
+                // may be less than q1 to account for sometimes y being integer, sometimes not.
+                int q1,q2,qmin,q0=0;
+                const double* yw = 0;
+                if (use_phase) {
+                    yw = _xInterp.getPhaseWeights(y, q0);
+                    qmin = q1 = q0;
+                    q2 = q0 + nxwt - 1;
+                } else if (std::abs(y-std::floor(y+0.01)) < SMALL*(std::abs(y)+1)) {
+                    q1 = q2 = int(std::floor(y+0.01));
+                    qmin = int(std::ceil(y-_xInterp.xrange()));
+                } else {
+                    qmin = q1 = int(std::ceil(y-_xInterp.xrange()));
+                    q2 = int(std::floor(y+_xInterp.xrange()));
+                }
+                xdbg<<"q1,q2 = "<<q1<<','<<q2<<std::endl;
+                // Limit to nonzero region
+                if (q1 < _nonzero_bounds.getYMin()) q1 = _nonzero_bounds.getYMin();
+                if (q2 > _nonzero_bounds.getYMax()) q2 = _nonzero_bounds.getYMax();
+                xdbg<<"q1,q2 => "<<q1<<','<<q2<<std::endl;
 
-            // Dump any cached rows we don't need anymore.
-            while (rowq_cache.size() > 0 && rowq_cache.begin()->first < qmin) {
-                rowq_cache.erase(rowq_cache.begin());
-            }
+                // Dump any cached rows we don't need anymore.
+                while (rowq_cache.size() > 0 && rowq_cache.begin()->first < qmin) {
+                    rowq_cache.erase(rowq_cache.begin());
+                }
 
-            for (int q=q1; q<=q2; ++q) {
-                // Get rowq from cache.  If it isn't there, it will be an empty vector.
-                std::vector<double>& rowq = rowq_cache[q];
-
-                // If this rowq was not in cache, need to make it.
-                if (rowq.size() == 0) {
-                    rowq.resize(mm);
-                    double x = x0;
-                    int k=0;
-                    std::vector<double>::iterator row_it=rowq.begin();
-                    for (int i=i1; i<i2; ++i,x+=dx,++row_it) {
-                        *row_it = 0.;
-                        int p1 = p1ar[i-i1];
-                        int p2 = p2ar[i-i1];
-                        const double* imptr = &_image(p1,q);
-                        for (int p=p1; p<=p2; ++p) {
-                            *row_it += xwt[k++] * *imptr++;
+                for (int q=q1; q<=q2; ++q) {
+                    // Get rowq from cache.  If it isn't there, it will be an empty vector.
+                    std::vector<double>& rowq = rowq_cache[q];
+
+                    // If this rowq was not in cache, need to make it.
+                    if (rowq.size() == 0) {
+                        rowq.resize(mm);
+                        for (int ii=0; ii<mm; ++ii) {
+                            const int p1 = p1ar[ii];
+                            rowq[ii] = DDot(p2ar[ii]-p1+1, &xwt[koff[ii]], &_image(p1,q));
                         }
                     }
-                }
 
-                // Now add that to the output row with the ywt scaling.
-                double ywt = _xInterp.xval(q-y);
-                double* tptr = temp;
-                std::vector<double>::const_iterator row_it = rowq.begin();
-                for (int i=i1; i<i2; ++i) {
-                    *tptr++ += *row_it++ * ywt;
+                    // Now add that to the output row with the ywt scaling.
+                    const double ywt = use_phase ? yw[q-q0] : _xInterp.xval(q-y);
+                    const double* rptr = &rowq[0];
+                    double* tptr = &temp[0];
+                    for (int ii=0; ii<mm; ++ii) tptr[ii] += rptr[ii] * ywt;
                 }
+                // Now finally copy onto the real output image.
+                // Note: Accumulating in temp is important for accuracy if the output image is
+                // T=float, so we don't gratuitously lose precision by adding floats rather
+                // than doubles.
+                T* ptrj = ptr + (j-j1)*stride;
+                for (int ii=0; ii<mm; ++ii) ptrj[ii] = temp[ii];
             }
-            // Now finally copy onto the real output image.
-            // Note: In addition to getting a tiny efficiency gain from having temp on
-            // the stack while doing the calculation above, this is also important for
-            // accuracy if the output image is T=float, so we don't gratuitously
-            // lose precision by adding floats rather than doubles.
-            double* tptr = temp;
-            for (int i=i1; i<i2; ++i) *ptr++ = *tptr++;
         }
         dbg<<"Done SBInterpolatedImage fillXImage\n";
     }
@@ -663,7 +732,6 @@ namespace galsim {
         const int m = im.getNCol();
         const int n = im.getNRow();
         T* ptr = im.getData();
-        int skip = im.getNSkip();
         assert(im.getStep() == 1);
 
         // In this version every _xInterp.xval call is different, so there's not really any
@@ -714,51 +782,68 @@ namespace galsim {
             return;
         }
 
-        // Fix up x0, y0, ptr, skip to correspond to these i,j ranges.
+        // Fix up x0, y0, ptr to correspond to these i,j ranges.
         x0 += i1*dx + j1*dxy;
         y0 += j1*dy + i1*dyx;
         ptr += i1 + j1*im.getStride();
-        int mm = i2-i1;
-        skip += (m - mm);
+        const int stride = im.getStride();
+        // If x is an integer, p2-p1+1 can be one more than ixrange.
+        const int nxwt = _xInterp.ixrange() + 1;
+        const bool use_phase = _xInterp.usePhaseWeights();
+        const int nw = _xInterp.nPhaseWeights();
 
+        // Each output pixel is independent here, so just parallelize over the rows.
         im.setZero();
-        for (int j=j1; j<j2; ++j,x0+=dxy,y0+=dy,ptr+=skip) {
-            double x = x0;
-            double y = y0;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int j=j1; j<j2; ++j) {
+            double x = x0 + (j-j1)*dxy;
+            double y = y0 + (j-j1)*dy;
+            T* ptrj = ptr + (j-j1)*stride;
+            std::vector<double> xwt(nxwt);
 
-            for (int i=i1; i<i2; ++i,x+=dx,y+=dyx,++ptr) {
+            for (int i=i1; i<i2; ++i,x+=dx,y+=dyx,++ptrj) {
                 // Still want this check even with above i1,i2,j1,j2 stuff, since projected
                 // region is a parallelogram, so some points can still be sipped.
                 if (y > maxy || y < miny || x > maxx || x < minx) continue;
 
-                int p1 = int(std::ceil(x-_xInterp.xrange()));
-                int p2 = int(std::floor(x+_xInterp.xrange()));
-                int q1 = int(std::ceil(y-_xInterp.xrange()));
-                int q2 = int(std::floor(y+_xInterp.xrange()));
-                if (p1 < _nonzero_bounds.getXMin()) p1 = _nonzero_bounds.getXMin();
-                if (p2 > _nonzero_bounds.getXMax()) p2 = _nonzero_bounds.getXMax();
-                if (q1 < _nonzero_bounds.getYMin()) q1 = _nonzero_bounds.getYMin();
-                if (q2 > _nonzero_bounds.getYMax()) q2 = _nonzero_bounds.getYMax();
-
-                double xwt[p2-p1+1];
-                for (int p=p1, pp=0; p<=p2; ++p, ++pp) {
-                    xwt[pp] = _xInterp.xval(p-x);
-                }
-
                 double sum=0.;
-                for (int q=q1; q<=q2; ++q) {
-                    double ywt = _xInterp.xval(q-y);
+                if (use_phase) {
+                    // The weights in both directions come straight from the interpolant's table.
+                    int p0, q0;
+                    const double* xw = _xInterp.getPhaseWeights(x, p0);
+                    const double* yw = _xInterp.getPhaseWeights(y, q0);
+                    int p1 = std::max(p0, _nonzero_bounds.getXMin());
+                    int p2 = std::min(p0+nw-1, _nonzero_bounds.getXMax());
+                    int q1 = std::max(q0, _nonzero_bounds.getYMin());
+                    int q2 = std::min(q0+nw-1, _nonzero_bounds.getYMax());
+                    for (int q=q1; q<=q2; ++q) {
+                        sum += DDot(p2-p1+1, xw+(p1-p0), &_image(p1,q)) * yw[q-q0];
+                    }
+                } else {
+                    int p1 = int(std::ceil(x-_xInterp.xrange()));
+                    int p2 = int(std::floor(x+_xInterp.xrange()));
+                    int q1 = int(std::ceil(y-_xInterp.xrange()));
+                    int q2 = int(std::floor(y+_xInterp.xrange()));
+                    if (p1 < _nonzero_bounds.getXMin()) p1 = _nonzero_bounds.getXMin();
+                    if (p2 > _nonzero_bounds.getXMax()) p2 = _nonzero_bounds.getXMax();
+                    if (q1 < _nonzero_bounds.getYMin()) q1 = _nonzero_bounds.getYMin();
+                    if (q2 > _nonzero_bounds.getYMax()) q2 = _nonzero_bounds.getYMax();
+                    assert(p2-p1+1 <= nxwt);
 
-                    double xsum = 0.;
-                    const double* imptr = &_image(p1,q);
                     for (int p=p1, pp=0; p<=p2; ++p, ++pp) {
-                        xsum += xwt[pp] * *imptr++;
+                        xwt[pp] = _xInterp.xval(p-x);
+                    }
+
+                    for (int q=q1; q<=q2; ++q) {
+                        double ywt = _xInterp.xval(q-y);
+                        sum += DDot(p2-p1+1, &xwt[0], &_image(p1,q)) * ywt;
                     }
-                    sum += xsum * ywt;
                 }
-                xassert(ptr >= im.getData());
-                xassert(ptr < im.getData() + im.getNElements());
-                *ptr = sum;
+                xassert(ptrj >= im.getData());
+                xassert(ptrj < im.getData() + im.getNElements());
+                *ptrj = sum;
             }
         }
     }
@@ -776,7 +861,6 @@ namespace galsim {
         const int n = im.getNRow();
         std::complex<T>* ptr = im.getData();
         assert(im.getStep() == 1);
-        int skip = im.getNSkip();
         checkK();
         const double SMALL = 10.*std::numeric_limits<double>::epsilon();
 
@@ -797,7 +881,6 @@ namespace galsim {
         ky0 += j1*dky;
         ptr += i1 + j1*im.getStride();
         int mm = i2-i1;
-        skip += (m - mm);
 
         // For the rest of the range, calculate ux, uy values
         std::vector<double> ux(i2-i1);
@@ -821,13 +904,70 @@ namespace galsim {
         dkx *= kscale;
         dky *= kscale;
 
+        // Pre-calculate xInterp factors in place
+        _xInterp.uvalMany(&ux[0], i2-i1);
+        _xInterp.uvalMany(&uy[0], j2-j1);
+
+        const int stride = im.getStride();
+        im.setZero();
+
+        // If every kx and ky is on a node of the _kimage grid, which happens when the requested
+        // grid is commensurate with it (e.g. drawing with the same pixel scale and an FFT size
+        // that is a multiple of the padded image size), then each kInterp sum has just one term.
+        // So we can read the values straight out of _kimage, which is the FFT of the padded
+        // image, and apply the separable weights.
+        if (IsInteger(kx0, SMALL) && IsInteger(dkx, SMALL) &&
+            IsInteger(ky0, SMALL) && IsInteger(dky, SMALL)) {
+            dbg<<"k grid is commensurate with kimage\n";
+            std::vector<int> pw(mm);
+            std::vector<double> wx(mm);
+            kx = kx0;
+            for (int i=0; i<mm; ++i,kx+=dkx) {
+                int p = int(std::floor(kx+0.5));
+                pw[i] = WrapKIndex(p, No2, N);
+                wx[i] = ux[i] * _kInterp.xval(p-kx);
+            }
+            std::vector<int> qw(j2-j1);
+            std::vector<double> wy(j2-j1);
+            ky = ky0;
+            for (int j=0; j<j2-j1; ++j,ky+=dky) {
+                int q = int(std::floor(ky+0.5));
+                qw[j] = WrapKIndex(q, No2, N);
+                wy[j] = uy[j] * _kInterp.xval(q-ky);
+            }
+
+            const BaseImage<std::complex<double> >& kimage = *_kimage;
+            assert(kimage.getStep() == 1);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int j=0; j<j2-j1; ++j) {
+                // _kimage doesn't store the p<0 half, so for those use
+                // _kimage(p,q) = conj(_kimage(-p,-q)).  cf. KValueInnerLoop.
+                const int q = qw[j];
+                const int mq = q == -No2 ? q : -q;
+                const std::complex<double>* kq = &kimage(0,q);
+                const std::complex<double>* kmq = &kimage(0,mq);
+                std::complex<T>* ptrj = ptr + j*stride;
+                for (int i=0; i<mm; ++i) {
+                    const int p = pw[i];
+                    std::complex<double> val = p >= 0 ? kq[p] : std::conj(kmq[-p]);
+                    ptrj[i] = wx[i] * wy[j] * val;
+                }
+            }
+            dbg<<"Done SBInterpolatedImage fillKImage\n";
+            return;
+        }
+
         // The caching stuff is the same here as it was for fillXValue.  The only difference
         // is that we need to wrap around the p,q values and handle the conjugation possibility
         // correctly.  (cf. comments in kValue method.)
+        const int nxwt = _kInterp.ixrange();
+        std::vector<double> xwt(size_t(nxwt) * mm);
+        std::vector<int> p1ar(mm);
+        std::vector<int> p2ar(mm);
+        std::vector<int> koff(mm);
         kx = kx0;
-        double xwt[_kInterp.ixrange() * mm];
-        double p1ar[mm];
-        double p2ar[mm];
         int k=0;
         for (int i=i1; i<i2; ++i,kx+=dkx) {
             int p1, p2;  // Range over which we need to sum.
@@ -840,94 +980,83 @@ namespace galsim {
             }
             p1ar[i-i1] = p1;
             p2ar[i-i1] = p2;
+            koff[i-i1] = k;
             xdbg<<"i = "<<i<<"  kx = "<<kx<<": p1,p2 = "<<p1<<','<<p2<<std::endl;
-            assert(p2-p1+1 <= _kInterp.ixrange());
+            assert(p2-p1+1 <= nxwt);
 
             for (int p=p1; p<=p2; ++p) {
-                xassert(k < _kInterp.ixrange()*mm);
+                xassert(k < nxwt*mm);
                 xwt[k++] = _kInterp.xval(p-kx);
             }
         }
 
-        // Again, can cache the rowq vectors.
-        std::map<int, std::vector<std::complex<double> > > rowq_cache;
-
-        // Pre-calculate xInterp factors in place
-        uxit = ux.begin();
-        for (int i=i1; i<i2; ++i,++uxit) *uxit = _xInterp.uval(*uxit);
-        uyit = uy.begin();
-        for (int j=j1; j<j2; ++j,++uyit) *uyit = _xInterp.uval(*uyit);
-
-        im.setZero();
-        ky = ky0;
-        uyit = uy.begin();
-        double temp[2*mm]; // Can't put complex<double> array on stack, so reinterpret_cast below.
-        for (int j=j1; j<j2; ++j,ky+=dky,ptr+=skip,++uyit) {
-            memset(temp, 0, 2*mm * sizeof(double));
-            xdbg<<"j = "<<j<<", ky = "<<ky<<std::endl;
-            // If y is (basically) an integer, only 1 q value.
-            int q1,q2,qmin;
-            if (std::abs(ky-std::floor(ky+0.01)) < SMALL*(std::abs(ky)+1)) {
-                q1 = q2 = int(std::floor(ky+0.01));
-                qmin = int(std::ceil(ky-_kInterp.xrange()));
-            } else {
-                qmin = q1 = int(std::ceil(ky-_kInterp.xrange()));
-                q2 = int(std::floor(ky+_kInterp.xrange()));
-            }
-            xdbg<<"q1,q2 = "<<q1<<','<<q2<<std::endl;
+        // As in fillXImage, split the rows into one contiguous block per thread, each with
+        // its own rowq cache and enough rows to make up for refilling it.
+        const int nrow = j2-j1;
+        const int nblock = NumRowBlocks(nrow, 8*nxwt);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static,1) if (nblock > 1)
+#endif
+        for (int b=0; b<nblock; ++b) {
+            const int jb1 = j1 + int((long(nrow) * b) / nblock);
+            const int jb2 = j1 + int((long(nrow) * (b+1)) / nblock);
+
+            // Again, can cache the rowq vectors.
+            std::map<int, std::vector<std::complex<double> > > rowq_cache;
+            std::vector<std::complex<double> > temp(mm);
+
+            for (int j=jb1; j<jb2; ++j) {
+                double ky = ky0 + (j-j1)*dky;
+                std::fill(temp.begin(), temp.end(), 0.);
+                xdbg<<"j = "<<j<<", ky = "<<ky<<std::endl;
+                // If y is (basically) an integer, only 1 q value.
+                int q1,q2,qmin;
+                if (std::abs(ky-std::floor(ky+0.01)) < SMALL*(std::abs(ky)+1)) {
+                    q1 = q2 = int(std::floor(ky+0.01));
+                    qmin = int(std::ceil(ky-_kInterp.xrange()));
+                } else {
+                    qmin = q1 = int(std::ceil(ky-_kInterp.xrange()));
+                    q2 = int(std::floor(ky+_kInterp.xrange()));
+                }
+                xdbg<<"q1,q2 = "<<q1<<','<<q2<<std::endl;
 
-            // Dump any cached rows we don't need anymore.
-            while (rowq_cache.size() > 0 && rowq_cache.begin()->first < qmin) {
-                rowq_cache.erase(rowq_cache.begin());
-            }
+                // Dump any cached rows we don't need anymore.
+                while (rowq_cache.size() > 0 && rowq_cache.begin()->first < qmin) {
+                    rowq_cache.erase(rowq_cache.begin());
+                }
 
-            int qwrap1 = WrapKIndex(q1, No2, N);
-            for (int q=q1, qwrap=qwrap1; q<=q2; ++q, ++qwrap) {
-                if (qwrap == No2) qwrap -= N;
-
-                // Get rowq from cache.  If it isn't there, it will be an empty vector.
-                std::vector<std::complex<double> >& rowq = rowq_cache[q];
-
-                // If this rowq was not in cache, need to make it.
-                if (rowq.size() == 0) {
-                    rowq.resize(mm);
-                    kx = kx0;
-                    int k=0;
-                    std::vector<std::complex<double> >::iterator row_it=rowq.begin();
-                    for (int i=i1; i<i2; ++i,kx+=dkx) {
-                        int p1 = p1ar[i-i1];
-                        int p2 = p2ar[i-i1];
-                        int pwrap1 = WrapKIndex(p1, No2, N);
-                        *row_it++ = KValueInnerLoop(p2-p1+1,pwrap1,qwrap,No2,N,&xwt[k],*_kimage);
-                        k += p2-p1+1;
+                int qwrap1 = WrapKIndex(q1, No2, N);
+                for (int q=q1, qwrap=qwrap1; q<=q2; ++q, ++qwrap) {
+                    if (qwrap == No2) qwrap -= N;
+
+                    // Get rowq from cache.  If it isn't there, it will be an empty vector.
+                    std::vector<std::complex<double> >& rowq = rowq_cache[q];
+
+                    // If this rowq was not in cache, need to make it.
+                    if (rowq.size() == 0) {
+                        rowq.resize(mm);
+                        for (int ii=0; ii<mm; ++ii) {
+                            int p1 = p1ar[ii];
+                            int p2 = p2ar[ii];
+                            int pwrap1 = WrapKIndex(p1, No2, N);
+                            rowq[ii] = KValueInnerLoop(p2-p1+1,pwrap1,qwrap,No2,N,&xwt[koff[ii]],
+                                                       *_kimage);
+                        }
                     }
-                }
 
-                // Now add that to the output row with the ywt scaling.
-                double ywt = _kInterp.xval(q-ky);
-                std::complex<double>* tptr = reinterpret_cast<std::complex<double>*>(temp);
-                std::vector<std::complex<double> >::const_iterator row_it = rowq.begin();
-                for (int i=i1; i<i2; ++i) {
-                    xassert(row_it < rowq.end());
-                    xassert((void*)tptr < (void*)(temp + 2*mm));
-                    *tptr++ += *row_it++ * ywt;
+                    // Now add that to the output row with the ywt scaling.
+                    double ywt = _kInterp.xval(q-ky);
+                    for (int ii=0; ii<mm; ++ii) temp[ii] += rowq[ii] * ywt;
                 }
-            }
 
-            // Now account for the x-interpolant
-            // And finally copy onto the real output image.
-            // Note: In addition to getting a tiny efficiency gain from having temp on
-            // the stack while doing the calculation above, this is also important for
-            // accuracy if the output image is complex<float>, so we don't gratuitously
-            // lose precision by adding floats rather than doubles.
-            uxit = ux.begin();
-            std::complex<double>* tptr = reinterpret_cast<std::complex<double>*>(temp);
-            for (int i=i1; i<i2; ++i) {
-                xassert(ptr < im.getData() + im.getNElements());
-                xassert(uxit < ux.end());
-                xassert(uyit < uy.end());
-                xassert((void*)tptr < (void*)(temp + 2*mm));
-                *ptr++ = *uxit++ * *uyit * *tptr++;
+                // Now account for the x-interpolant
+                // And finally copy onto the real output image.
+                // Note: Accumulating in temp is also important for accuracy if the output
+                // image is complex<float>, so we don't gratuitously lose precision by adding
+                // floats rather than doubles.
+                const double uyj = uy[j-j1];
+                std::complex<T>* ptrj = ptr + (j-j1)*stride;
+                for (int ii=0; ii<mm; ++ii) ptrj[ii] = ux[ii] * uyj * temp[ii];
             }
         }
 
@@ -946,7 +1075,6 @@ namespace galsim {
         const int m = im.getNCol();
         const int n = im.getNRow();
         std::complex<T>* ptr = im.getData();
-        int skip = im.getNSkip();
         assert(im.getStep() == 1);
         checkK();
 
@@ -967,22 +1095,30 @@ namespace galsim {
         dky *= kscale;
         dkyx *= kscale;
         double maxk1 = _maxk1 * kscale;
+        const int stride = im.getStride();
+        // If kx is an integer, p2-p1+1 can be one more than ixrange.
+        const int nxwt = _kInterp.ixrange() + 1;
 
-        for (int j=0; j<n; ++j,kx0+=dkxy,ky0+=dky,ux0+=duxy,uy0+=duy,ptr+=skip) {
-            double kx = kx0;
-            double ky = ky0;
-            double ux = ux0;
-            double uy = uy0;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int j=0; j<n; ++j) {
+            double kx = kx0 + j*dkxy;
+            double ky = ky0 + j*dky;
+            double ux = ux0 + j*duxy;
+            double uy = uy0 + j*duy;
+            std::complex<T>* ptrj = ptr + j*stride;
+            std::vector<double> xwt(nxwt);
             for (int i=0; i<m; ++i,kx+=dkx,ky+=dkyx,ux+=dux,uy+=duyx) {
                 if (std::abs(kx) > maxk1 || std::abs(ky) > maxk1) {
-                    *ptr++ = T(0);
+                    *ptrj++ = T(0);
                 } else {
                     int p1 = int(std::ceil(kx-_kInterp.xrange()));
                     int p2 = int(std::floor(kx+_kInterp.xrange()));
                     int q1 = int(std::ceil(ky-_kInterp.xrange()));
                     int q2 = int(std::floor(ky+_kInterp.xrange()));
+                    assert(p2-p1+1 <= nxwt);
 
-                    double xwt[p2-p1+1];
                     for (int p=p1, pp=0; p<=p2; ++p, ++pp) xwt[pp] = _kInterp.xval(p-kx);
 
                     std::complex<double> sum = 0.;
@@ -991,9 +1127,10 @@ namespace galsim {
                     for (int q=q1, qwrap=qwrap1; q<=q2; ++q, ++qwrap) {
                         if (qwrap == No2) qwrap -= N;
                         double ywt = _kInterp.xval(q-ky);
-                        sum += ywt * KValueInnerLoop(p2-p1+1,pwrap1,qwrap,No2,N,xwt,*_kimage);
+                        sum += ywt * KValueInnerLoop(p2-p1+1,pwrap1,qwrap,No2,N,&xwt[0],
+                                                     *_kimage);
                     }
-                    *ptr++ = _xInterp.uval(ux) * _xInterp.uval(uy) * sum;
+                    *ptrj++ = _xInterp.uval(ux) * _xInterp.uval(uy) * sum;
                 }
             }
         }
@@ -1218,55 +1355,94 @@ namespace galsim {
 
     void SBInterpolatedImage::SBInterpolatedImageImpl::checkReadyToShoot() const
     {
-        if (_readyToShoot) return;
-
-        dbg<<"SBInterpolatedImage not ready to shoot.  Build _pt:\n";
-
-        // Build the sets holding cumulative fluxes of all Pixels
-        _positiveFlux = 0.;
-        _negativeFlux = 0.;
-        _pt.clear();
-
-        Bounds<int> b = _nonzero_bounds;
-        int xStart = -((b.getXMax()-b.getXMin()+1)/2);
-        int y = -((b.getYMax()-b.getYMin()+1)/2);
-
-        // We loop over the non-zero bounds, since this is the only region with any flux.
-        //
-        // ix,iy are the indices in the original image
-        // x,y are the positions relative to the center point.
-        for (int iy = b.getYMin(); iy<= b.getYMax(); ++iy, ++y) {
-            int x = xStart;
-            for (int ix = b.getXMin(); ix<= b.getXMax(); ++ix, ++x) {
-                double flux = _image(ix,iy);
-                if (flux==0.) continue;
-                if (flux > 0.) {
-                    _positiveFlux += flux;
-                } else {
-                    _negativeFlux += -flux;
+        if (!_readyToShoot) {
+            dbg<<"SBInterpolatedImage not ready to shoot.  Build alias table:\n";
+
+            Bounds<int> b = _nonzero_bounds;
+            const int xStart = -((b.getXMax()-b.getXMin()+1)/2);
+            const int yStart = -((b.getYMax()-b.getYMin()+1)/2);
+            const int nrow = b.getYMax()-b.getYMin()+1;
+
+            // We loop over the non-zero bounds, since this is the only region with any flux.
+            // First count the non-zero pixels in each row, so we know where each row's pixels
+            // go in the flat _pixels array.  Then fill them in.  Both passes are parallel over
+            // rows.  The positive and negative flux are accumulated per row and then summed
+            // in order, so the results don't depend on the number of threads.
+            //
+            // ix,iy are the indices in the original image
+            // x,y are the positions relative to the center point.
+            std::vector<int> offsets(nrow+1, 0);
+            std::vector<double> rowPos(nrow, 0.);
+            std::vector<double> rowNeg(nrow, 0.);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int j=0; j<nrow; ++j) {
+                const int iy = b.getYMin() + j;
+                int count = 0;
+                for (int ix = b.getXMin(); ix<= b.getXMax(); ++ix) {
+                    double flux = _image(ix,iy);
+                    if (flux==0.) continue;
+                    if (flux > 0.) {
+                        rowPos[j] += flux;
+                    } else {
+                        rowNeg[j] += -flux;
+                    }
+                    ++count;
                 }
-                _pt.push_back(shared_ptr<Pixel>(new Pixel(x,y,flux)));
+                offsets[j+1] = count;
             }
-        }
-
-        // The above just computes the positive and negative flux for the main image.
-        // This is convolved by the interpolant, so we need to correct these values
-        // in the same way that SBConvolve does:
-        double p1 = _positiveFlux;
-        double n1 = _negativeFlux;
-        dbg<<"positiveFlux = "<<p1<<", negativeFlux = "<<n1<<std::endl;
-        double p2 = _xInterp.getPositiveFlux2d();
-        double n2 = _xInterp.getNegativeFlux2d();
-        dbg<<"Interpolant has positiveFlux = "<<p2<<", negativeFlux = "<<n2<<std::endl;
-        _positiveFlux = p1*p2 + n1*n2;
-        _negativeFlux = p1*n2 + n1*p2;
-        dbg<<"positiveFlux => "<<_positiveFlux<<", negativeFlux => "<<_negativeFlux<<std::endl;
-
-        double thresh = std::numeric_limits<double>::epsilon() * (_positiveFlux + _negativeFlux);
-        dbg<<"thresh = "<<thresh<<std::endl;
-        _pt.buildTree(thresh);
+            _positiveFlux = 0.;
+            _negativeFlux = 0.;
+            for (int j=0; j<nrow; ++j) {
+                offsets[j+1] += offsets[j];
+                _positiveFlux += rowPos[j];
+                _negativeFlux += rowNeg[j];
+            }
+            const int npix = offsets[nrow];
+            dbg<<"npix = "<<npix<<std::endl;
+
+            // The above just computes the positive and negative flux for the main image.
+            // This is convolved by the interpolant, so we need to correct these values
+            // in the same way that SBConvolve does:
+            double p1 = _positiveFlux;
+            double n1 = _negativeFlux;
+            dbg<<"positiveFlux = "<<p1<<", negativeFlux = "<<n1<<std::endl;
+            double p2 = _xInterp.getPositiveFlux2d();
+            double n2 = _xInterp.getNegativeFlux2d();
+            dbg<<"Interpolant has positiveFlux = "<<p2<<", negativeFlux = "<<n2<<std::endl;
+            _positiveFlux = p1*p2 + n1*n2;
+            _negativeFlux = p1*n2 + n1*p2;
+            dbg<<"positiveFlux => "<<_positiveFlux<<
+                ", negativeFlux => "<<_negativeFlux<<std::endl;
+
+            // Pixels with flux below this are left out of the sampling.
+            double thresh = std::numeric_limits<double>::epsilon() *
+                (_positiveFlux + _negativeFlux);
+            dbg<<"thresh = "<<thresh<<std::endl;
+
+            _pixels.resize(npix);
+            std::vector<double> weights(npix);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int j=0; j<nrow; ++j) {
+                const int iy = b.getYMin() + j;
+                const int y = yStart + j;
+                int k = offsets[j];
+                int x = xStart;
+                for (int ix = b.getXMin(); ix<= b.getXMax(); ++ix, ++x) {
+                    double flux = _image(ix,iy);
+                    if (flux==0.) continue;
+                    _pixels[k] = Pixel(x,y,flux);
+                    weights[k] = std::abs(flux) > thresh ? std::abs(flux) : 0.;
+                    ++k;
+                }
+            }
+            _alias.build(weights);
 
-        _readyToShoot = true;
+            _readyToShoot = true;
+        }
     }
 
     // Photon-shooting
@@ -1278,24 +1454,27 @@ namespace galsim {
         dbg<<"Target flux = "<<getFlux()<<std::endl;
         assert(N>=0);
         checkReadyToShoot();
-        /* The pixel coordinates are stored by cumulative absolute flux in
-         * a C++ standard-libary set, so the inversion is done with a binary
-         * search tree.  There are no doubt speed gains available from sorting the
-         * pixels by flux, and somehow weighting the tree search to the elements holding
-         * the most flux.  But I'm doing it the simplest way right now.
+        /* The pixels are selected with probability proportional to their absolute flux using
+         * an alias table, which takes O(1) time per photon.
          */
-        assert(N>=0);
 
-        if (N<=0 || _pt.empty()) return;
+        if (N<=0 || _alias.empty()) return;
         double totalAbsFlux = _positiveFlux + _negativeFlux;
         double fluxPerPhoton = totalAbsFlux / N;
         dbg<<"posFlux = "<<_positiveFlux<<", negFlux = "<<_negativeFlux<<std::endl;
         dbg<<"totFlux = "<<_positiveFlux-_negativeFlux<<", totAbsFlux = "<<totalAbsFlux<<std::endl;
         dbg<<"fluxPerPhoton = "<<fluxPerPhoton<<std::endl;
+
+        // Draw the uniform deviates into the x array first.  Then each photon can be
+        // filled in independently.
+        double* xar = photons.getXArray();
+        ud.generate(N, xar);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (int i=0; i<N; ++i) {
-            double unitRandom = ud();
-            const shared_ptr<Pixel> p = _pt.find(unitRandom);
-            photons.setPhoton(i, p->x, p->y, p->isPositive ? fluxPerPhoton : -fluxPerPhoton);
+            const Pixel& p = _pixels[_alias.find(xar[i])];
+            photons.setPhoton(i, p.x, p.y, p.isPositive ? fluxPerPhoton : -fluxPerPhoton);
         }
         dbg<<"photons.getTotalFlux = "<<photons.getTotalFlux()<<std::endl;
 
@@ -21,6 +21,7 @@
 
 #include "SBKolmogorov.h"
 #include "SBKolmogorovImpl.h"
+#include "TableCache.h"
 #include "math/Bessel.h"
 #include "math/Hankel.h"
 #include "fmath/fmath.hpp"
@@ -63,7 +64,7 @@ namespace galsim {
     }
 
     LRUCache<GSParamsPtr, KolmogorovInfo> SBKolmogorov::SBKolmogorovImpl::cache(
-        sbp::max_kolmogorov_cache);
+        "Kolmogorov", sbp::max_kolmogorov_cache);
 
     // The "magic" number we call K0_FACTOR omes from the standard form of the Kolmogorov spectrum
     // from Racine, 1996 PASP, 108, 699 (who in turn is quoting Fried, 1966, JOSA, 56, 1372):
@@ -335,6 +336,10 @@ namespace galsim {
 #endif
 
     // Constructor to initialize Kolmogorov constants and xvalue lookup table
+    // The version of the algorithm used to build the radial table.  Increment this whenever
+    // that changes, so that tables saved in the table cache by older code are not used.
+    static const int KOLMOGOROV_RADIAL_TABLE_VERSION = 1;
+
     KolmogorovInfo::KolmogorovInfo(const GSParamsPtr& gsparams) :
         _radial(Table::spline)
     {
@@ -347,14 +352,6 @@ namespace galsim {
 
         // Build the table for the radial function.
 
-        // Start with f(0), which is analytic:
-        // According to Wolfram Alpha:
-        // Integrate[k*exp(-k^5/3),{k,0,infinity}] = 3/5 Gamma(6/5)
-        // The value we want is this / 2pi, which we define as XVAL_ZERO above.
-        double val = XVAL_ZERO;
-        _radial.addEntry(0.,val);
-        xdbg<<"f(0) = "<<val<<std::endl;
-
         // We use a cubic spline for the interpolation, which has an error of O(h^4) max(f'''').
         // As with Sersic (since Kolmogorov is just a Sersic with n=0.6 in reverse), we use
         // max(f'''') ~= 10.  So:
@@ -363,25 +360,47 @@ namespace galsim {
         double dlogr = gsparams->table_spacing * sqrt(sqrt(gsparams->xvalue_accuracy / 10.));
         xdbg<<"dlogr = "<<dlogr<<std::endl;
 
-        // Continue until the missing flux is less than shoot_accuracy.
-        double thresh = gsparams->shoot_accuracy / (2.*M_PI);
-        xdbg<<"thresh  = "<<thresh<<std::endl;
-        KolmXValue xval_func(*gsparams);
-
-        // Don't go over r=1.e4.  F(1.e4) ~ 1.e-14, so if we haven't stopped by then,
-        // we're probably hitting numerical precision issues.
-        for (double logr=-3.; logr < std::log(1.e4); logr += dlogr) {
-            double r = std::exp(logr);
-            val = xval_func(r) / (2.*M_PI);
-            dbg<<"f("<<r<<") = "<<val<<std::endl;
-            _radial.addEntry(r,val);
-
-            // At high r, the profile is well approximated by a power law, F ~ r^-3.67
-            // The integral of the missing flux out to infinity is int_r^inf F(r) r dr = F r^2/1.67
-            xdbg<<"F r^2/1.67 = "<<val*r*r/1.67<<"  thresh = "<<thresh<<std::endl;
-            if (val * r * r / 1.67 < thresh) break;
+        // This is the slow part, so first check whether another process has already built it.
+        TableCacheKey key("KolmogorovRadial", KOLMOGOROV_RADIAL_TABLE_VERSION, *gsparams);
+        std::vector<double> values;
+        if (!LoadCachedTable(key, _radial, values)) {
+            // Start with f(0), which is analytic:
+            // According to Wolfram Alpha:
+            // Integrate[k*exp(-k^5/3),{k,0,infinity}] = 3/5 Gamma(6/5)
+            // The value we want is this / 2pi, which we define as XVAL_ZERO above.
+            double val = XVAL_ZERO;
+            _radial.addEntry(0.,val);
+            xdbg<<"f(0) = "<<val<<std::endl;
+
+            // Continue until the missing flux is less than shoot_accuracy.
+            double thresh = gsparams->shoot_accuracy / (2.*M_PI);
+            xdbg<<"thresh  = "<<thresh<<std::endl;
+
+            // Don't go over r=1.e4.  F(1.e4) ~ 1.e-14, so if we haven't stopped by then,
+            // we're probably hitting numerical precision issues.
+            const double logr0 = -3.;
+            const int nr = int(std::ceil((std::log(1.e4) - logr0) / dlogr));
+
+            // Do all the Hankel transforms at once with FFTLog.
+            std::vector<double> xvals(nr);
+            math::hankel_inf_many(KolmKValue(), logr0, dlogr, nr, 0., xvals.data(),
+                                  gsparams->integration_relerr, gsparams->integration_abserr);
+
+            for (int i=0; i<nr; ++i) {
+                double r = std::exp(logr0 + i*dlogr);
+                val = xvals[i] / (2.*M_PI);
+                dbg<<"f("<<r<<") = "<<val<<std::endl;
+                _radial.addEntry(r,val);
+
+                // At high r, the profile is well approximated by a power law, F ~ r^-3.67
+                // The integral of the missing flux out to infinity is
+                // int_r^inf F(r) r dr = F r^2/1.67
+                xdbg<<"F r^2/1.67 = "<<val*r*r/1.67<<"  thresh = "<<thresh<<std::endl;
+                if (val * r * r / 1.67 < thresh) break;
+            }
+            _radial.finalize();
+            SaveCachedTable(key, _radial, values);
         }
-        _radial.finalize();
         dbg<<"Done loop to build radial function.\n";
 
         // The large r behavior of F(r) is well approximated by a power law, F ~ r^-3.67
@@ -467,6 +486,13 @@ namespace galsim {
         dbg<<"KolmogorovInfo Realized flux = "<<photons.getTotalFlux()<<std::endl;
     }
 
+    size_t KolmogorovInfo::getMemorySize() const
+    {
+        return sizeof(*this)
+            + _radial.getMemorySize() - sizeof(_radial)
+            + (_sampler ? _sampler->getMemorySize() : 0);
+    }
+
     void SBKolmogorov::SBKolmogorovImpl::shoot(PhotonArray& photons, UniformDeviate ud) const
     {
         const int N = photons.size();
@@ -19,9 +19,12 @@
 
 //#define DEBUGLOGGING
 
+#include <atomic>
+#include <cstring>
 #include "SBProfile.h"
 #include "SBTransform.h"
 #include "SBProfileImpl.h"
+#include "LRUCache.h"
 #include "math/Angle.h"
 
 // There are three levels of verbosity which can be helpful when debugging,
@@ -74,6 +77,33 @@ namespace galsim {
         return _pimpl->kValue(k);
     }
 
+    void SBProfile::xValueMany(const double* x, const double* y, double* val, int N) const
+    {
+        assert(_pimpl.get());
+        if (N <= 0) return;
+        _pimpl->xValueMany(x, y, val, N);
+    }
+
+    void SBProfile::kValueMany(const double* kx, const double* ky, std::complex<double>* val,
+                               int N) const
+    {
+        assert(_pimpl.get());
+        if (N <= 0) return;
+        _pimpl->kValueMany(kx, ky, val, N);
+    }
+
+    void SBProfile::SBProfileImpl::xValueMany(const double* x, const double* y, double* val,
+                                              int N) const
+    {
+        for (int i=0; i<N; ++i) val[i] = xValue(Position<double>(x[i], y[i]));
+    }
+
+    void SBProfile::SBProfileImpl::kValueMany(const double* kx, const double* ky,
+                                              std::complex<double>* val, int N) const
+    {
+        for (int i=0; i<N; ++i) val[i] = kValue(Position<double>(kx[i], ky[i]));
+    }
+
     void SBProfile::getXRange(double& xmin, double& xmax, std::vector<double>& splits) const
     {
         assert(_pimpl.get());
@@ -165,6 +195,46 @@ namespace galsim {
         return _pimpl->getNegativeFlux();
     }
 
+    bool SBProfile::getStructure(ProfileStructure& key) const
+    {
+        assert(_pimpl.get());
+        key.add(_pimpl->gsparams);
+        return _pimpl->getStructure(key);
+    }
+
+    ProfileStructure& ProfileStructure::add(const char* name)
+    {
+        // Include the terminating null, so names can't run into the values that follow.
+        _key.append(name, std::strlen(name)+1);
+        return *this;
+    }
+
+    ProfileStructure& ProfileStructure::add(double x)
+    {
+        _key.append(reinterpret_cast<const char*>(&x), sizeof(double));
+        return *this;
+    }
+
+    ProfileStructure& ProfileStructure::add(const GSParams& gsparams)
+    {
+        add(gsparams.minimum_fft_size);
+        add(gsparams.maximum_fft_size);
+        add(gsparams.folding_threshold);
+        add(gsparams.stepk_minimum_hlr);
+        add(gsparams.maxk_threshold);
+        add(gsparams.kvalue_accuracy);
+        add(gsparams.xvalue_accuracy);
+        add(gsparams.table_spacing);
+        add(gsparams.realspace_relerr);
+        add(gsparams.realspace_abserr);
+        add(gsparams.integration_relerr);
+        add(gsparams.integration_abserr);
+        add(gsparams.shoot_accuracy);
+        add(gsparams.interpolant_phase_tolerance);
+        add(gsparams.interpolant_tables);
+        return *this;
+    }
+
     SBProfile::SBProfile(SBProfileImpl* pimpl) : _pimpl(pimpl) {}
 
     SBProfile::SBProfileImpl::SBProfileImpl(const GSParams& _gsparams) :
@@ -289,8 +359,8 @@ namespace galsim {
     }
 
     template <typename T>
-    void SBProfile::draw(ImageView<T> image, double imscale,
-                         double* jac, double xoff, double yoff, double flux_ratio) const
+    void SBProfile::plainDraw(ImageView<T> image, double imscale,
+                              double* jac, double xoff, double yoff, double flux_ratio) const
     {
         dbg<<"Start plainDraw"<<std::endl;
         dbg<<"bounds = "<<image.getBounds()<<std::endl;
@@ -368,9 +438,10 @@ namespace galsim {
     }
 
     template <typename T>
-    void SBProfile::drawK(ImageView<std::complex<T> > image, double imscale, double* jac) const
+    void SBProfile::plainDrawK(ImageView<std::complex<T> > image, double imscale,
+                               double* jac) const
     {
-        dbg<<"Start drawK: \n";
+        dbg<<"Start plainDrawK: \n";
         dbg<<"bounds = "<<image.getBounds()<<std::endl;
         dbg<<"imscale = "<<imscale<<std::endl;
         assert(_pimpl.get());
@@ -431,10 +502,23 @@ namespace galsim {
         { prof.fillKImage(q,kx0,dkx,0,ky0,dky,0); }
     };
 
+    // How to combine the quadrant values with the existing values in the image.
+    struct AssignOp
+    {
+        template <typename T>
+        void operator()(T& a, const T& b) const { a = b; }
+    };
+    struct MultiplyOp
+    {
+        template <typename T>
+        void operator()(T& a, const T& b) const { a *= b; }
+    };
+
     // The code is basically the same for X or K.
-    template <class Prof, typename T>
+    template <class Prof, typename T, class Op>
     static void FillQuadrant(const Prof& prof, ImageView<T> im,
-                             double x0, double dx, int m1, double y0, double dy, int n1)
+                             double x0, double dx, int m1, double y0, double dy, int n1,
+                             const Op& op)
     {
         dbg<<"Start FillQuadrant\n";
         dbg<<x0<<" "<<dx<<" "<<m1<<"   "<<y0<<" "<<dy<<" "<<n1<<std::endl;
@@ -462,14 +546,14 @@ namespace galsim {
         int qskip = -q.getStride() + (m1-m2-1);
         assert(q.getStep() == 1);
         for (int j=0; j<n1; ++j,ptr+=skip,qptr+=qskip) {
-            for (int i=0; i<m1; ++i) *ptr++ = *qptr--;
-            for (int i=0; i<=m2; ++i) *ptr++ = *qptr++;
+            for (int i=0; i<m1; ++i) op(*ptr++, *qptr--);
+            for (int i=0; i<=m2; ++i) op(*ptr++, *qptr++);
         }
         assert(qptr == q.getData() + m1);
         qskip = q.getStride() + (m1-m2-1);
         for (int j=0; j<=n2; ++j,ptr+=skip,qptr+=qskip) {
-            for (int i=0; i<m1; ++i) *ptr++ = *qptr--;
-            for (int i=0; i<=m2; ++i) *ptr++ = *qptr++;
+            for (int i=0; i<m1; ++i) op(*ptr++, *qptr--);
+            for (int i=0; i<=m2; ++i) op(*ptr++, *qptr++);
         }
         xdbg<<"Done copying quadrants"<<std::endl;
     }
@@ -480,7 +564,7 @@ namespace galsim {
     {
         // Guard against infinite loop.
         assert(nx1 != 0 || ny1 != 0);
-        FillQuadrant(*this,im,x0,dx,nx1,y0,dy,ny1);
+        FillQuadrant(*this,im,x0,dx,nx1,y0,dy,ny1,AssignOp());
     }
     template <typename T>
     void SBProfile::SBProfileImpl::fillKImageQuadrant(ImageView<std::complex<T> > im,
@@ -489,7 +573,82 @@ namespace galsim {
     {
         // Guard against infinite loop.
         assert(nkx1 != 0 || nky1 != 0);
-        FillQuadrant(*this,im,kx0,dkx,nkx1,ky0,dky,nky1);
+        FillQuadrant(*this,im,kx0,dkx,nkx1,ky0,dky,nky1,AssignOp());
+    }
+
+    // The number of rows to fill at a time in defaultMultiplyKImage.  Enough that the
+    // per-call overhead of fillKImage is negligible, but small enough that the strip stays
+    // in cache while it is multiplied into the image.
+    static int MultiplyStripRows(int m, int n)
+    { return std::max(1, std::min(n, 8192 / std::max(m,1))); }
+
+    // Multiply rows [j0,j0+q.nrow) of im by the values in q.
+    template <typename T>
+    static void MultiplyStrip(ImageView<std::complex<T> > im, int j0,
+                              const ImageAlloc<std::complex<T> >& q, int ns)
+    {
+        const int m = im.getNCol();
+        std::complex<T>* ptr = im.getData() + j0*im.getStride();
+        const std::complex<T>* qptr = q.getData();
+        int skip = im.getNSkip();
+        int qskip = q.getStride() - m;
+        for (int j=0; j<ns; ++j,ptr+=skip,qptr+=qskip)
+            for (int i=0; i<m; ++i) *ptr++ *= *qptr++;
+    }
+
+    template <typename T>
+    void SBProfile::SBProfileImpl::defaultMultiplyKImage(ImageView<std::complex<T> > im,
+                                                         double kx0, double dkx, int izero,
+                                                         double ky0, double dky, int jzero) const
+    {
+        dbg<<"SBProfile multiplyKImage\n";
+        dbg<<"kx = "<<kx0<<" + i * "<<dkx<<", izero = "<<izero<<std::endl;
+        dbg<<"ky = "<<ky0<<" + j * "<<dky<<", jzero = "<<jzero<<std::endl;
+        assert(im.getStep() == 1);
+        if ((izero != 0 || jzero != 0) && isAxisymmetric()) {
+            // Then only a single quadrant needs to be computed.
+            FillQuadrant(*this,im,kx0,dkx,izero,ky0,dky,jzero,MultiplyOp());
+            return;
+        }
+        const int m = im.getNCol();
+        const int n = im.getNRow();
+        const int ns = MultiplyStripRows(m,n);
+        ImageAlloc<std::complex<T> > q(m, ns);
+        for (int j0=0; j0<n; j0+=ns) {
+            const int nj = std::min(ns, n-j0);
+            // Note: ImageView::operator= copies the pixel values, so construct the view of
+            // the last (possibly shorter) strip directly.
+            ImageView<std::complex<T> > qv =
+                nj < ns ? q.subImage(Bounds<int>(1,m,1,nj)) : q.view();
+            // jzero is relative to the start of the strip, and only matters if the
+            // strip straddles ky=0.
+            int jz = jzero - j0;
+            if (jz <= 0 || jz >= nj) jz = 0;
+            fillKImage(qv, kx0, dkx, izero, ky0 + j0*dky, dky, jz);
+            MultiplyStrip(im, j0, q, nj);
+        }
+    }
+
+    template <typename T>
+    void SBProfile::SBProfileImpl::defaultMultiplyKImage(ImageView<std::complex<T> > im,
+                                                         double kx0, double dkx, double dkxy,
+                                                         double ky0, double dky, double dkyx) const
+    {
+        dbg<<"SBProfile multiplyKImage\n";
+        dbg<<"kx = "<<kx0<<" + i * "<<dkx<<" + j * "<<dkxy<<std::endl;
+        dbg<<"ky = "<<ky0<<" + i * "<<dkyx<<" + j * "<<dky<<std::endl;
+        assert(im.getStep() == 1);
+        const int m = im.getNCol();
+        const int n = im.getNRow();
+        const int ns = MultiplyStripRows(m,n);
+        ImageAlloc<std::complex<T> > q(m, ns);
+        for (int j0=0; j0<n; j0+=ns) {
+            const int nj = std::min(ns, n-j0);
+            ImageView<std::complex<T> > qv =
+                nj < ns ? q.subImage(Bounds<int>(1,m,1,nj)) : q.view();
+            fillKImage(qv, kx0 + j0*dkxy, dkx, dkxy, ky0 + j0*dky, dky, dkyx);
+            MultiplyStrip(im, j0, q, nj);
+        }
     }
 
     void GetKValueRange1d(int& i1, int& i2, int m, double kmax, double ksqmax,
@@ -575,6 +734,111 @@ namespace galsim {
     }
 
     // instantiate template functions for expected image types
+    static std::atomic<bool> use_draw_cache(false);
+
+    void SetDrawCache(bool use)
+    { use_draw_cache = use; }
+
+    bool GetDrawCache()
+    { return use_draw_cache; }
+
+    // The key for the cache of drawn images.  The structure includes the profile and all of the
+    // arguments to draw or drawK, including the image bounds.  It only holds values, since the
+    // keys stay in the cache after the profile that was drawn is gone.
+    struct DrawKey
+    {
+        ProfileStructure structure;
+
+        size_t hash() const { return structure.hash(); }
+        bool operator<(const DrawKey& rhs) const { return structure < rhs.structure; }
+    };
+
+    template <typename T>
+    class DrawResult
+    {
+    public:
+        template <typename Draw>
+        DrawResult(const Bounds<int>& bounds, Draw draw) : _image(bounds) { draw(_image.view()); }
+
+        const ImageAlloc<T>& getImage() const { return _image; }
+
+        size_t getMemorySize() const
+        { return sizeof(*this) + _image.getNElements() * sizeof(T); }
+
+    private:
+        ImageAlloc<T> _image;
+    };
+
+    template <typename T>
+    struct DrawCache
+    {
+        static LRUCache<DrawKey, DrawResult<T> > cache;
+    };
+
+    template <>
+    LRUCache<DrawKey, DrawResult<float> >
+        DrawCache<float>::cache("Draw<float>", sbp::max_draw_cache);
+    template <>
+    LRUCache<DrawKey, DrawResult<double> >
+        DrawCache<double>::cache("Draw<double>", sbp::max_draw_cache);
+    template <>
+    LRUCache<DrawKey, DrawResult<std::complex<float> > >
+        DrawCache<std::complex<float> >::cache("DrawK<float>", sbp::max_draw_cache);
+    template <>
+    LRUCache<DrawKey, DrawResult<std::complex<double> > >
+        DrawCache<std::complex<double> >::cache("DrawK<double>", sbp::max_draw_cache);
+
+    // Add the position and size of the image to key.
+    template <typename T>
+    static void AddBounds(ProfileStructure& key, const ImageView<T>& image)
+    {
+        key.add(image.getXMin()).add(image.getXMax());
+        key.add(image.getYMin()).add(image.getYMax());
+    }
+
+    template <typename T>
+    void SBProfile::draw(ImageView<T> image, double imscale,
+                         double* jac, double xoff, double yoff, double flux_ratio) const
+    {
+        DrawKey key;
+        if (!GetDrawCache() || !getStructure(key.structure)) {
+            plainDraw(image, imscale, jac, xoff, yoff, flux_ratio);
+            return;
+        }
+        key.structure.add("draw");
+        AddBounds(key.structure, image);
+        key.structure.add(imscale).add(xoff).add(yoff).add(flux_ratio);
+        if (jac) key.structure.add(jac[0]).add(jac[1]).add(jac[2]).add(jac[3]);
+        shared_ptr<DrawResult<T> > result = DrawCache<T>::cache.get(key, [&]() {
+            return new DrawResult<T>(image.getBounds(), [&](ImageView<T> im) {
+                plainDraw(im, imscale, jac, xoff, yoff, flux_ratio);
+            });
+        });
+        image.copyFrom(result->getImage());
+    }
+
+    template <typename T>
+    void SBProfile::drawK(ImageView<std::complex<T> > image, double imscale, double* jac) const
+    {
+        DrawKey key;
+        if (!GetDrawCache() || !getStructure(key.structure)) {
+            plainDrawK(image, imscale, jac);
+            return;
+        }
+        key.structure.add("drawK");
+        AddBounds(key.structure, image);
+        key.structure.add(imscale);
+        if (jac) key.structure.add(jac[0]).add(jac[1]).add(jac[2]).add(jac[3]);
+        shared_ptr<DrawResult<std::complex<T> > > result =
+            DrawCache<std::complex<T> >::cache.get(key, [&]() {
+                return new DrawResult<std::complex<T> >(
+                    image.getBounds(), [&](ImageView<std::complex<T> > im) {
+                        plainDrawK(im, imscale, jac);
+                    });
+            });
+        image.copyFrom(result->getImage());
+    }
+
     template void SBProfile::draw(ImageView<float> image, double dx,
                                   double* jac, double xoff, double yoff, double flux_ratio) const;
     template void SBProfile::draw(ImageView<double> image, double dx,
@@ -609,6 +873,18 @@ namespace galsim {
     template void SBProfile::SBProfileImpl::defaultFillKImage(
         ImageView<std::complex<float> > im,
         double kx0, double dkx, double dkxy, double ky0, double dky, double dkyx) const;
+    template void SBProfile::SBProfileImpl::defaultMultiplyKImage(
+        ImageView<std::complex<double> > im,
+        double kx0, double dkx, int izero, double ky0, double dky, int jzero) const;
+    template void SBProfile::SBProfileImpl::defaultMultiplyKImage(
+        ImageView<std::complex<float> > im,
+        double kx0, double dkx, int izero, double ky0, double dky, int jzero) const;
+    template void SBProfile::SBProfileImpl::defaultMultiplyKImage(
+        ImageView<std::complex<double> > im,
+        double kx0, double dkx, double dkxy, double ky0, double dky, double dkyx) const;
+    template void SBProfile::SBProfileImpl::defaultMultiplyKImage(
+        ImageView<std::complex<float> > im,
+        double kx0, double dkx, double dkxy, double ky0, double dky, double dkyx) const;
 
     template void SBProfile::SBProfileImpl::fillXImageQuadrant(
         ImageView<double> im,
@@ -19,8 +19,11 @@
 
 //#define DEBUGLOGGING
 
+#include <atomic>
 #include "SBSecondKick.h"
 #include "SBSecondKickImpl.h"
+#include "TableCache.h"
+#include "Random.h"
 #include "SBVonKarmanImpl.h"
 #include "fmath/fmath.hpp"
 #include "math/Bessel.h"
@@ -170,6 +173,10 @@ namespace galsim {
         return result;
     }
 
+    // The version of the algorithm used to build the kValue lookup table.  Increment this whenever
+    // that changes, so that tables saved in the table cache by older code are not used.
+    static const int SECOND_KICK_KV_TABLE_VERSION = 1;
+
     void SKInfo::_buildKVLUT() {
         // Start with 10x the regular Kolmogorov maxk (fairly arbitrarily)
         _maxk = 10*std::pow(-std::log(_gsparams->kvalue_accuracy),3./5.);
@@ -194,6 +201,15 @@ namespace galsim {
         double dk = _gsparams->table_spacing * sqrt(sqrt(_gsparams->kvalue_accuracy / 10.0));
         xdbg<<"Using dk = "<<dk<<'\n';
 
+        // This is the slow part, so first check whether another process has already built it.
+        TableCacheKey key("SecondKickKV", SECOND_KICK_KV_TABLE_VERSION, *_gsparams);
+        key.add(_kcrit);
+        std::vector<double> values(1);
+        if (LoadCachedTable(key, _kvLUT, values)) {
+            _maxk = values[0];
+            return;
+        }
+
         double k=0.;
         _kvLUT.addEntry(0, 1.-_delta);
         for (k=dk; k<1.; k+=dk) {
@@ -225,6 +241,8 @@ namespace galsim {
         }
         _kvLUT.finalize();
         xdbg<<"kvLUT.size() = "<<_kvLUT.size()<<'\n';
+        values[0] = _maxk;
+        SaveCachedTable(key, _kvLUT, values);
         //set_verbose(1);
     }
 
@@ -283,6 +301,10 @@ namespace galsim {
         return result;
     }
 
+    // The version of the algorithm used to build the radial table.  Increment this whenever
+    // that changes, so that tables saved in the table cache by older code are not used.
+    static const int SECOND_KICK_RADIAL_TABLE_VERSION = 1;
+
     void SKInfo::_buildRadial() {
         //set_verbose(2);
         if (_delta > 1.-_gsparams->folding_threshold) {
@@ -301,77 +323,90 @@ namespace galsim {
             return;
         }
 
-        double val = xValueRaw(0.0);
-        xdbg<<"f(0) = "<<val<<std::endl;
-
-        double dr = _gsparams->table_spacing * sqrt(sqrt(_gsparams->xvalue_accuracy / 10.));
-
-        // Along the way accumulate the flux integral to determine the radius
-        // that encloses (1-folding_threshold) of the flux.
-        double thresh0 = (0.5 - _delta) / (2.*M_PI*dr);
-        double thresh1 = (1.-_delta-_gsparams->folding_threshold) / (2.*M_PI*dr);
-        double thresh2 = (1.-_delta-_gsparams->shoot_accuracy) / (2.*M_PI*dr);
         double R = 0., hlr = 0.;
 
-        _radial.addEntry(0., val);
-        // Smallest reasonable 1/k0 is about 0.06 arcsec, so this maxR corresponds to about
-        // 60 arcsec in that case.
-        double maxR = 1000.;
-        double r = dr;
-        double sum = 0.5*r*val;
-
-        // Continue until accumulate 0.999 of the flux
-        int nsmall=0;
-        for (; r<1.; r+=dr) {
-            val = xValueRaw(r);
-            xdbg<<"f("<<r<<") = "<<val<<std::endl;
-
-            // The result should be positive, but numerical inaccuracies can mean that some
-            // values go negative.  It seems that this happens once all further values are
-            // basically zero, so just stop here if/when this happens.
-            if (val < _gsparams->xvalue_accuracy)
-                nsmall++;
-            else
-                nsmall=0;
-            if (nsmall==5) break;
-            _radial.addEntry(r,val);
-
-            // Accumulate int(r*f(r)) / dr  (i.e. don't include 2*pi*dr factor as part of sum)
-            sum += r * val;
-            dbg<<"sum = "<<sum<<"  thresh1 = "<<thresh1<<"  thesh2 = "<<thresh2<<std::endl;
-            xdbg<<"sum*2*pi*dr "<<sum*2.*M_PI*dr<<std::endl;
-            if (R == 0. && sum > thresh1) R = r;
-            if (hlr == 0. && sum > thresh0) hlr = r;
-        }
-        // Switch to logarithmic binning
-        double expdlogr = std::exp(dr);
-        nsmall=0;
-        for (; r<maxR; r *= expdlogr) {
-            val = xValueRaw(r);
-            xdbg<<"f("<<r<<") = "<<val<<std::endl;
-
-            // The result should be positive, but numerical inaccuracies can mean that some
-            // values go negative.  It seems that this happens once all further values are
-            // basically zero, so just stop here if/when this happens.
-            if (val < _gsparams->xvalue_accuracy)
-                nsmall++;
-            else
-                nsmall=0;
-            if (nsmall==5) break;
-            _radial.addEntry(r,val);
-
-            // Accumulate int(r*f(r)) / dr  (i.e. don't include 2*pi*dr factor as part of sum)
-            sum += r * r * val;
-            dbg<<"sum = "<<sum<<"  thresh1 = "<<thresh1<<"  thesh2 = "<<thresh2<<std::endl;
-            xdbg<<"sum*2*pi*dr "<<sum*2.*M_PI*dr<<std::endl;
-            if (hlr == 0. && sum > thresh0) hlr = r;
-            if (R == 0. && sum > thresh1) R = r;
-            if (sum > thresh2) break;
+        // This is the slow part, so first check whether another process has already built it.
+        TableCacheKey key("SecondKickRadial", SECOND_KICK_RADIAL_TABLE_VERSION, *_gsparams);
+        key.add(_kcrit);
+        std::vector<double> values(2);
+        if (LoadCachedTable(key, _radial, values)) {
+            R = values[0];
+            hlr = values[1];
+        } else {
+            double val = xValueRaw(0.0);
+            xdbg<<"f(0) = "<<val<<std::endl;
+
+            double dr = _gsparams->table_spacing * sqrt(sqrt(_gsparams->xvalue_accuracy / 10.));
+
+            // Along the way accumulate the flux integral to determine the radius
+            // that encloses (1-folding_threshold) of the flux.
+            double thresh0 = (0.5 - _delta) / (2.*M_PI*dr);
+            double thresh1 = (1.-_delta-_gsparams->folding_threshold) / (2.*M_PI*dr);
+            double thresh2 = (1.-_delta-_gsparams->shoot_accuracy) / (2.*M_PI*dr);
+
+            _radial.addEntry(0., val);
+            // Smallest reasonable 1/k0 is about 0.06 arcsec, so this maxR corresponds to about
+            // 60 arcsec in that case.
+            double maxR = 1000.;
+            double r = dr;
+            double sum = 0.5*r*val;
+
+            // Continue until accumulate 0.999 of the flux
+            int nsmall=0;
+            for (; r<1.; r+=dr) {
+                val = xValueRaw(r);
+                xdbg<<"f("<<r<<") = "<<val<<std::endl;
+
+                // The result should be positive, but numerical inaccuracies can mean that some
+                // values go negative.  It seems that this happens once all further values are
+                // basically zero, so just stop here if/when this happens.
+                if (val < _gsparams->xvalue_accuracy)
+                    nsmall++;
+                else
+                    nsmall=0;
+                if (nsmall==5) break;
+                _radial.addEntry(r,val);
+
+                // Accumulate int(r*f(r)) / dr  (i.e. don't include 2*pi*dr factor as part of sum)
+                sum += r * val;
+                dbg<<"sum = "<<sum<<"  thresh1 = "<<thresh1<<"  thesh2 = "<<thresh2<<std::endl;
+                xdbg<<"sum*2*pi*dr "<<sum*2.*M_PI*dr<<std::endl;
+                if (R == 0. && sum > thresh1) R = r;
+                if (hlr == 0. && sum > thresh0) hlr = r;
+            }
+            // Switch to logarithmic binning
+            double expdlogr = std::exp(dr);
+            nsmall=0;
+            for (; r<maxR; r *= expdlogr) {
+                val = xValueRaw(r);
+                xdbg<<"f("<<r<<") = "<<val<<std::endl;
+
+                // The result should be positive, but numerical inaccuracies can mean that some
+                // values go negative.  It seems that this happens once all further values are
+                // basically zero, so just stop here if/when this happens.
+                if (val < _gsparams->xvalue_accuracy)
+                    nsmall++;
+                else
+                    nsmall=0;
+                if (nsmall==5) break;
+                _radial.addEntry(r,val);
+
+                // Accumulate int(r*f(r)) / dr  (i.e. don't include 2*pi*dr factor as part of sum)
+                sum += r * r * val;
+                dbg<<"sum = "<<sum<<"  thresh1 = "<<thresh1<<"  thesh2 = "<<thresh2<<std::endl;
+                xdbg<<"sum*2*pi*dr "<<sum*2.*M_PI*dr<<std::endl;
+                if (hlr == 0. && sum > thresh0) hlr = r;
+                if (R == 0. && sum > thresh1) R = r;
+                if (sum > thresh2) break;
+            }
+            _radial.finalize();
+            dbg<<"Finished building radial function.\n";
+            dbg<<"_radial.size() = "<<_radial.size()<<'\n';
+            dbg<<"sum*2*pi*dr + delta = "<<sum*2.*M_PI*dr+_delta<<"   (should >= 0.999)\n";
+            values[0] = R;
+            values[1] = hlr;
+            SaveCachedTable(key, _radial, values);
         }
-        _radial.finalize();
-        dbg<<"Finished building radial function.\n";
-        dbg<<"_radial.size() = "<<_radial.size()<<'\n';
-        dbg<<"sum*2*pi*dr + delta = "<<sum*2.*M_PI*dr+_delta<<"   (should >= 0.999)\n";
 
         dbg<<"R = "<<R<<std::endl;
         dbg<<"hlr = "<<hlr<<std::endl;
@@ -395,8 +430,16 @@ namespace galsim {
         _sampler->shoot(photons,ud);
     }
 
+    size_t SKInfo::getMemorySize() const
+    {
+        return sizeof(*this)
+            + _radial.getMemorySize() - sizeof(_radial)
+            + _kvLUT.getMemorySize() - sizeof(_kvLUT)
+            + (_sampler ? _sampler->getMemorySize() : 0);
+    }
+
     LRUCache<Tuple<double,GSParamsPtr>,SKInfo>
-        SBSecondKick::SBSecondKickImpl::cache(sbp::max_SK_cache);
+        SBSecondKick::SBSecondKickImpl::cache("SecondKick", sbp::max_SK_cache);
 
     //
     //
@@ -406,26 +449,62 @@ namespace galsim {
     //
     //
 
+    static std::atomic<bool> SK_interpolated(false);
+
+    void SetSecondKickInterpolated(bool interpolated)
+    { SK_interpolated = interpolated; }
+
+    bool GetSecondKickInterpolated()
+    { return SK_interpolated; }
+
     SBSecondKick::SBSecondKickImpl::SBSecondKickImpl(double lam_over_r0, double kcrit, double flux,
                                                      const GSParamsPtr& gsparams) :
         SBProfileImpl(*gsparams),
         _lam_over_r0(lam_over_r0), _k0(2.*M_PI/lam_over_r0), _inv_k0(1./_k0),
         _kcrit(kcrit), _flux(flux), _xnorm(flux * _k0*_k0),
-        _info(cache.get(MakeTuple(kcrit, GSParamsPtr(gsparams))))
-    {}
+        _interpolated(GetSecondKickInterpolated()), _w(0.)
+    {
+        double info_kcrit = kcrit;
+        if (_interpolated) {
+            // Use the two nearest grid values of log(kcrit) and interpolate linearly between them.
+            const double dlogkcrit = sbp::SK_grid_dlogkcrit;
+            double u = std::log(kcrit) / dlogkcrit;
+            double i0 = std::floor(u);
+            _w = u - i0;
+            info_kcrit = std::exp(i0 * dlogkcrit);
+            if (_w > 0.)
+                _info2 = cache.get(MakeTuple(std::exp((i0+1.) * dlogkcrit),
+                                             GSParamsPtr(gsparams)));
+        }
+        _info = cache.get(MakeTuple(info_kcrit, GSParamsPtr(gsparams)));
+    }
 
     double SBSecondKick::SBSecondKickImpl::maxK() const
-    { return _info->maxK()*_k0; }
+    {
+        double maxk = _info->maxK();
+        if (_info2) maxk = std::max(maxk, _info2->maxK());
+        return maxk*_k0;
+    }
 
     double SBSecondKick::SBSecondKickImpl::stepK() const
-    { return _info->stepK()*_k0; }
+    {
+        double stepk = _info->stepK();
+        if (_info2) stepk = std::min(stepk, _info2->stepK());
+        return stepk*_k0;
+    }
 
     double SBSecondKick::SBSecondKickImpl::getDelta() const
-    { return _info->getDelta() * _flux; }
+    {
+        double delta = _info->getDelta();
+        if (_info2) delta = (1.-_w) * delta + _w * _info2->getDelta();
+        return delta * _flux;
+    }
 
     double SBSecondKick::SBSecondKickImpl::structureFunction(double rho) const
     {
-        return _info->structureFunction(rho);
+        double val = _info->structureFunction(rho);
+        if (_info2) val = (1.-_w) * val + _w * _info2->structureFunction(rho);
+        return val;
     }
 
     std::complex<double> SBSecondKick::SBSecondKickImpl::kValue(const Position<double>& p) const
@@ -436,13 +515,19 @@ namespace galsim {
     double SBSecondKick::SBSecondKickImpl::kValue(double k) const
     {
         // k in inverse arcsec
-        return _info->kValue(k*_inv_k0)*_flux;
+        k *= _inv_k0;
+        double val = _info->kValue(k);
+        if (_info2) val = (1.-_w) * val + _w * _info2->kValue(k);
+        return val*_flux;
     }
 
     double SBSecondKick::SBSecondKickImpl::kValueRaw(double k) const
     {
         // k in inverse arcsec
-        return _info->kValueRaw(k*_inv_k0)*_flux;
+        k *= _inv_k0;
+        double val = _info->kValueRaw(k);
+        if (_info2) val = (1.-_w) * val + _w * _info2->kValueRaw(k);
+        return val*_flux;
     }
 
     double SBSecondKick::SBSecondKickImpl::xValue(const Position<double>& p) const
@@ -453,19 +538,28 @@ namespace galsim {
     double SBSecondKick::SBSecondKickImpl::xValue(double r) const
     {
         // r in arcsec
-        return _info->xValue(r*_k0)*_xnorm;
+        r *= _k0;
+        double val = _info->xValue(r);
+        if (_info2) val = (1.-_w) * val + _w * _info2->xValue(r);
+        return val*_xnorm;
     }
 
     double SBSecondKick::SBSecondKickImpl::xValueRaw(double r) const
     {
         // r in arcsec
-        return _info->xValueRaw(r*_k0)*_xnorm;
+        r *= _k0;
+        double val = _info->xValueRaw(r);
+        if (_info2) val = (1.-_w) * val + _w * _info2->xValueRaw(r);
+        return val*_xnorm;
     }
 
     double SBSecondKick::SBSecondKickImpl::xValueExact(double r) const
     {
         // r in arcsec
-        return _info->xValueExact(r*_k0)*_xnorm;
+        r *= _k0;
+        double val = _info->xValueExact(r);
+        if (_info2) val = (1.-_w) * val + _w * _info2->xValueExact(r);
+        return val*_xnorm;
     }
 
     void SBSecondKick::SBSecondKickImpl::shoot(PhotonArray& photons, UniformDeviate ud) const
@@ -473,7 +567,29 @@ namespace galsim {
         dbg<<"SK shoot: N = "<<photons.size()<<std::endl;
         dbg<<"Target flux = "<<getFlux()<<std::endl;
         // Get photons from the SKInfo structure, rescale flux and size for this instance
-        _info->shoot(photons,ud);
+        if (!_info2) {
+            _info->shoot(photons,ud);
+        } else {
+            // Draw each photon from _info2 with probability _w.  The two sets are stored in
+            // separate blocks, so mark the array as correlated.
+            const int N = photons.size();
+            BinomialDeviate bd(ud, N, _w);
+            const int N2 = int(bd());
+            const int N1 = N - N2;
+            if (N1 > 0) {
+                PhotonArray photons1(N1);
+                _info->shoot(photons1,ud);
+                photons1.scaleFlux(double(N1)/N);
+                photons.assignAt(0, photons1);
+            }
+            if (N2 > 0) {
+                PhotonArray photons2(N2);
+                _info2->shoot(photons2,ud);
+                photons2.scaleFlux(double(N2)/N);
+                photons.assignAt(N1, photons2);
+            }
+            photons.setCorrelated();
+        }
         photons.setTotalFlux(getFlux());
         photons.scaleXY(_inv_k0);
         dbg<<"SK Realized flux = "<<photons.getTotalFlux()<<std::endl;
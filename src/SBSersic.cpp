@@ -19,8 +19,10 @@
 
 //#define DEBUGLOGGING
 
+#include <atomic>
 #include "SBSersic.h"
 #include "SBSersicImpl.h"
+#include "TableCache.h"
 #include "integ/Int.h"
 #include "Solve.h"
 #include "math/Bessel.h"
@@ -65,15 +67,24 @@ namespace galsim {
         return static_cast<const SBSersicImpl&>(*_pimpl).getTrunc();
     }
 
-    LRUCache<Tuple<double, double, GSParamsPtr>, SersicInfo>
-        SBSersic::SBSersicImpl::cache(sbp::max_sersic_cache);
+    LRUCache<Tuple<double, double, GSParamsPtr, bool>, SersicInfo>
+        SBSersic::SBSersicImpl::cache("Sersic", sbp::max_sersic_cache);
+
+    static std::atomic<bool> sersic_interpolated_ft(false);
+
+    void SetSersicInterpolatedFT(bool interpolated)
+    { sersic_interpolated_ft = interpolated; }
+
+    bool GetSersicInterpolatedFT()
+    { return sersic_interpolated_ft; }
 
     SBSersic::SBSersicImpl::SBSersicImpl(double n,  double scale_radius, double flux,
                                          double trunc, const GSParams& gsparams) :
         SBProfileImpl(gsparams),
         _n(n), _flux(flux), _r0(scale_radius), _trunc(trunc),
         _r0_sq(_r0*_r0), _inv_r0(1./_r0), _inv_r0_sq(_inv_r0*_inv_r0), _trunc_sq(trunc*trunc),
-        _info(cache.get(MakeTuple(_n, _trunc/_r0, GSParamsPtr(this->gsparams))))
+        _info(cache.get(MakeTuple(_n, _trunc/_r0, GSParamsPtr(this->gsparams),
+                                  GetSersicInterpolatedFT())))
     {
         dbg<<"Start SBSersic constructor:\n";
         dbg<<"n = "<<_n<<std::endl;
@@ -285,10 +296,12 @@ namespace galsim {
     double SBSersic::SBSersicImpl::maxK() const { return _info->maxK() * _inv_r0; }
     double SBSersic::SBSersicImpl::stepK() const { return _info->stepK() * _inv_r0; }
 
-    SersicInfo::SersicInfo(double n, double trunc, const GSParamsPtr& gsparams) :
+    SersicInfo::SersicInfo(double n, double trunc, const GSParamsPtr& gsparams,
+                           bool interpolated) :
         _n(n), _trunc(trunc), _gsparams(gsparams),
         _invn(1./_n), _inv2n(0.5*_invn),
         _trunc_sq(_trunc*_trunc), _truncated(_trunc > 0.),
+        _interpolated(interpolated && !_truncated),
         _gamma2n(std::tgamma(2.*_n)),
         _maxk(0.), _stepk(0.), _re(0.), _flux(0.),
         _ft(Table::spline),
@@ -296,6 +309,7 @@ namespace galsim {
     {
         dbg<<"Start SersicInfo constructor for n = "<<_n<<std::endl;
         dbg<<"trunc = "<<_trunc<<std::endl;
+        dbg<<"interpolated = "<<_interpolated<<std::endl;
 
         if (_n < sbp::minimum_sersic_n || _n > sbp::maximum_sersic_n)
             throw SBError("Requested Sersic index out of range");
@@ -384,8 +398,40 @@ namespace galsim {
         double _invn;
     };
 
+    // The version of the algorithm used to build the Fourier transform table.  Increment this whenever
+    // that changes, so that tables saved in the table cache by older code are not used.
+    static const int SERSIC_FT_TABLE_VERSION = 1;
+
     void SersicInfo::buildFT() const
     {
+        // The table is built after the cache measured this object, so report its size.
+        const size_t bytes = getMemorySize();
+
+        // When interpolating, the table values below come from the grid, which is much
+        // faster than doing the integrals, so we don't use the table cache.
+        shared_ptr<SersicFTGrid> grid;
+        double logre = 0.;
+        if (_interpolated) {
+            grid = SersicFTGrid::cache.get(_gsparams);
+            logre = std::log(getHLR());
+        }
+
+        // Another process may have already built this table.
+        TableCacheKey key("SersicFT", SERSIC_FT_TABLE_VERSION, *_gsparams);
+        key.add(_n).add(_trunc);
+        std::vector<double> values(7);
+        if (!grid && LoadCachedTable(key, _ft, values)) {
+            _kderiv2 = values[0];
+            _kderiv4 = values[1];
+            _ksq_min = values[2];
+            _ksq_max = values[3];
+            _maxk = values[4];
+            _highk_a = values[5];
+            _highk_b = values[6];
+            addMemory(getMemorySize() - bytes);
+            return;
+        }
+
         // The small-k expansion of the Hankel transform is (normalized to have flux=1):
         // 1 - Gamma(4n) / 4 Gamma(2n) + Gamma(6n) / 64 Gamma(2n) - Gamma(8n) / 2304 Gamma(2n)
         // from the series summation J_0(x) = Sum^inf_{m=0} (-1)^m (m!)^-2 (x/2)^2m
@@ -440,25 +486,41 @@ namespace galsim {
         double sf=0., skf=0., sk=0., sk2=0.;
 
         // Don't go past k = 500
+        const double logk0 = std::log(kmin)-0.001;
+        const int nk = int(std::ceil((std::log(500.) - logk0) / dlogk));
         _ksq_max = -1.;
         _maxk = kmin; // Just in case we break on the first iteration.
         SersicRadialFunction I(_invn);
         bool found_maxk = false;
-        for (double logk = std::log(kmin)-0.001; logk < std::log(500.); logk += dlogk) {
+
+        // For untruncated profiles, do all the Hankel transforms at once with FFTLog.
+        // (The truncated profile has a hard edge, which FFTLog does not handle well.)
+        std::vector<double> hankel_vals;
+        if (!grid && !_truncated) {
+            hankel_vals.resize(nk);
+            math::hankel_inf_many(I, logk0, dlogk, nk, 0., hankel_vals.data(),
+                                  _gsparams->integration_relerr,
+                                  _gsparams->integration_abserr*hankel_norm);
+        }
+
+        for (int i=0; i<nk; ++i) {
+            double logk = logk0 + i*dlogk;
             double k = fmath::expd(logk);
             double ksq = k*k;
 
             double val;
-            if (_truncated) {
-                val = math::hankel_trunc(I, k, 0., _trunc,
-                                         _gsparams->integration_relerr,
-                                         _gsparams->integration_abserr*hankel_norm);
+            if (grid) {
+                val = grid->kValue(_n, logk + logre);
             } else {
-                val = math::hankel_inf(I, k, 0.,
-                                       _gsparams->integration_relerr,
-                                       _gsparams->integration_abserr*hankel_norm);
+                if (_truncated) {
+                    val = math::hankel_trunc(I, k, 0., _trunc,
+                                             _gsparams->integration_relerr,
+                                             _gsparams->integration_abserr*hankel_norm);
+                } else {
+                    val = hankel_vals[i];
+                }
+                val /= hankel_norm;
             }
-            val /= hankel_norm;
             xdbg<<"logk = "<<logk<<", ft("<<exp(logk)<<") = "<<val<<"   "<<val*ksq<<std::endl;
 
             double f0 = val * ksq;
@@ -534,6 +596,115 @@ namespace galsim {
                 xdbg<<"maxk => "<<_maxk<<std::endl;
             }
         }
+
+        values[0] = _kderiv2;
+        values[1] = _kderiv4;
+        values[2] = _ksq_min;
+        values[3] = _ksq_max;
+        values[4] = _maxk;
+        values[5] = _highk_a;
+        values[6] = _highk_b;
+        if (!grid) SaveCachedTable(key, _ft, values);
+        addMemory(getMemorySize() - bytes);
+    }
+
+    LRUCache<GSParamsPtr, SersicFTGrid> SersicFTGrid::cache(
+        "SersicGrid", sbp::max_sersic_grid_cache);
+
+    // Estimate the derivative of f along one axis of a grid with uniform spacing h.
+    // Use the fourth order central difference where possible, and second order at the edges.
+    static void GridDerivative(const double* f, double* df, int n, int stride, double h)
+    {
+        for (int i=0; i<n; ++i) {
+            const double* fi = f + i*stride;
+            double d;
+            if (i >= 2 && i < n-2) {
+                d = (8.*(fi[stride] - fi[-stride]) - (fi[2*stride] - fi[-2*stride])) / 12.;
+            } else if (i >= 1 && i < n-1) {
+                d = 0.5 * (fi[stride] - fi[-stride]);
+            } else if (i == 0) {
+                d = -1.5*fi[0] + 2.*fi[stride] - 0.5*fi[2*stride];
+            } else {
+                d = 1.5*fi[0] - 2.*fi[-stride] + 0.5*fi[-2*stride];
+            }
+            df[i*stride] = d / h;
+        }
+    }
+
+    SersicFTGrid::SersicFTGrid(const GSParamsPtr& gsparams)
+    {
+        dbg<<"Start SersicFTGrid constructor\n";
+        const double dn = sbp::sersic_grid_dn;
+        const int nx = int(std::ceil((sbp::maximum_sersic_n - sbp::minimum_sersic_n) / dn)) + 1;
+        // Use the same spacing in log(k) as the SersicInfo tables.
+        const double du = gsparams->table_spacing * sqrt(sqrt(gsparams->kvalue_accuracy / 10.));
+
+        // Build the exact tables at each node, and find the range of u = log(k re) they need.
+        std::vector<shared_ptr<SersicInfo> > nodes(nx);
+        std::vector<double> logre(nx);
+        double umin = 0.;
+        double umax = 0.;
+        _nargs.resize(nx);
+        for (int i=0; i<nx; ++i) {
+            _nargs[i] = std::min(sbp::minimum_sersic_n + i*dn, sbp::maximum_sersic_n);
+            nodes[i].reset(new SersicInfo(_nargs[i], 0., gsparams, false));
+            nodes[i]->buildFT();
+            logre[i] = std::log(nodes[i]->getHLR());
+            double u1 = 0.5*std::log(nodes[i]->_ksq_min) + logre[i];
+            double u2 = std::log(500.) + logre[i];
+            if (i == 0 || u1 < umin) umin = u1;
+            if (i == 0 || u2 > umax) umax = u2;
+        }
+        // Leave some margin, since the range for n between the nodes may be slightly larger.
+        umin -= 1.;
+        umax += 1.;
+        const int ny = int(std::ceil((umax - umin) / du)) + 1;
+        dbg<<"grid size = "<<nx<<" x "<<ny<<std::endl;
+        dbg<<"u range = "<<umin<<" .. "<<umin+(ny-1)*du<<std::endl;
+
+        _uargs.resize(ny);
+        for (int j=0; j<ny; ++j) _uargs[j] = umin + j*du;
+        _vals.resize(nx*ny);
+        for (int i=0; i<nx; ++i) {
+            for (int j=0; j<ny; ++j) {
+                double logk = _uargs[j] - logre[i];
+                _vals[j*nx+i] = nodes[i]->kValue(fmath::expd(2.*logk));
+            }
+        }
+
+        _dfdn.resize(nx*ny);
+        _dfdu.resize(nx*ny);
+        _d2fdndu.resize(nx*ny);
+        for (int j=0; j<ny; ++j)
+            GridDerivative(&_vals[j*nx], &_dfdn[j*nx], nx, 1, dn);
+        for (int i=0; i<nx; ++i) {
+            GridDerivative(&_vals[i], &_dfdu[i], ny, nx, du);
+            GridDerivative(&_dfdn[i], &_d2fdndu[i], ny, nx, du);
+        }
+
+        _table.reset(new Table2D(_nargs.data(), _uargs.data(), _vals.data(), nx, ny,
+                                 _dfdn.data(), _dfdu.data(), _d2fdndu.data(), true));
+    }
+
+    double SersicFTGrid::kValue(double n, double logkre) const
+    {
+        if (logkre <= _uargs.front()) {
+            return _table->lookup(n, _uargs.front());
+        } else if (logkre >= _uargs.back()) {
+            double f = _table->lookup(n, _uargs.back());
+            return f * fmath::expd(-2. * (logkre - _uargs.back()));
+        } else {
+            return _table->lookup(n, logkre);
+        }
+    }
+
+    size_t SersicFTGrid::getMemorySize() const
+    {
+        return sizeof(*this)
+            + (_nargs.capacity() + _uargs.capacity()) * sizeof(double)
+            + (_vals.capacity() + _dfdn.capacity() + _dfdu.capacity() + _d2fdndu.capacity())
+            * sizeof(double)
+            + (_table ? _table->getMemorySize() : 0);
     }
 
     // Function object for finding the r that encloses all except a particular flux fraction.
@@ -774,10 +945,8 @@ namespace galsim {
         return hlr * CalculateTruncatedScale(n, invn, b, trunc/hlr);
     }
 
-    void SersicInfo::shoot(PhotonArray& photons, UniformDeviate ud) const
+    void SersicInfo::checkSampler() const
     {
-        dbg<<"Target flux = 1.0\n";
-
         if (!_sampler) {
             // Set up the classes for photon shooting
             _radial.reset(new SersicRadialFunction(_invn));
@@ -788,13 +957,26 @@ namespace galsim {
             double nominal_flux = 2.*M_PI*_n*_gamma2n * _flux;
             _sampler.reset(new OneDimensionalDeviate(*_radial, range, true, nominal_flux,
                                                      *_gsparams));
+            addMemory(_sampler->getMemorySize());
         }
+    }
 
+    void SersicInfo::shoot(PhotonArray& photons, UniformDeviate ud) const
+    {
+        dbg<<"Target flux = 1.0\n";
+        checkSampler();
         assert(_sampler.get());
         _sampler->shoot(photons,ud);
         dbg<<"SersicInfo Realized flux = "<<photons.getTotalFlux()<<std::endl;
     }
 
+    size_t SersicInfo::getMemorySize() const
+    {
+        return sizeof(*this)
+            + _ft.getMemorySize() - sizeof(_ft)
+            + (_sampler ? _sampler->getMemorySize() : 0);
+    }
+
     void SBSersic::SBSersicImpl::shoot(PhotonArray& photons, UniformDeviate ud) const
     {
         dbg<<"Sersic shoot: N = "<<photons.size()<<std::endl;
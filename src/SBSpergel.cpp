@@ -67,7 +67,7 @@ namespace galsim {
     }
 
     LRUCache<Tuple<double,GSParamsPtr>,SpergelInfo> SBSpergel::SBSpergelImpl::cache(
-        sbp::max_spergel_cache);
+        "Spergel", sbp::max_spergel_cache);
 
     SBSpergel::SBSpergelImpl::SBSpergelImpl(double nu, double scale_radius,
                                             double flux, const GSParams& gsparams) :
@@ -685,7 +685,7 @@ namespace galsim {
         double _b;
     };
 
-    void SpergelInfo::shoot(PhotonArray& photons, UniformDeviate ud) const
+    void SpergelInfo::checkSampler() const
     {
         if (!_sampler) {
             // Set up the classes for photon shooting
@@ -724,13 +724,23 @@ namespace galsim {
                 _sampler.reset(new OneDimensionalDeviate(*_radial, range, true, nominal_flux,
                                                          *_gsparams));
             }
+            addMemory(_sampler->getMemorySize());
         }
+    }
 
+    void SpergelInfo::shoot(PhotonArray& photons, UniformDeviate ud) const
+    {
+        checkSampler();
         assert(_sampler.get());
         _sampler->shoot(photons,ud);
         dbg<<"SpergelInfo Realized flux = "<<photons.getTotalFlux()<<std::endl;
     }
 
+    size_t SpergelInfo::getMemorySize() const
+    {
+        return sizeof(*this) + (_sampler ? _sampler->getMemorySize() : 0);
+    }
+
     void SBSpergel::SBSpergelImpl::shoot(PhotonArray& photons, UniformDeviate ud) const
     {
         dbg<<"Spergel shoot: N = "<<photons.size()<<std::endl;
@@ -503,6 +503,47 @@ namespace galsim {
         return _kValue(_adaptee,fwdT(k),_fluxScaling,k,_cen);
     }
 
+    void SBTransform::SBTransformImpl::xValueMany(const double* x, const double* y, double* val,
+                                                  int N) const
+    {
+        // Write out inv() explicitly, so the loop doesn't go through the function pointer.
+        // (For the identity case, this gives the same values.)
+        // Work in fixed-size chunks, so small batches (e.g. from the real-space convolution
+        // integrals) don't need any heap allocation.
+        const int nchunk = 64;
+        double u[nchunk], v[nchunk];
+        for (int i0=0; i0<N; i0+=nchunk) {
+            const int n = std::min(nchunk, N-i0);
+            for (int i=0; i<n; ++i) {
+                double xx = x[i0+i] - _cen.x;
+                double yy = y[i0+i] - _cen.y;
+                u[i] = _invdet * (_mD*xx - _mB*yy);
+                v[i] = _invdet * (-_mC*xx + _mA*yy);
+            }
+            _adaptee.xValueMany(u, v, val+i0, n);
+        }
+        for (int i=0; i<N; ++i) val[i] *= _ampScaling;
+    }
+
+    void SBTransform::SBTransformImpl::kValueMany(const double* kx, const double* ky,
+                                                  std::complex<double>* val, int N) const
+    {
+        std::vector<double> u(N), v(N);
+        for (int i=0; i<N; ++i) {
+            u[i] = _mA*kx[i] + _mC*ky[i];
+            v[i] = _mB*kx[i] + _mD*ky[i];
+        }
+        _adaptee.kValueMany(&u[0], &v[0], val, N);
+        if (_zeroCen) {
+            // Match kValue, which skips the flux scaling if it is within kvalue_accuracy of 1.
+            if (std::abs(_fluxScaling-1.) >= this->gsparams.kvalue_accuracy)
+                for (int i=0; i<N; ++i) val[i] *= _fluxScaling;
+        } else {
+            for (int i=0; i<N; ++i)
+                val[i] *= std::polar(_fluxScaling, -kx[i]*_cen.x-ky[i]*_cen.y);
+        }
+    }
+
     std::complex<double> SBTransform::SBTransformImpl::kValueNoPhase(
         const Position<double>& k) const
     { return _kValueNoPhase(_adaptee,fwdT(k),_fluxScaling,k,_cen); }
@@ -886,8 +927,22 @@ namespace galsim {
     void SBTransform::SBTransformImpl::fillKImage(ImageView<std::complex<T> > im,
                                                   double kx0, double dkx, int izero,
                                                   double ky0, double dky, int jzero) const
+    { fillOrMultiplyKImage(im,kx0,dkx,izero,ky0,dky,jzero,false); }
+
+    template <typename T>
+    void SBTransform::SBTransformImpl::multiplyKImage(ImageView<std::complex<T> > im,
+                                                      double kx0, double dkx, int izero,
+                                                      double ky0, double dky, int jzero) const
+    { fillOrMultiplyKImage(im,kx0,dkx,izero,ky0,dky,jzero,true); }
+
+    // The phases and flux scaling are applied in place, so they work the same way whether
+    // the adaptee's values were written into im or multiplied into it.
+    template <typename T>
+    void SBTransform::SBTransformImpl::fillOrMultiplyKImage(
+        ImageView<std::complex<T> > im, double kx0, double dkx, int izero,
+        double ky0, double dky, int jzero, bool multiply) const
     {
-        dbg<<"SBTransform fillKImage\n";
+        dbg<<"SBTransform "<<(multiply ? "multiplyKImage" : "fillKImage")<<"\n";
         dbg<<"kx = "<<kx0<<" + i * "<<dkx<<", izero = "<<izero<<std::endl;
         dbg<<"ky = "<<ky0<<" + j * "<<dky<<", jzero = "<<jzero<<std::endl;
         dbg<<"A,B,C,D = "<<_mA<<','<<_mB<<','<<_mC<<','<<_mD<<std::endl;
@@ -902,7 +957,11 @@ namespace galsim {
             double fwdT_ky0 = _mD * ky0;
             double fwdT_dky = _mD * dky;
 
-            GetImpl(_adaptee)->fillKImage(im,fwdT_kx0,fwdT_dkx,izero,fwdT_ky0,fwdT_dky,jzero);
+            if (multiply)
+                GetImpl(_adaptee)->multiplyKImage(im,fwdT_kx0,fwdT_dkx,izero,
+                                                  fwdT_ky0,fwdT_dky,jzero);
+            else
+                GetImpl(_adaptee)->fillKImage(im,fwdT_kx0,fwdT_dkx,izero,fwdT_ky0,fwdT_dky,jzero);
         } else {
             Position<double> fwdT0 = fwdT(Position<double>(kx0,ky0));
             Position<double> fwdT1 = fwdT(Position<double>(dkx,0.));
@@ -911,7 +970,11 @@ namespace galsim {
             xdbg<<"fwdT1 = "<<fwdT1<<std::endl;
             xdbg<<"fwdT2 = "<<fwdT2<<std::endl;
 
-            GetImpl(_adaptee)->fillKImage(im,fwdT0.x,fwdT1.x,fwdT2.x,fwdT0.y,fwdT2.y,fwdT1.y);
+            if (multiply)
+                GetImpl(_adaptee)->multiplyKImage(im,fwdT0.x,fwdT1.x,fwdT2.x,
+                                                  fwdT0.y,fwdT2.y,fwdT1.y);
+            else
+                GetImpl(_adaptee)->fillKImage(im,fwdT0.x,fwdT1.x,fwdT2.x,fwdT0.y,fwdT2.y,fwdT1.y);
         }
 
         // Apply phases
@@ -929,8 +992,20 @@ namespace galsim {
     void SBTransform::SBTransformImpl::fillKImage(ImageView<std::complex<T> > im,
                                                   double kx0, double dkx, double dkxy,
                                                   double ky0, double dky, double dkyx) const
+    { fillOrMultiplyKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx,false); }
+
+    template <typename T>
+    void SBTransform::SBTransformImpl::multiplyKImage(ImageView<std::complex<T> > im,
+                                                      double kx0, double dkx, double dkxy,
+                                                      double ky0, double dky, double dkyx) const
+    { fillOrMultiplyKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx,true); }
+
+    template <typename T>
+    void SBTransform::SBTransformImpl::fillOrMultiplyKImage(
+        ImageView<std::complex<T> > im, double kx0, double dkx, double dkxy,
+        double ky0, double dky, double dkyx, bool multiply) const
     {
-        dbg<<"SBTransform fillKImage\n";
+        dbg<<"SBTransform "<<(multiply ? "multiplyKImage" : "fillKImage")<<"\n";
         dbg<<"kx = "<<kx0<<" + i * "<<dkx<<" + j * "<<dkxy<<std::endl;
         dbg<<"ky = "<<ky0<<" + i * "<<dkyx<<" + j * "<<dky<<std::endl;
         dbg<<"A,B,C,D = "<<_mA<<','<<_mB<<','<<_mC<<','<<_mD<<std::endl;
@@ -955,7 +1030,10 @@ namespace galsim {
         xdbg<<"fwdT1 = "<<fwdT1<<std::endl;
         xdbg<<"fwdT2 = "<<fwdT2<<std::endl;
 
-        GetImpl(_adaptee)->fillKImage(im,fwdT0.x,fwdT1.x,fwdT2.x,fwdT0.y,fwdT2.y,fwdT1.y);
+        if (multiply)
+            GetImpl(_adaptee)->multiplyKImage(im,fwdT0.x,fwdT1.x,fwdT2.x,fwdT0.y,fwdT2.y,fwdT1.y);
+        else
+            GetImpl(_adaptee)->fillKImage(im,fwdT0.x,fwdT1.x,fwdT2.x,fwdT0.y,fwdT2.y,fwdT1.y);
 
         // Apply phase terms = |det| exp(-i(kx*cenx + ky*ceny))
         if (_zeroCen) {
@@ -976,10 +1054,7 @@ namespace galsim {
         // Simple job here: just remap coords of each photon, then change flux
         // If there is overall magnification in the transform
         _adaptee.shoot(photons,ud);
-        for (int i=0; i<N; i++) {
-            Position<double> xy = fwd(Position<double>(photons.getX(i), photons.getY(i)))+_cen;
-            photons.setPhoton(i, xy.x, xy.y, photons.getFlux(i)*_fluxScaling);
-        }
+        photons.transform(_mA, _mB, _mC, _mD, _cen.x, _cen.y, _fluxScaling);
         dbg<<"Distort Realized flux = "<<photons.getTotalFlux()<<std::endl;
     }
 
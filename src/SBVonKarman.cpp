@@ -19,8 +19,11 @@
 
 //#define DEBUGLOGGING
 
+#include <atomic>
 #include "SBVonKarman.h"
 #include "SBVonKarmanImpl.h"
+#include "TableCache.h"
+#include "Random.h"
 #include "Solve.h"
 #include "math/Bessel.h"
 #include "math/Gamma.h"
@@ -231,69 +234,95 @@ namespace galsim {
         return r < _radial.argMax() ? _radial(r) : 0.;
     }
 
+    // The version of the algorithm used to build the radial table.  Increment this whenever
+    // that changes, so that tables saved in the table cache by older code are not used.
+    static const int VON_KARMAN_RADIAL_TABLE_VERSION = 1;
+
     void VonKarmanInfo::_buildRadialFunc() const {
         dbg<<"Start buildRadialFunc:\n";
+        // The table is built after the cache measured this object, so report its size.
+        const size_t bytes = getMemorySize();
         dbg<<"lam = "<<_lam<<std::endl;
         dbg<<"L0 = "<<_L0<<std::endl;
         dbg<<"doDelta = "<<_doDelta<<"  "<<_delta<<"  "<<_deltaScale<<std::endl;
         //set_verbose(2);
-        double val = rawXValue(0.0); // This is the value without the delta function (clearly).
-        _radial.addEntry(0., val);
-        dbg<<"L0^5/3 = "<<_L053<<std::endl;
-        dbg<<"f(0) = "<<val<<" arcsec^-2\n";
-
-        // For small values of r, the function goes as
-        // f(r) = f0 (1 - C r^2)
-        // The following formula for C is completely empirical, but it's close enough for
-        // estimating a good value of r0 to start at, which is all we use this for.
-        double C = (1.4 * pow(_L0,-2./3.) + 0.0767417) / (_lam_arcsec * _lam_arcsec);
-#ifdef DEBUGLOGGING
-        double f0 = val;
-        double f1 = rawXValue(1.e-2);
-        double f2 = rawXValue(2.e-2);
-        // For very small values of L0, this value of C is a bit too small, so there is probably
-        // another term in the Taylor expansion starting to come into play. Maybe an L0^-4/3 term.
-        dbg<<"C = "<<C<<std::endl;
-        dbg<<"f(1.e-2) = "<<f1<<"  "<<f0 * (1.-C*1.e-4)<<std::endl;
-        dbg<<"f(2.e-2) = "<<f2<<"  "<<f0 * (1.-C*4.e-4)<<std::endl;
-#endif
-        // Start at r0 where f(r0) - f(0) ~= xvalue_accuracy.
-        double r0 = sqrt(_gsparams->xvalue_accuracy / (val * C));
-
         double dlogr = _gsparams->table_spacing * sqrt(sqrt(_gsparams->xvalue_accuracy / 10.));
-
-        dbg<<"r0 = "<<r0<<" arcsec\n";
         dbg<<"dlogr = "<<dlogr<<"\n";
-
-        double sum = 0.0;
-        if (_doDelta) sum += _delta;
-
-        xdbg<<"sum = "<<sum<<'\n';
-
-        // We accumulate the sum without the 2 pi dlogr factors for efficiency.
-        // So the relevant thresholds we want are:
-        double thresh0 = 0.5 / (2.*M_PI*dlogr);
-        double thresh2 = (1.-_gsparams->shoot_accuracy) / (2.*M_PI*dlogr);
-        dbg<<"thresh = "<<thresh0<<"  "<<thresh2<<std::endl;
-        _hlr = 0.;
         const double maxR = 60.0; // hard cut at 1 arcminute.
-        for(double logr=log(r0); logr<log(maxR) && sum < thresh2; logr+=dlogr) {
-            double r = exp(logr);
-            val = rawXValue(r);
-            dbg<<"f("<<r<<") = "<<val<<std::endl;
-            _radial.addEntry(r, val);
-
-            // Accumulate integral int(r f(r) dr) = int(r^2 f(r) dlogr), but without dlogr factor,
-            // since it is constant for all terms.  (Also not including 2pi which would be in
-            // the normal integral for the enclosed flux.)
-            sum += val*r*r;
-            dbg<<"sum = "<<sum<<'\n';
-
-            if (_hlr == 0. && sum > thresh0) _hlr = r;
+
+        // This is the slow part, so first check whether another process has already built it.
+        TableCacheKey key("VonKarmanRadial", VON_KARMAN_RADIAL_TABLE_VERSION, *_gsparams);
+        key.add(_lam).add(_L0).add(_doDelta);
+        std::vector<double> values(1);
+        if (LoadCachedTable(key, _radial, values)) {
+            _hlr = values[0];
+        } else {
+            double val = rawXValue(0.0); // This is the value without the delta function (clearly).
+            _radial.addEntry(0., val);
+            dbg<<"L0^5/3 = "<<_L053<<std::endl;
+            dbg<<"f(0) = "<<val<<" arcsec^-2\n";
+
+            // For small values of r, the function goes as
+            // f(r) = f0 (1 - C r^2)
+            // The following formula for C is completely empirical, but it's close enough for
+            // estimating a good value of r0 to start at, which is all we use this for.
+            double C = (1.4 * pow(_L0,-2./3.) + 0.0767417) / (_lam_arcsec * _lam_arcsec);
+#ifdef DEBUGLOGGING
+            double f0 = val;
+            double f1 = rawXValue(1.e-2);
+            double f2 = rawXValue(2.e-2);
+            // For very small values of L0, this value of C is a bit too small, so there is
+            // probably another term in the Taylor expansion starting to come into play.
+            // Maybe an L0^-4/3 term.
+            dbg<<"C = "<<C<<std::endl;
+            dbg<<"f(1.e-2) = "<<f1<<"  "<<f0 * (1.-C*1.e-4)<<std::endl;
+            dbg<<"f(2.e-2) = "<<f2<<"  "<<f0 * (1.-C*4.e-4)<<std::endl;
+#endif
+            // Start at r0 where f(r0) - f(0) ~= xvalue_accuracy.
+            double r0 = sqrt(_gsparams->xvalue_accuracy / (val * C));
+
+            dbg<<"r0 = "<<r0<<" arcsec\n";
+
+            double sum = 0.0;
+            if (_doDelta) sum += _delta;
+
+            xdbg<<"sum = "<<sum<<'\n';
+
+            // We accumulate the sum without the 2 pi dlogr factors for efficiency.
+            // So the relevant thresholds we want are:
+            double thresh0 = 0.5 / (2.*M_PI*dlogr);
+            double thresh2 = (1.-_gsparams->shoot_accuracy) / (2.*M_PI*dlogr);
+            dbg<<"thresh = "<<thresh0<<"  "<<thresh2<<std::endl;
+            _hlr = 0.;
+
+            // Do all the Hankel transforms at once with FFTLog.
+            const double logr0 = log(r0);
+            const int nr = int(std::ceil((log(maxR) - logr0) / dlogr));
+            std::vector<double> xvals(std::max(nr, 0));
+            math::hankel_inf_many(VKXIntegrand(*this), logr0, dlogr, nr, 0., xvals.data(),
+                                  _gsparams->integration_relerr,
+                                  _gsparams->integration_abserr);
+
+            for(int i=0; i<nr && sum < thresh2; ++i) {
+                double r = exp(logr0 + i*dlogr);
+                val = xvals[i] / (2.*M_PI);
+                dbg<<"f("<<r<<") = "<<val<<std::endl;
+                _radial.addEntry(r, val);
+
+                // Accumulate integral int(r f(r) dr) = int(r^2 f(r) dlogr), but without dlogr
+                // factor, since it is constant for all terms.  (Also not including 2pi which
+                // would be in the normal integral for the enclosed flux.)
+                sum += val*r*r;
+                dbg<<"sum = "<<sum<<'\n';
+
+                if (_hlr == 0. && sum > thresh0) _hlr = r;
+            }
+            _radial.finalize();
+            if (_hlr == 0.)
+                throw SBError("Cannot find von Karman half-light-radius.");
+            values[0] = _hlr;
+            SaveCachedTable(key, _radial, values);
         }
-        _radial.finalize();
-        if (_hlr == 0.)
-            throw SBError("Cannot find von Karman half-light-radius.");
         dbg<<"Finished building radial function.\n";
         dbg<<"HLR = "<<_hlr<<" arcsec\n";
 
@@ -334,18 +363,24 @@ namespace galsim {
         std::vector<double> range(2, 0.);
         range[1] = _radial.argMax();
         _sampler.reset(new OneDimensionalDeviate(_radial, range, true, 1.0, *_gsparams));
+        addMemory(getMemorySize() - bytes);
     }
 
     void VonKarmanInfo::shoot(PhotonArray& photons, UniformDeviate ud) const
     {
-        if (!_sampler)
-            _buildRadialFunc();
-
+        checkSampler();
         _sampler->shoot(photons,ud);
     }
 
+    size_t VonKarmanInfo::getMemorySize() const
+    {
+        return sizeof(*this)
+            + _radial.getMemorySize() - sizeof(_radial)
+            + (_sampler ? _sampler->getMemorySize() : 0);
+    }
+
     LRUCache<Tuple<double,double,bool,GSParamsPtr,double>,VonKarmanInfo>
-        SBVonKarman::SBVonKarmanImpl::cache(sbp::max_vonKarman_cache);
+        SBVonKarman::SBVonKarmanImpl::cache("VonKarman", sbp::max_vonKarman_cache);
 
     //
     //
@@ -355,6 +390,14 @@ namespace galsim {
     //
     //
 
+    static std::atomic<bool> vonKarman_interpolated(false);
+
+    void SetVonKarmanInterpolated(bool interpolated)
+    { vonKarman_interpolated = interpolated; }
+
+    bool GetVonKarmanInterpolated()
+    { return vonKarman_interpolated; }
+
     SBVonKarman::SBVonKarmanImpl::SBVonKarmanImpl(double lam, double r0, double L0, double flux,
                                                   double scale, bool doDelta,
                                                   const GSParams& gsparams, double force_stepk) :
@@ -365,20 +408,58 @@ namespace galsim {
         _flux(flux),
         _scale(scale),
         _doDelta(doDelta),
-        _info(cache.get(MakeTuple(1e-9*lam/r0, L0/r0, doDelta, GSParamsPtr(gsparams), force_stepk/_scale)))
-    {}
+        _interpolated(GetVonKarmanInterpolated()),
+        _c(1.), _w(0.)
+    {
+        double lam_r0 = 1e-9*lam/r0;
+        double L0_r0 = L0/r0;
+        if (_interpolated) {
+            // lam/r0 only sets the size of the profile, so build the infos at a reference
+            // value and rescale by _c.  L0/r0 changes the shape, so use the two nearest grid
+            // values of log(L0/r0) and interpolate linearly between them.
+            _c = lam_r0 / sbp::vonKarman_grid_lam;
+            lam_r0 = sbp::vonKarman_grid_lam;
+            const double dlogL0 = sbp::vonKarman_grid_dlogL0;
+            double u = std::log(L0_r0) / dlogL0;
+            double i0 = std::floor(u);
+            _w = u - i0;
+            L0_r0 = std::exp(i0 * dlogL0);
+            if (_w > 0.) {
+                _info2 = cache.get(MakeTuple(lam_r0, std::exp((i0+1.) * dlogL0), doDelta,
+                                             GSParamsPtr(gsparams), force_stepk*_c/_scale));
+            }
+        }
+        _info = cache.get(MakeTuple(lam_r0, L0_r0, doDelta, GSParamsPtr(gsparams),
+                                    force_stepk*_c/_scale));
+    }
 
     double SBVonKarman::SBVonKarmanImpl::maxK() const
-    { return _info->maxK()*_scale; }
+    {
+        double maxk = _info->maxK();
+        if (_info2) maxk = std::max(maxk, _info2->maxK());
+        return maxk/_c*_scale;
+    }
 
     double SBVonKarman::SBVonKarmanImpl::stepK() const
-    { return _info->stepK()*_scale; }
+    {
+        double stepk = _info->stepK();
+        if (_info2) stepk = std::min(stepk, _info2->stepK());
+        return stepk/_c*_scale;
+    }
 
     double SBVonKarman::SBVonKarmanImpl::getDelta() const
-    { return _info->getDelta()*_flux; }
+    {
+        double delta = _info->getDelta();
+        if (_info2) delta = (1.-_w) * delta + _w * _info2->getDelta();
+        return delta*_flux;
+    }
 
     double SBVonKarman::SBVonKarmanImpl::getHalfLightRadius() const
-    { return _info->getHalfLightRadius()/_scale; }
+    {
+        double hlr = _info->getHalfLightRadius();
+        if (_info2) hlr = (1.-_w) * hlr + _w * _info2->getHalfLightRadius();
+        return hlr*_c/_scale;
+    }
 
     double SBVonKarman::SBVonKarmanImpl::structureFunction(double rho) const
     {
@@ -390,13 +471,13 @@ namespace galsim {
     std::complex<double> SBVonKarman::SBVonKarmanImpl::kValue(const Position<double>& p) const
         // k in units of _scale.
     {
-        return _flux * _info->kValue(sqrt(p.x*p.x+p.y*p.y)/_scale);
+        return _flux * infoKValue(sqrt(p.x*p.x+p.y*p.y)/_scale);
     }
 
     double SBVonKarman::SBVonKarmanImpl::xValue(const Position<double>& p) const
         // r in units of _scale
     {
-        return _flux * _info->xValue(sqrt(p.x*p.x+p.y*p.y)*_scale);
+        return _flux * infoXValue(sqrt(p.x*p.x+p.y*p.y)*_scale);
     }
 
     void SBVonKarman::SBVonKarmanImpl::shoot(PhotonArray& photons, UniformDeviate ud) const
@@ -404,9 +485,31 @@ namespace galsim {
         dbg<<"VonKarman shoot: N = "<<photons.size()<<std::endl;
         dbg<<"Target flux = "<<getFlux()<<std::endl;
         // Get photons from the VonKarmanInfo structure, rescale flux and size for this instance
-         _info->shoot(photons,ud);
+        if (!_info2) {
+            _info->shoot(photons,ud);
+        } else {
+            // Draw each photon from _info2 with probability _w.  The two sets are stored in
+            // separate blocks, so mark the array as correlated.
+            const int N = photons.size();
+            BinomialDeviate bd(ud, N, _w);
+            const int N2 = int(bd());
+            const int N1 = N - N2;
+            if (N1 > 0) {
+                PhotonArray photons1(N1);
+                _info->shoot(photons1,ud);
+                photons1.scaleFlux(double(N1)/N);
+                photons.assignAt(0, photons1);
+            }
+            if (N2 > 0) {
+                PhotonArray photons2(N2);
+                _info2->shoot(photons2,ud);
+                photons2.scaleFlux(double(N2)/N);
+                photons.assignAt(N1, photons2);
+            }
+            photons.setCorrelated();
+        }
         photons.scaleFlux(_flux);
-        photons.scaleXY(_scale);
+        photons.scaleXY(_scale*_c);
         dbg<<"VonKarman Realized flux = "<<photons.getTotalFlux()<<std::endl;
     }
 
@@ -438,7 +541,7 @@ namespace galsim {
                 double x = x0;
                 double ysq = y0*y0;
                 for (int i=0; i<m; ++i,x+=dx)
-                    *ptr++ = _flux * _info->xValue(sqrt(x*x + ysq));
+                    *ptr++ = _flux * infoXValue(sqrt(x*x + ysq));
             }
         }
     }
@@ -468,7 +571,7 @@ namespace galsim {
             double x = x0;
             double y = y0;
             for (int i=0; i<m; ++i,x+=dx,y+=dyx)
-                *ptr++ = _flux * _info->xValue(sqrt(x*x + y*y));
+                *ptr++ = _flux * infoXValue(sqrt(x*x + y*y));
         }
     }
 
@@ -500,7 +603,7 @@ namespace galsim {
                 double kx = kx0;
                 double kysq = ky0*ky0;
                 for (int i=0;i<m;++i,kx+=dkx)
-                    *ptr++ = _flux * _info->kValue(kx*kx+kysq);
+                    *ptr++ = _flux * infoKValue(sqrt(kx*kx+kysq));
             }
         }
     }
@@ -530,7 +633,7 @@ namespace galsim {
             double kx = kx0;
             double ky = ky0;
             for (int i=0; i<m; ++i,kx+=dkx,ky+=dkyx)
-                *ptr++ = _flux * _info->kValue(kx*kx+ky*ky);
+                *ptr++ = _flux * infoKValue(sqrt(kx*kx+ky*ky));
         }
     }
 
@@ -32,6 +32,11 @@
 
 namespace galsim {
 
+    // The interpMany-type functions work on batches of this many values at a time.
+    // If there are at least MIN_PARALLEL_BATCHES of them, they are done in parallel.
+    const int BATCH_SIZE = 1024;
+    const int MIN_PARALLEL_BATCHES = 8;
+
     // ArgVec
     // A class to represent an argument vector for a Table or Table2D.
     class ArgVec
@@ -39,7 +44,9 @@ namespace galsim {
     public:
         ArgVec(const double* args, int n);
 
-        int upperIndex(double a) const;
+        // Returns i such that _vec[i-1] <= a <= _vec[i].  This is thread-safe.
+        // hint is an optional guess for the result, owned by the caller.
+        int upperIndex(double a, int hint=0) const;
         void upperIndexMany(const double* a, int* idx, int N) const;
 
         // A few things to look similar to a vector<dobule>
@@ -50,17 +57,29 @@ namespace galsim {
         double operator[](int i) const { return _vec[i]; }
         size_t size() const { return _n; }
 
+        // The memory used by the guide table.  The args themselves are owned by someone else.
+        size_t getMemorySize() const { return _guide.capacity() * sizeof(int); }
+
     private:
+        // Use the guide table (or a binary search if there isn't one) to find the index.
+        int guideIndex(double a) const;
+
         const double* _vec;
         int _n;
         // A few convenient additional member variables.
         double _lower_slop, _upper_slop;
         bool _equalSpaced;
         double _da;
-        mutable int _lastIndex;
+        // If the args are equally spaced in log(a), we can also find the index directly.
+        bool _logSpaced;
+        double _logfront, _dloga;
+        // Otherwise, _guide[k] is the upperIndex of front() + k/_guideScale, so the index
+        // for any a is in a small range _guide[k].._guide[k+1].
+        std::vector<int> _guide;
+        double _guideScale;
     };
 
-    ArgVec::ArgVec(const double* vec, int n): _vec(vec), _n(n)
+    ArgVec::ArgVec(const double* vec, int n): _vec(vec), _n(n), _logSpaced(false)
     {
         xdbg<<"Make ArgVec from vector starting with: "<<vec[0]<<std::endl;
         const double tolerance = 0.01;
@@ -69,13 +88,69 @@ namespace galsim {
         for (int i=1; i<_n; i++) {
             if (std::abs((_vec[i] - _vec[0])/_da - i) > tolerance) _equalSpaced = false;
         }
-        _lastIndex = 1;
         _lower_slop = (_vec[1]-_vec[0]) * 1.e-6;
         _upper_slop = (_vec[_n-1]-_vec[_n-2]) * 1.e-6;
+        if (_equalSpaced) return;
+
+        if (front() > 0.) {
+            _logfront = std::log(front());
+            _dloga = (std::log(back()) - _logfront) / (_n-1);
+            _logSpaced = true;
+            for (int i=1; i<_n; i++) {
+                if (std::abs((std::log(_vec[i]) - _logfront)/_dloga - i) > tolerance) {
+                    _logSpaced = false;
+                    break;
+                }
+            }
+        }
+        if (_logSpaced) return;
+
+        // Use enough bins that each one holds at most ~2 cells of the finest spacing,
+        // but don't let a few very close args make the guide table too large.
+        double min_da = _vec[1] - _vec[0];
+        for (int i=2; i<_n; i++) min_da = std::min(min_da, _vec[i] - _vec[i-1]);
+        double nbin = std::ceil((back() - front()) / min_da);
+        int nguide = int(std::max(double(_n-1), std::min(nbin, 8.*(_n-1))));
+        _guideScale = nguide / (back() - front());
+        _guide.resize(nguide+1);
+        int i = 1;
+        for (int k=0; k<nguide; k++) {
+            double edge = front() + k / _guideScale;
+            while (i < _n-1 && _vec[i] < edge) ++i;
+            _guide[k] = i;
+        }
+        _guide[nguide] = _n-1;
+        xdbg<<"Built guide table with "<<nguide<<" bins\n";
+    }
+
+    int ArgVec::guideIndex(double a) const
+    {
+        int lo = 1;
+        int hi = _n-1;
+        if (!_guide.empty()) {
+            int nguide = int(_guide.size()) - 1;
+            int k = int((a - front()) * _guideScale);
+            if (k < 0) k = 0;
+            if (k >= nguide) k = nguide-1;
+            // Only trust the window if it really brackets a.  (It might not from rounding
+            // errors when a is very close to a bin edge.)
+            if (a > _vec[_guide[k]-1] && a <= _vec[_guide[k+1]]) {
+                lo = _guide[k];
+                hi = _guide[k+1];
+            }
+        }
+        const double* p = std::lower_bound(begin()+lo, begin()+hi+1, a);
+        xassert(p != begin()+hi+1);
+        return p-begin();
     }
 
-    // Look up an index.  Use STL binary search.
-    int ArgVec::upperIndex(double a) const
+    // Look up an index.
+    //
+    // This doesn't keep any state in the ArgVec, so it is safe to call from multiple threads
+    // on the same table.  The caller may pass an index (typically the result of a previous
+    // call) as a hint, in which case we check that cell and its neighbors before using the
+    // guide table.  Values of hint outside 1.._n-1 are ignored.
+    int ArgVec::upperIndex(double a, int hint) const
     {
         // check for slop
         if (a < front()) return 1;
@@ -90,49 +165,28 @@ namespace galsim {
             if (i <= 0) i = 1;
             xdbg<<"i => "<<i<<std::endl;
             return i;
-        } else {
-            xdbg<<"Not equal spaced\n";
-            xdbg<<"lastIndex = "<<_lastIndex<<"  "<<_vec[_lastIndex-1]<<" "<<_vec[_lastIndex]<<std::endl;
-            xassert(_lastIndex >= 1);
-            xassert(_lastIndex < _n);
-
-            if ( a < _vec[_lastIndex-1] ) {
-                xdbg<<"Go lower\n";
-                xassert(_lastIndex-2 >= 0);
+        }
+
+        if (_logSpaced) {
+            // The spacing is only equal to within a tolerance, so use this as the hint
+            // rather than the answer.
+            hint = int(std::ceil((std::log(a) - _logfront) / _dloga));
+            if (hint >= _n) hint = _n-1;
+            if (hint <= 0) hint = 1;
+        }
+        if (hint >= 1 && hint < _n) {
+            xdbg<<"hint = "<<hint<<"  "<<_vec[hint-1]<<" "<<_vec[hint]<<std::endl;
+            if (a < _vec[hint-1]) {
                 // Check to see if the previous one is it.
-                if (a >= _vec[_lastIndex-2]) {
-                    xdbg<<"Previous works: "<<_vec[_lastIndex-2]<<std::endl;
-                    return --_lastIndex;
-                } else {
-                    // Look for the entry from 0.._lastIndex-1:
-                    const double* p = std::upper_bound(begin(), begin()+_lastIndex-1, a);
-                    xassert(p != begin());
-                    xassert(p != begin()+_lastIndex-1);
-                    _lastIndex = p-begin();
-                    xdbg<<"Success: "<<_lastIndex<<"  "<<_vec[_lastIndex]<<std::endl;
-                    return _lastIndex;
-                }
-            } else if (a > _vec[_lastIndex]) {
-                xassert(_lastIndex+1 < _n);
+                if (hint > 1 && a >= _vec[hint-2]) return hint-1;
+            } else if (a > _vec[hint]) {
                 // Check to see if the next one is it.
-                if (a <= _vec[_lastIndex+1]) {
-                    xdbg<<"Next works: "<<_vec[_lastIndex+1]<<std::endl;
-                    return ++_lastIndex;
-                } else {
-                    // Look for the entry from _lastIndex..end
-                    const double* p = std::lower_bound(begin()+_lastIndex+1, end(), a);
-                    xassert(p != begin()+_lastIndex+1);
-                    xassert(p != end());
-                    _lastIndex = p-begin();
-                    xdbg<<"Success: "<<_lastIndex<<"  "<<_vec[_lastIndex]<<std::endl;
-                    return _lastIndex;
-                }
+                if (hint+1 < _n && a <= _vec[hint+1]) return hint+1;
             } else {
-                xdbg<<"lastindex is still good.\n";
-                // Then _lastIndex is correct.
-                return _lastIndex;
+                return hint;
             }
         }
+        return guideIndex(a);
     }
 
     void ArgVec::upperIndexMany(const double* a, int* indices, int N) const
@@ -141,72 +195,30 @@ namespace galsim {
         if (_equalSpaced) {
             xdbg << "Equal spaced\n";
             xdbg << "da = "<<_da<<'\n';
+            // This is the same calculation as in upperIndex, but written without std::ceil
+            // and branches, so the compiler can vectorize it.
+            const double maxt = _n;
             for (int k=0; k<N; k++) {
-                xdbg<<"a[k] = "<<a[k]<<std::endl;
-                int idx = int(std::ceil((a[k]-front()) / _da));
-                if (idx >= _n) idx = _n-1; // in case of rounding error or off the edge
-                if (idx <= 0) idx = 1;
-                xdbg << "idx = "<<idx<<'\n';
+                double t = std::max(0., std::min((a[k]-front()) / _da, maxt));
+                int idx = int(t);
+                idx += (idx < t);  // ceil
+                idx = std::max(1, std::min(idx, _n-1));
                 indices[k] = idx;
             }
         } else {
             xdbg << "Not equal spaced\n";
+            // Successive values are usually close together, so use each result as the
+            // hint for the next one.  (This is ignored if the args are log spaced.)
             int idx = 1;
             double lowerBound = _vec[0];
             double upperBound = _vec[1];
-
             for (int k=0; k<N; k++) {
-                xassert(idx >= 1);
-                xassert(idx < _n);
-                if (a[k] < front()) {
-                    indices[k] = 1;
-                    continue;
-                }
-                if (a[k] > back()) {
-                    indices[k] = _n - 1;
-                    continue;
-                }
-                if (a[k] < lowerBound) { // Go lower
-                    xdbg << "Go lower\n";
-                    xassert(idx-2 >= 0);
-                    if (a[k] >= _vec[idx-2]) {  // Check previous index
-                        xdbg << "Previous works  "<<_vec[idx-2]<<'\n';
-                        --idx;
-                        indices[k] = idx;
-                        upperBound = lowerBound;
-                        lowerBound = _vec[idx-1];
-                    } else {
-                        const double* p = std::upper_bound(begin(), begin()+idx-1, a[k]);
-                        xassert(p != begin());
-                        xassert(p != begin()+idx-1);
-                        idx = p-begin();
-                        indices[k] = idx;
-                        upperBound = _vec[idx];
-                        lowerBound = _vec[idx-1];
-                        xdbg << "Sucess: "<<idx<<" "<<upperBound<<'\n';
-                    }
-                } else if (a[k] > upperBound) { //Go higher
-                    xdbg << "Go higher\n";
-                    xassert(idx+1 < _n);
-                    if (a[k] <= _vec[idx+1]) { // Check next index
-                        xdbg << "Next works  "<<_vec[idx-2]<<'\n';
-                        ++idx;
-                        indices[k] = idx;
-                        lowerBound = upperBound;
-                        upperBound = _vec[idx];
-                    } else {
-                        const double* p = std::lower_bound(begin()+idx+1, end(), a[k]);
-                        xassert(p != begin()+idx+1);
-                        xassert(p != end());
-                        idx = p-begin();
-                        indices[k] = idx;
-                        upperBound = _vec[idx];
-                        lowerBound = _vec[idx-1];
-                        xdbg << "Sucess: "<<idx<<" "<<upperBound<<'\n';
-                    }
-                } else {
-                    indices[k] = idx;
+                if (!(a[k] >= lowerBound && a[k] <= upperBound)) {
+                    idx = upperIndex(a[k], idx);
+                    lowerBound = _vec[idx-1];
+                    upperBound = _vec[idx];
                 }
+                indices[k] = idx;
             }
         }
     }
@@ -237,6 +249,7 @@ namespace galsim {
         double argMin() const { return _args.front(); }
         double argMax() const { return _args.back(); }
         int size() const { return _n; }
+        virtual size_t getMemorySize() const = 0;
         inline double getArg(int i) const { return _args[i]; }
         inline double getVal(int i) const { return _vals[i]; }
 
@@ -262,6 +275,12 @@ namespace galsim {
             return _args.upperIndex(a);
         }
 
+        // The args and vals arrays are owned by someone else, so don't count them here.
+        // But the guide table in _args is ours.
+        size_t getMemorySize() const override {
+            return sizeof(T) + _args.getMemorySize();
+        }
+
         double interp(double a, int i) const override {
             if (!(a >= _slop_min && a <= _slop_max))
                 throw std::runtime_error("invalid argument to Table.interp");
@@ -269,12 +288,33 @@ namespace galsim {
         }
 
         void interpMany(const double* xvec, double* valvec, int N) const override {
-            std::vector<int> indices(N);
-            _args.upperIndexMany(xvec, indices.data(), N);
-
-            for (int k=0; k<N; k++) {
-                valvec[k] = interp(xvec[k], indices[k]);
+            // Work in batches, each of which checks its range of values in one pass, finds
+            // the indices, and then calls the interpolation kernel directly.
+            // Large arrays do the batches in parallel.
+            const int nbatch = (N + BATCH_SIZE - 1) / BATCH_SIZE;
+            bool bad = false;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(||:bad) if (nbatch >= MIN_PARALLEL_BATCHES)
+#endif
+            for (int b=0; b<nbatch; b++) {
+                int indices[BATCH_SIZE];
+                const int k1 = b * BATCH_SIZE;
+                const int n = std::min(BATCH_SIZE, N - k1);
+                const double* x = xvec + k1;
+                double* val = valvec + k1;
+                bool ok = true;
+                for (int k=0; k<n; k++) ok &= (x[k] >= _slop_min) & (x[k] <= _slop_max);
+                if (!ok) {
+                    // Can't throw from here, since we might be in a parallel region.
+                    bad = true;
+                    continue;
+                }
+                _args.upperIndexMany(x, indices, n);
+                for (int k=0; k<n; k++) {
+                    val[k] = static_cast<const T*>(this)->_interp(x[k], indices[k]);
+                }
             }
+            if (bad) throw std::runtime_error("invalid argument to Table.interp");
         }
 
         double integrate(double xmin, double xmax) const override
@@ -626,6 +666,9 @@ namespace galsim {
             return step;
         }
 
+        size_t getMemorySize() const override
+        { return TCRTP<TSpline>::getMemorySize() + _y2.capacity() * sizeof(double); }
+
     private:
         std::vector<double> _y2;
         void setupSpline();
@@ -777,6 +820,9 @@ namespace galsim {
     size_t Table::size() const
     { return _pimpl->size(); }
 
+    size_t Table::getMemorySize() const
+    { return sizeof(*this) + (_pimpl ? _pimpl->getMemorySize() : 0); }
+
     //lookup and interpolate function value.
     double Table::operator()(double a) const
     {
@@ -829,6 +875,7 @@ namespace galsim {
                                   double* dfdxvec, double* dfdyvec, int N) const = 0;
         virtual void gradientGrid(const double* xvec, const double* yvec,
                                   double* dfdxvec, double* dfdyvec, int Nx, int Ny) const = 0;
+        virtual size_t getMemorySize() const = 0;
         virtual ~Table2DImpl() {}
     protected:
         const ArgVec _xargs;
@@ -844,6 +891,11 @@ namespace galsim {
     public:
         using Table2D::Table2DImpl::Table2DImpl;
 
+        // As for Table, the args and vals arrays are owned by someone else.
+        size_t getMemorySize() const {
+            return sizeof(T) + _xargs.getMemorySize() + _yargs.getMemorySize();
+        }
+
         double lookup(double x, double y) const {
             int i = _xargs.upperIndex(x);
             int j = _yargs.upperIndex(y);
@@ -851,15 +903,22 @@ namespace galsim {
         }
 
         void interpMany(const double* xvec, const double* yvec, double* valvec, int N) const {
-            std::vector<int> xindices(N);
-            std::vector<int> yindices(N);
-            _xargs.upperIndexMany(xvec, xindices.data(), N);
-            _yargs.upperIndexMany(yvec, yindices.data(), N);
-
-            for (int k=0; k<N; k++) {
-                valvec[k] = static_cast<const T*>(this)->interp(
-                    xvec[k], yvec[k], xindices[k], yindices[k]
-                );
+            const int nbatch = (N + BATCH_SIZE - 1) / BATCH_SIZE;
+#ifdef _OPENMP
+#pragma omp parallel for if (T::thread_safe && nbatch >= MIN_PARALLEL_BATCHES)
+#endif
+            for (int b=0; b<nbatch; b++) {
+                int xindices[BATCH_SIZE];
+                int yindices[BATCH_SIZE];
+                const int k1 = b * BATCH_SIZE;
+                const int n = std::min(BATCH_SIZE, N - k1);
+                _xargs.upperIndexMany(xvec + k1, xindices, n);
+                _yargs.upperIndexMany(yvec + k1, yindices, n);
+                for (int k=0; k<n; k++) {
+                    valvec[k1+k] = static_cast<const T*>(this)->interp(
+                        xvec[k1+k], yvec[k1+k], xindices[k], yindices[k]
+                    );
+                }
             }
         }
 
@@ -869,9 +928,13 @@ namespace galsim {
             _xargs.upperIndexMany(xvec, xindices.data(), Nx);
             _yargs.upperIndexMany(yvec, yindices.data(), Ny);
 
-            for (int ky=0, k=0; ky<Ny; ky++) {
-                for (int kx=0; kx<Nx; kx++, k++) {
-                    valvec[k] = static_cast<const T*>(this)->interp(
+#ifdef _OPENMP
+#pragma omp parallel for if (T::thread_safe && long(Nx)*Ny >= MIN_PARALLEL_BATCHES*BATCH_SIZE)
+#endif
+            for (int ky=0; ky<Ny; ky++) {
+                double* val = valvec + long(ky)*Nx;
+                for (int kx=0; kx<Nx; kx++) {
+                    val[kx] = static_cast<const T*>(this)->interp(
                         xvec[kx], yvec[ky], xindices[kx], yindices[ky]
                     );
                 }
@@ -886,15 +949,24 @@ namespace galsim {
 
         void gradientMany(const double* xvec, const double* yvec,
                           double* dfdxvec, double* dfdyvec, int N) const {
-            std::vector<int> xindices(N);
-            std::vector<int> yindices(N);
-            _xargs.upperIndexMany(xvec, xindices.data(), N);
-            _yargs.upperIndexMany(yvec, yindices.data(), N);
-
-            for (int k=0; k<N; k++) {
-                static_cast<const T*>(this)->grad(
-                    xvec[k], yvec[k], xindices[k], yindices[k], dfdxvec[k], dfdyvec[k]
-                );
+            const int nbatch = (N + BATCH_SIZE - 1) / BATCH_SIZE;
+#ifdef _OPENMP
+#pragma omp parallel for if (T::thread_safe && T::has_gradient && \
+                             nbatch >= MIN_PARALLEL_BATCHES)
+#endif
+            for (int b=0; b<nbatch; b++) {
+                int xindices[BATCH_SIZE];
+                int yindices[BATCH_SIZE];
+                const int k1 = b * BATCH_SIZE;
+                const int n = std::min(BATCH_SIZE, N - k1);
+                _xargs.upperIndexMany(xvec + k1, xindices, n);
+                _yargs.upperIndexMany(yvec + k1, yindices, n);
+                for (int k=0; k<n; k++) {
+                    static_cast<const T*>(this)->grad(
+                        xvec[k1+k], yvec[k1+k], xindices[k], yindices[k],
+                        dfdxvec[k1+k], dfdyvec[k1+k]
+                    );
+                }
             }
         }
 
@@ -905,15 +977,27 @@ namespace galsim {
             _xargs.upperIndexMany(xvec, xindices.data(), Nx);
             _yargs.upperIndexMany(yvec, yindices.data(), Ny);
 
-            for (int ky=0, k=0; ky<Ny; ky++) {
-                for (int kx=0; kx<Nx; kx++, k++) {
+#ifdef _OPENMP
+#pragma omp parallel for if (T::thread_safe && T::has_gradient && \
+                             long(Nx)*Ny >= MIN_PARALLEL_BATCHES*BATCH_SIZE)
+#endif
+            for (int ky=0; ky<Ny; ky++) {
+                const long k0 = long(ky)*Nx;
+                for (int kx=0; kx<Nx; kx++) {
                     static_cast<const T*>(this)->grad(
-                        xvec[kx], yvec[ky], xindices[kx], yindices[ky], dfdxvec[k], dfdyvec[k]
+                        xvec[kx], yvec[ky], xindices[kx], yindices[ky],
+                        dfdxvec[k0+kx], dfdyvec[k0+kx]
                     );
                 }
             }
         }
 
+        // Most of the interpolants can be called from multiple threads at once.
+        // Those that can't should set thread_safe to false.  Those whose grad function
+        // just throws an exception should set has_gradient to false, so we don't throw
+        // from inside a parallel region.
+        static constexpr bool thread_safe = true;
+        static constexpr bool has_gradient = true;
     };
 
 
@@ -933,6 +1017,8 @@ namespace galsim {
         void grad(double x, double y, int i, int j, double& dfdx, double& dfdy) const {
             throw std::runtime_error("gradient not implemented for floor interp");
         }
+
+        static constexpr bool has_gradient = false;
     };
 
 
@@ -949,6 +1035,8 @@ namespace galsim {
         void grad(double x, double y, int i, int j, double& dfdx, double& dfdy) const {
             throw std::runtime_error("gradient not implemented for ceil interp");
         }
+
+        static constexpr bool has_gradient = false;
     };
 
 
@@ -965,6 +1053,8 @@ namespace galsim {
         void grad(double x, double y, int i, int j, double& dfdx, double& dfdy) const {
             throw std::runtime_error("gradient not implemented for nearest interp");
         }
+
+        static constexpr bool has_gradient = false;
     };
 
 
@@ -1004,10 +1094,21 @@ namespace galsim {
     class T2DSpline : public T2DCRTP<T2DSpline> {
     public:
         T2DSpline(const double* xargs, const double* yargs, const double* vals, int Nx, int Ny,
-                  const double* dfdx, const double* dfdy, const double* d2fdxdy) :
-            T2DCRTP<T2DSpline>(xargs, yargs, vals, Nx, Ny), _dfdx(dfdx), _dfdy(dfdy), _d2fdxdy(d2fdxdy) {}
+                  const double* dfdx, const double* dfdy, const double* d2fdxdy,
+                  bool precompute) :
+            T2DCRTP<T2DSpline>(xargs, yargs, vals, Nx, Ny), _dfdx(dfdx), _dfdy(dfdy), _d2fdxdy(d2fdxdy)
+        {
+            if (precompute) setupCoeffs();
+        }
+
+        // The derivative arrays are owned by someone else, but _coeffs is ours.
+        size_t getMemorySize() const {
+            return T2DCRTP<T2DSpline>::getMemorySize() + _coeffs.capacity() * sizeof(double);
+        }
 
         double interp(double x, double y, int i, int j) const {
+            if (!_coeffs.empty()) return interpCoeffs(x, y, i, j);
+
             double dxgrid = _xargs[i] - _xargs[i-1];
             double dygrid = _yargs[j] - _yargs[j-1];
             double dx = (x - _xargs[i-1])/dxgrid;
@@ -1027,6 +1128,8 @@ namespace galsim {
         }
 
         void grad(double x, double y, int i, int j, double& dfdx, double& dfdy) const {
+            if (!_coeffs.empty()) return gradCoeffs(x, y, i, j, dfdx, dfdy);
+
             double dxgrid = _xargs[i] - _xargs[i-1];
             double dygrid = _yargs[j] - _yargs[j-1];
             double dx = (x - _xargs[i-1])/dxgrid;
@@ -1081,9 +1184,89 @@ namespace galsim {
             return c + x*(2*b + x*3*a);
         }
 
+        // The bicubic polynomial in each cell is f(dx,dy) = Sum_mn a_mn dx^m dy^n, where
+        // dx and dy run from 0 to 1 across the cell.  This is the same polynomial that the
+        // above functions calculate one dimension at a time.  The 16 coefficients of cell
+        // (i,j) are stored contiguously starting at _coeffs[16*((j-1)*(_nx-1)+i-1)] with
+        // a_mn at index 4n+m.
+        void setupCoeffs()
+        {
+            // The Hermite basis in matrix form: a = M F M^T, where F has the values and
+            // derivatives at the corners.
+            static const double M[4][4] = {
+                { 1., 0., 0., 0. },
+                { 0., 0., 1., 0. },
+                { -3., 3., -2., -1. },
+                { 2., -2., 1., 1. }
+            };
+            _coeffs.resize(16 * size_t(_nx-1) * (_ny-1));
+            for (int j=1; j<_ny; j++) {
+                double dygrid = _yargs[j] - _yargs[j-1];
+                for (int i=1; i<_nx; i++) {
+                    double dxgrid = _xargs[i] - _xargs[i-1];
+                    // F[p][q], with p = (value, x derivative) at x corner (0,1), and similarly
+                    // q for y.  Derivatives are scaled to the unit cell.
+                    double F[4][4];
+                    for (int a=0; a<2; a++) {
+                        for (int b=0; b<2; b++) {
+                            int k = (j-1+b)*_nx + i-1+a;
+                            F[a][b] = _vals[k];
+                            F[2+a][b] = _dfdx[k] * dxgrid;
+                            F[a][2+b] = _dfdy[k] * dygrid;
+                            F[2+a][2+b] = _d2fdxdy[k] * dxgrid * dygrid;
+                        }
+                    }
+                    double MF[4][4];
+                    for (int m=0; m<4; m++) {
+                        for (int q=0; q<4; q++) {
+                            MF[m][q] = 0.;
+                            for (int p=0; p<4; p++) MF[m][q] += M[m][p] * F[p][q];
+                        }
+                    }
+                    double* c = &_coeffs[16 * (size_t(j-1)*(_nx-1) + i-1)];
+                    for (int m=0; m<4; m++) {
+                        for (int n=0; n<4; n++) {
+                            double a = 0.;
+                            for (int q=0; q<4; q++) a += MF[m][q] * M[n][q];
+                            c[4*n+m] = a;
+                        }
+                    }
+                }
+            }
+        }
+
+        double interpCoeffs(double x, double y, int i, int j) const {
+            double dx = (x - _xargs[i-1])/(_xargs[i] - _xargs[i-1]);
+            double dy = (y - _yargs[j-1])/(_yargs[j] - _yargs[j-1]);
+            const double* c = &_coeffs[16 * (size_t(j-1)*(_nx-1) + i-1)];
+            double b0 = c[0] + dx*(c[1] + dx*(c[2] + dx*c[3]));
+            double b1 = c[4] + dx*(c[5] + dx*(c[6] + dx*c[7]));
+            double b2 = c[8] + dx*(c[9] + dx*(c[10] + dx*c[11]));
+            double b3 = c[12] + dx*(c[13] + dx*(c[14] + dx*c[15]));
+            return b0 + dy*(b1 + dy*(b2 + dy*b3));
+        }
+
+        void gradCoeffs(double x, double y, int i, int j, double& dfdx, double& dfdy) const {
+            double dxgrid = _xargs[i] - _xargs[i-1];
+            double dygrid = _yargs[j] - _yargs[j-1];
+            double dx = (x - _xargs[i-1])/dxgrid;
+            double dy = (y - _yargs[j-1])/dygrid;
+            const double* c = &_coeffs[16 * (size_t(j-1)*(_nx-1) + i-1)];
+            double b1 = c[4] + dx*(c[5] + dx*(c[6] + dx*c[7]));
+            double b2 = c[8] + dx*(c[9] + dx*(c[10] + dx*c[11]));
+            double b3 = c[12] + dx*(c[13] + dx*(c[14] + dx*c[15]));
+            double d0 = c[1] + dx*(2.*c[2] + dx*3.*c[3]);
+            double d1 = c[5] + dx*(2.*c[6] + dx*3.*c[7]);
+            double d2 = c[9] + dx*(2.*c[10] + dx*3.*c[11]);
+            double d3 = c[13] + dx*(2.*c[14] + dx*3.*c[15]);
+            dfdx = (d0 + dy*(d1 + dy*(d2 + dy*d3))) / dxgrid;
+            dfdy = (b1 + dy*(2.*b2 + dy*3.*b3)) / dygrid;
+        }
+
         const double* _dfdx;
         const double* _dfdy;
         const double* _d2fdxdy;
+        std::vector<double> _coeffs;
     };
 
 
@@ -1193,6 +1376,10 @@ namespace galsim {
             throw std::runtime_error("gradient not implemented for Interp interp");
         }
 
+        // The y cache below means that only one thread can use this at a time.
+        static constexpr bool thread_safe = false;
+        static constexpr bool has_gradient = false;
+
     private:
         const Interpolant* _gsinterp;
 
@@ -1215,8 +1402,9 @@ namespace galsim {
 
     Table2D::Table2D(const double* xargs, const double* yargs, const double* vals,
                      int Nx, int Ny,
-                     const double* dfdx, const double* dfdy, const double* d2fdxdy) :
-        _pimpl(_makeImpl(xargs, yargs, vals, Nx, Ny, dfdx, dfdy, d2fdxdy)) {}
+                     const double* dfdx, const double* dfdy, const double* d2fdxdy,
+                     bool precompute) :
+        _pimpl(_makeImpl(xargs, yargs, vals, Nx, Ny, dfdx, dfdy, d2fdxdy, precompute)) {}
 
 
     Table2D::Table2D(const double* xargs, const double* yargs, const double* vals,
@@ -1245,9 +1433,10 @@ namespace galsim {
     std::shared_ptr<Table2D::Table2DImpl> Table2D::_makeImpl(
             const double* xargs, const double* yargs, const double* vals,
             int Nx, int Ny,
-            const double* dfdx, const double* dfdy, const double* d2fdxdy)
+            const double* dfdx, const double* dfdy, const double* d2fdxdy, bool precompute)
     {
-            return std::make_shared<T2DSpline>(xargs, yargs, vals, Nx, Ny, dfdx, dfdy, d2fdxdy);
+            return std::make_shared<T2DSpline>(xargs, yargs, vals, Nx, Ny, dfdx, dfdy, d2fdxdy,
+                                               precompute);
     }
 
     std::shared_ptr<Table2D::Table2DImpl> Table2D::_makeImpl(
@@ -1285,6 +1474,9 @@ namespace galsim {
         _pimpl->gradientGrid(xvec, yvec, dfdxvec, dfdyvec, Nx, Ny);
     }
 
+    size_t Table2D::getMemorySize() const
+    { return sizeof(*this) + _pimpl->getMemorySize(); }
+
     void WrapArrayToPeriod(double* x, int n, double x0, double period)
     {
 #ifdef __SSE2__
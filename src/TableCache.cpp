@@ -0,0 +1,234 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2023 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+//#define DEBUGLOGGING
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <stdint.h>
+#include "TableCache.h"
+#include "Version.h"
+
+namespace galsim {
+
+    // Increment this if the file layout changes.
+    static const uint32_t TABLE_CACHE_VERSION = 1;
+    static const char TABLE_CACHE_MAGIC[8] = { 'G','S','T','A','B','L','E','\0' };
+    static const uint32_t TABLE_CACHE_BYTE_ORDER = 0x01020304;
+
+    // The layout of the start of each file.  It is followed by the key (padded to a multiple
+    // of 8 bytes), the values, the table args and the table vals.
+    struct TableCacheHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint64_t key_size;
+        uint64_t nvalues;
+        uint64_t ntable;
+    };
+
+    static inline uint64_t PaddedSize(uint64_t n)
+    { return (n + 7) & ~uint64_t(7); }
+
+    // A hash of the key that is stable across processes and platforms (FNV-1a).
+    // Used for the file name.  The full key is also stored in the file and checked on load.
+    static uint64_t StableHash(const std::string& s)
+    {
+        uint64_t h = 14695981039346656037ULL;
+        for (size_t i=0; i<s.size(); ++i) {
+            h ^= static_cast<unsigned char>(s[i]);
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    static void AddToKey(std::string& key, double x)
+    {
+        // Use hex float notation, so the key is exact.
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), " %a", x);
+        key += buf;
+    }
+
+    TableCacheKey::TableCacheKey(const std::string& name, int table_version,
+                                 const GSParams& gsparams) :
+        _name(name), _key(name)
+    {
+        _key += " GalSim" + version() + " v" + std::to_string(table_version) + " [";
+        AddToKey(_key, gsparams.minimum_fft_size);
+        AddToKey(_key, gsparams.maximum_fft_size);
+        AddToKey(_key, gsparams.folding_threshold);
+        AddToKey(_key, gsparams.stepk_minimum_hlr);
+        AddToKey(_key, gsparams.maxk_threshold);
+        AddToKey(_key, gsparams.kvalue_accuracy);
+        AddToKey(_key, gsparams.xvalue_accuracy);
+        AddToKey(_key, gsparams.table_spacing);
+        AddToKey(_key, gsparams.realspace_relerr);
+        AddToKey(_key, gsparams.realspace_abserr);
+        AddToKey(_key, gsparams.integration_relerr);
+        AddToKey(_key, gsparams.integration_abserr);
+        AddToKey(_key, gsparams.shoot_accuracy);
+        // interpolant_phase_tolerance and interpolant_tables only change how interpolants are
+        // evaluated, not any of the cached tables, so they are left out of the key.
+        _key += " ]";
+    }
+
+    TableCacheKey& TableCacheKey::add(double x)
+    {
+        AddToKey(_key, x);
+        return *this;
+    }
+
+    static std::mutex table_cache_mutex;
+
+    static std::string& TableCacheDir()
+    {
+        // Initialize from the environment the first time.
+        static std::string dir = std::getenv("GALSIM_TABLE_CACHE_DIR") ?
+            std::getenv("GALSIM_TABLE_CACHE_DIR") : "";
+        return dir;
+    }
+
+    void SetTableCacheDir(const std::string& dir)
+    {
+        std::lock_guard<std::mutex> lock(table_cache_mutex);
+        TableCacheDir() = dir;
+    }
+
+    std::string GetTableCacheDir()
+    {
+        std::lock_guard<std::mutex> lock(table_cache_mutex);
+        return TableCacheDir();
+    }
+
+    static std::string TableCacheFileName(const std::string& dir, const TableCacheKey& key)
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%016llx",
+                      static_cast<unsigned long long>(StableHash(key.str())));
+        return dir + "/" + key.getName() + "_" + buf + ".gstable";
+    }
+
+    bool LoadCachedTable(const TableCacheKey& key, TableBuilder& table,
+                         std::vector<double>& values)
+    {
+        std::string dir = GetTableCacheDir();
+        if (dir.empty()) return false;
+        std::string file_name = TableCacheFileName(dir, key);
+        dbg<<"Try to load cached table from "<<file_name<<std::endl;
+
+        int fd = open(file_name.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(TableCacheHeader)) {
+            close(fd);
+            return false;
+        }
+        const size_t file_size = st.st_size;
+        void* map = mmap(0, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) return false;
+
+        const char* data = static_cast<const char*>(map);
+        const TableCacheHeader& header = *reinterpret_cast<const TableCacheHeader*>(data);
+        bool ok = (std::memcmp(header.magic, TABLE_CACHE_MAGIC, 8) == 0 &&
+                   header.version == TABLE_CACHE_VERSION &&
+                   header.byte_order == TABLE_CACHE_BYTE_ORDER &&
+                   header.key_size == key.str().size() &&
+                   header.nvalues == values.size() &&
+                   header.ntable >= 2);
+        const uint64_t key_start = sizeof(TableCacheHeader);
+        const uint64_t values_start = key_start + PaddedSize(header.key_size);
+        const uint64_t table_start = values_start + header.nvalues * sizeof(double);
+        ok = ok && (table_start + 2 * header.ntable * sizeof(double) == file_size);
+        ok = ok && std::memcmp(data + key_start, key.str().data(), header.key_size) == 0;
+        if (ok) {
+            const double* v = reinterpret_cast<const double*>(data + values_start);
+            std::copy(v, v + header.nvalues, values.begin());
+            const double* args = reinterpret_cast<const double*>(data + table_start);
+            const double* vals = args + header.ntable;
+            for (uint64_t i=0; i<header.ntable; ++i) table.addEntry(args[i], vals[i]);
+            table.finalize();
+            dbg<<"Loaded table with "<<header.ntable<<" entries\n";
+        } else {
+            dbg<<"Invalid cache file "<<file_name<<std::endl;
+        }
+        munmap(map, file_size);
+        return ok;
+    }
+
+    void SaveCachedTable(const TableCacheKey& key, const TableBuilder& table,
+                         const std::vector<double>& values)
+    {
+        std::string dir = GetTableCacheDir();
+        if (dir.empty()) return;
+        std::string file_name = TableCacheFileName(dir, key);
+        dbg<<"Save cached table to "<<file_name<<std::endl;
+
+        const std::vector<double>& args = table.getArgs();
+        const std::vector<double>& vals = table.getVals();
+        assert(args.size() == vals.size());
+
+        TableCacheHeader header;
+        std::memcpy(header.magic, TABLE_CACHE_MAGIC, 8);
+        header.version = TABLE_CACHE_VERSION;
+        header.byte_order = TABLE_CACHE_BYTE_ORDER;
+        header.key_size = key.str().size();
+        header.nvalues = values.size();
+        header.ntable = args.size();
+        std::string padding(PaddedSize(header.key_size) - header.key_size, '\0');
+
+        // Write to a unique temporary name and then rename it, so other processes never see
+        // a partially written file.  If two processes write the same table, the last one wins,
+        // which is fine since they are identical.
+        std::ostringstream tmp_name;
+        tmp_name << file_name << ".tmp." << getpid() << "."
+            << std::hash<std::thread::id>()(std::this_thread::get_id());
+        std::FILE* fp = std::fopen(tmp_name.str().c_str(), "wb");
+        if (!fp) {
+            dbg<<"Unable to open "<<tmp_name.str()<<std::endl;
+            return;
+        }
+        bool ok =
+            std::fwrite(&header, sizeof(header), 1, fp) == 1 &&
+            std::fwrite(key.str().data(), 1, header.key_size, fp) == header.key_size &&
+            std::fwrite(padding.data(), 1, padding.size(), fp) == padding.size() &&
+            std::fwrite(values.data(), sizeof(double), values.size(), fp) == values.size() &&
+            std::fwrite(args.data(), sizeof(double), args.size(), fp) == args.size() &&
+            std::fwrite(vals.data(), sizeof(double), vals.size(), fp) == vals.size();
+        ok = (std::fclose(fp) == 0) && ok;
+        if (ok) ok = std::rename(tmp_name.str().c_str(), file_name.c_str()) == 0;
+        if (!ok) {
+            dbg<<"Failed to write "<<file_name<<std::endl;
+            std::remove(tmp_name.str().c_str());
+        }
+    }
+
+}
@@ -63,6 +63,7 @@ using Eigen::VectorXd;
 #include "hsm/PSFCorr.h"
 #include "math/Nan.h"
 #include "Image.h"
+#include "FFTWPlanner.h"
 
 namespace galsim {
 namespace hsm {
@@ -322,9 +323,13 @@ namespace hsm {
         }
 
         // Make the fftw plan
-        fftw_plan plan=fftw_plan_dft_1d(nn, (fftw_complex*) b1, (fftw_complex*) b2,
-                                        isign == 1 ? FFTW_FORWARD : FFTW_BACKWARD,
-                                        FFTW_ESTIMATE);
+        fftw_plan plan;
+        {
+            std::lock_guard<std::mutex> lock(GetFFTWPlannerMutex());
+            plan = fftw_plan_dft_1d(nn, (fftw_complex*) b1, (fftw_complex*) b2,
+                                    isign == 1 ? FFTW_FORWARD : FFTW_BACKWARD,
+                                    FFTW_ESTIMATE);
+        }
         if (plan == NULL) throw HSMError("Invalid FFTW plan");
 
         // Execute the plan.
@@ -337,7 +342,10 @@ namespace hsm {
         }
 
         // Destroy the plan.
-        fftw_destroy_plan(plan);
+        {
+            std::lock_guard<std::mutex> lock(GetFFTWPlannerMutex());
+            fftw_destroy_plan(plan);
+        }
 #else
 
         double *data_i, *data_i1;
@@ -21,12 +21,16 @@
 //#define DEBUGLOGGING
 
 #include <cmath>
+#include <complex>
 #include <vector>
 #include <map>
+#include <mutex>
 #include <functional>
+#include "fftw3.h"
 #include "integ/Int.h"
 #include "math/Hankel.h"
 #include "math/Bessel.h"
+#include "FFTWPlanner.h"
 #include "Std.h"
 
 namespace galsim {
@@ -246,6 +250,138 @@ namespace math {
         }
     }
 
+    // log(Gamma(z)) for complex z, using the Lanczos approximation with g=7, n=9.
+    static std::complex<double> lgamma_complex(std::complex<double> z)
+    {
+        static const double coef[9] = {
+            0.99999999999980993, 676.5203681218851, -1259.1392167224028,
+            771.32342877765313, -176.61502916214059, 12.507343278686905,
+            -0.13857109526572012, 9.9843695780195716e-6, 1.5056327351493116e-7
+        };
+        if (z.real() < 0.5) {
+            // Reflection formula: Gamma(z) Gamma(1-z) = pi / sin(pi z)
+            return std::log(M_PI / std::sin(M_PI * z)) - lgamma_complex(1. - z);
+        }
+        z -= 1.;
+        std::complex<double> x = coef[0];
+        for (int i=1; i<9; ++i) x += coef[i] / (z + double(i));
+        std::complex<double> t = z + 7.5;
+        return 0.5*std::log(2.*M_PI) + (z+0.5)*std::log(t) - t + std::log(x);
+    }
+
+    // One FFTLog transform of g(r) = r^2 f(r) with bias r^q.
+    // The output is F(k_j) for logk_j = y0 + j*dlogk, j = 0..N-1.
+    // The input is sampled at logr_j = -y0 - (N-1-j)*dlogk, so k_j r_(N-1-j) = 1.
+    //
+    // Writing h(r) = g(r) r^-q as a Fourier series in log(r) with coefficients c_m, each term
+    // transforms analytically:
+    //     int_0^inf r^(s-1) J_nu(r) dr = 2^(s-1) Gamma((nu+s)/2) / Gamma((nu-s)/2+1)
+    // with s = q + i eta_m.  The sum over m is then another FFT.
+    static void fftlog(const std::function<double(double)>& f, double nu, double q,
+                       double y0, double dlogk, int N, std::vector<double>& out)
+    {
+        const double x0 = -y0 - (N-1)*dlogk;
+        const double logkr0 = x0 + y0;
+        const double L = N * dlogk;
+        const int Nc = N/2 + 1;
+
+        std::vector<double> h(N);
+        for (int j=0; j<N; ++j) {
+            double r = std::exp(x0 + j*dlogk);
+            h[j] = f(r) * std::pow(r, 2.-q);
+        }
+        std::vector<std::complex<double> > c(Nc);
+        out.resize(N);
+
+        fftw_plan p1, p2;
+        {
+            std::lock_guard<std::mutex> lock(GetFFTWPlannerMutex());
+            p1 = fftw_plan_dft_r2c_1d(N, h.data(), reinterpret_cast<fftw_complex*>(c.data()),
+                                      FFTW_ESTIMATE);
+            p2 = fftw_plan_dft_c2r_1d(N, reinterpret_cast<fftw_complex*>(c.data()), out.data(),
+                                      FFTW_ESTIMATE);
+        }
+        if (p1==NULL || p2==NULL) throw std::runtime_error("fftw_plan cannot be created");
+        fftw_execute(p1);
+
+        // The output is sum_m b_m exp(-2pi i m j/N), which is real, so we can use the c2r
+        // transform (which has the opposite sign in the exponent) on conj(b_m).
+        //
+        // N is a power of 2, so c[N/2] is the Nyquist term, which has no partner at -N/2.
+        // Its basis function is c (-1)^j = c cos(eta x'), with x' measured from the first r.
+        // Splitting the cosine into exp(+-i eta x') and transforming each half (using
+        // U(q-i eta) = conj(U(q+i eta))) gives c Re(U(q+i eta) exp(-i eta logkr0)) (-1)^j at
+        // our k values.  The c2r transform only uses the real part of its Nyquist input, so the
+        // formula for b below is also exact for the Nyquist term.  It doesn't need a special
+        // case.
+        const double log2 = std::log(2.);
+        for (int m=0; m<Nc; ++m) {
+            double eta = 2.*M_PI * m / L;
+            std::complex<double> s(q, eta);
+            std::complex<double> lnU = (s-1.)*log2 + lgamma_complex(0.5*(nu+s))
+                - lgamma_complex(0.5*(nu-s) + 1.);
+            std::complex<double> b = c[m] / double(N) *
+                std::exp(lnU - std::complex<double>(0., eta*logkr0));
+            c[m] = std::conj(b);
+        }
+        fftw_execute(p2);
+        {
+            std::lock_guard<std::mutex> lock(GetFFTWPlannerMutex());
+            fftw_destroy_plan(p1);
+            fftw_destroy_plan(p2);
+        }
+
+        for (int j=0; j<N; ++j) out[j] *= std::exp(-q*(y0 + j*dlogk));
+    }
+
+    void hankel_inf_many(const std::function<double(double)> f, double logk0, double dlogk,
+                         int nk, double nu, double* result,
+                         double relerr, double abserr, int nzeros)
+    {
+        dbg<<"Start hankel_inf_many: "<<logk0<<"  "<<dlogk<<"  "<<nk<<"  "<<nu<<std::endl;
+        if (nk <= 0) return;
+
+        // The bias needs -nu < q < 3/2 for the analytic transforms to converge.  q=1 also
+        // makes h(r) = r f(r) and F(k) k go to zero at small r and k.
+        const double q = 1.;
+        // The transform is periodic in log(k), so pad the range on both sides to keep the
+        // ends from wrapping around onto each other.
+        const double pad = std::log(1.e4);
+
+        int n1 = nk + 2*int(std::ceil(pad/dlogk));
+        int N1 = 1;
+        while (N1 < n1) N1 *= 2;
+        int npad1 = (N1 - nk) / 2;
+        std::vector<double> out1;
+        fftlog(f, nu, q, logk0 - npad1*dlogk, dlogk, N1, out1);
+
+        // Repeat with half the spacing and twice the padding to estimate the error.
+        const double dlogk2 = 0.5 * dlogk;
+        int nk2 = 2*nk - 1;
+        int n2 = nk2 + 2*int(std::ceil(2.*pad/dlogk2));
+        int N2 = 1;
+        while (N2 < n2) N2 *= 2;
+        int npad2 = (N2 - nk2) / 2;
+        std::vector<double> out2;
+        fftlog(f, nu, q, logk0 - npad2*dlogk2, dlogk2, N2, out2);
+        dbg<<"FFTLog sizes = "<<N1<<", "<<N2<<std::endl;
+
+        int nfallback = 0;
+        for (int i=0; i<nk; ++i) {
+            double F1 = out1[npad1 + i];
+            double F2 = out2[npad2 + 2*i];
+            if (std::abs(F2-F1) <= relerr * std::abs(F2) + abserr) {
+                result[i] = F2;
+            } else {
+                xdbg<<"FFTLog values "<<F1<<", "<<F2<<" disagree at logk = "<<logk0+i*dlogk;
+                xdbg<<".  Use hankel_inf.\n";
+                result[i] = hankel_inf(f, std::exp(logk0 + i*dlogk), nu, relerr, abserr, nzeros);
+                ++nfallback;
+            }
+        }
+        dbg<<"Used hankel_inf for "<<nfallback<<" of "<<nk<<" values\n";
+    }
+
     double hankel_trunc(const std::function<double(double)> f, double k, double nu, double rmax,
                         double relerr, double abserr, int nzeros)
     {
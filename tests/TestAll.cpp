@@ -24,8 +24,12 @@
 #include "Test.h"
 #include <iostream>
 
+extern void TestConvolve();
+extern void TestCorrelatedNoise();
 extern void TestImage();
 extern void TestInteg();
+extern void TestLRUCache();
+extern void TestPhotonArray();
 extern void TestVersion();
 
 int main()
@@ -33,10 +37,18 @@ int main()
     try {
         std::cout<<"Start C++ tests.\n";
         // Run them all here:
+        TestConvolve();
+        std::cout<<"TestConvolve passed all tests.\n";
+        TestCorrelatedNoise();
+        std::cout<<"TestCorrelatedNoise passed all tests.\n";
         TestImage();
         std::cout<<"TestImage passed all tests.\n";
         TestInteg();
         std::cout<<"TestInteg passed all tests.\n";
+        TestLRUCache();
+        std::cout<<"TestLRUCache passed all tests.\n";
+        TestPhotonArray();
+        std::cout<<"TestPhotonArray passed all tests.\n";
         TestVersion();
         std::cout<<"TestVersion passed all tests.\n";
 
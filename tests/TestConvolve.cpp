@@ -0,0 +1,192 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2023 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <list>
+#include <complex>
+#include <cmath>
+
+#include "SBConvolve.h"
+#include "SBGaussian.h"
+#include "SBExponential.h"
+#include "SBMoffat.h"
+#include "SBBox.h"
+#include "SBTransform.h"
+#include "Test.h"
+
+typedef std::complex<double> Complex;
+
+// Draw the convolution of the profiles in plist in k space, and check that it matches the
+// product of the k images of each component, which is what SBConvolve used to compute using
+// a scratch image for each component.
+static void TestKProduct(const std::list<galsim::SBProfile>& plist,
+                         const galsim::Bounds<int>& bounds, double dk, double* jac)
+{
+    galsim::GSParams gsp;
+    galsim::SBConvolve conv(plist, false, gsp);
+    galsim::ImageAlloc<Complex> im(bounds);
+    conv.drawK(im.view(), dk, jac);
+
+    galsim::ImageAlloc<Complex> prod(bounds, Complex(1.,0.));
+    galsim::ImageAlloc<Complex> im1(bounds);
+    for (std::list<galsim::SBProfile>::const_iterator it=plist.begin(); it!=plist.end(); ++it) {
+        it->drawK(im1.view(), dk, jac);
+        prod *= im1;
+    }
+
+    double atol = 1.e-14 * std::abs(prod(0,0));
+    for (int j=bounds.getYMin(); j<=bounds.getYMax(); ++j) {
+        for (int i=bounds.getXMin(); i<=bounds.getXMax(); ++i) {
+            AssertClose(im(i,j), prod(i,j), 1.e-13, atol);
+        }
+    }
+}
+
+// A Gaussian profile with the given covariance matrix and flux.
+static galsim::SBTransform CovGaussian(double cxx, double cxy, double cyy, double flux)
+{
+    galsim::GSParams gsp;
+    // Use the Cholesky decomposition of the covariance as the jacobian of a unit Gaussian.
+    double a = std::sqrt(cxx);
+    double c = cxy / a;
+    double d = std::sqrt(cyy - c*c);
+    const double jac[4] = { a, 0., c, d };
+    return galsim::SBTransform(galsim::SBGaussian(1., flux / (a*d), gsp), jac,
+                               galsim::Position<double>(0.,0.), 1., gsp);
+}
+
+// Draw a real-space convolution and check it against the analytic profile, drawn the same way.
+// The real-space integrals are much more accurate than realspace_relerr for these smooth
+// profiles, so the tolerance is well below that, relative to the peak of the profile.
+static void TestRealSpaceImage(const galsim::SBProfile& conv, const galsim::SBProfile& exact,
+                               const galsim::Bounds<int>& bounds, double dx, double* jac)
+{
+    galsim::ImageAlloc<double> im1(bounds, 0.);
+    galsim::ImageAlloc<double> im2(bounds, 0.);
+    conv.draw(im1.view(), dx, jac, 0., 0., 1.);
+    exact.draw(im2.view(), dx, jac, 0., 0., 1.);
+
+    double atol = 1.e-5 * im2.view().maxAbsElement();
+    for (int j=bounds.getYMin(); j<=bounds.getYMax(); ++j) {
+        for (int i=bounds.getXMin(); i<=bounds.getXMax(); ++i) {
+            AssertClose(im1(i,j), im2(i,j), 0., atol);
+        }
+    }
+}
+
+static void TestRealSpace()
+{
+    Log("Start tests of real-space convolution images");
+    galsim::GSParams gsp;
+    const double s1 = 0.7;
+    const double s2 = 0.5;
+    galsim::SBGaussian g1(s1, 2., gsp);
+    galsim::SBGaussian g2(s2, 1.5, gsp);
+    // A sheared and shifted Gaussian with covariance s2^2 J J^T and flux 1.5 |det J|.
+    const double tjac[4] = { 1.2, 0.3, -0.2, 0.8 };
+    const double tdet = 1.2*0.8 + 0.3*0.2;
+    const double txx = s2*s2*(1.2*1.2 + 0.3*0.3);
+    const double txy = s2*s2*(1.2*-0.2 + 0.3*0.8);
+    const double tyy = s2*s2*(0.2*0.2 + 0.8*0.8);
+    galsim::SBTransform sheared(g2, tjac, galsim::Position<double>(0.,0.), 1., gsp);
+    galsim::SBTransform shifted(g2, tjac, galsim::Position<double>(0.4,-0.3), 1., gsp);
+
+    std::list<galsim::SBProfile> round_pair;
+    round_pair.push_back(g1);
+    round_pair.push_back(g2);
+    std::list<galsim::SBProfile> sheared_pair;
+    sheared_pair.push_back(g1);
+    sheared_pair.push_back(sheared);
+
+    const int nconv = 5;
+    galsim::SBProfile conv[nconv] = {
+        galsim::SBConvolve(round_pair, true, gsp),
+        galsim::SBConvolve(sheared_pair, true, gsp),
+        galsim::SBAutoConvolve(g1, true, gsp),
+        galsim::SBAutoConvolve(sheared, true, gsp),
+        galsim::SBAutoCorrelate(shifted, true, gsp)
+    };
+    galsim::SBProfile exact[nconv] = {
+        CovGaussian(s1*s1 + s2*s2, 0., s1*s1 + s2*s2, 2. * 1.5),
+        CovGaussian(s1*s1 + txx, txy, s1*s1 + tyy, 2. * 1.5*tdet),
+        CovGaussian(2.*s1*s1, 0., 2.*s1*s1, 2. * 2.),
+        CovGaussian(2.*txx, 2.*txy, 2.*tyy, 1.5*tdet * 1.5*tdet),
+        CovGaussian(2.*txx, 2.*txy, 2.*tyy, 1.5*tdet * 1.5*tdet)
+    };
+
+    // Bounds that include the origin, so the axisymmetric profiles can fill a single quadrant,
+    // and bounds that don't.
+    galsim::Bounds<int> b1(-8, 9, -10, 7);
+    galsim::Bounds<int> b2(2, 12, -3, 9);
+    double diag_jac[4] = { 0.9, 0., 0., 1.1 };
+    double shear_jac[4] = { 0.9, 0.2, -0.1, 1.1 };
+    for (int n=0; n<nconv; ++n) {
+        TestRealSpaceImage(conv[n], exact[n], b1, 0.3, 0);
+        TestRealSpaceImage(conv[n], exact[n], b2, 0.3, 0);
+        TestRealSpaceImage(conv[n], exact[n], b1, 0.3, diag_jac);
+        TestRealSpaceImage(conv[n], exact[n], b1, 0.3, shear_jac);
+    }
+}
+
+static void TestKImage()
+{
+    Log("Start tests of SBConvolve k images");
+    galsim::GSParams gsp;
+    const double tjac[4] = { 1.2, 0.4, -0.1, 0.7 };
+    galsim::SBTransform gauss(galsim::SBGaussian(1.3, 2., gsp), tjac,
+                              galsim::Position<double>(0.3,-0.5), 1.5, gsp);
+    galsim::SBExponential exp(0.8, 1.5, gsp);
+    galsim::SBBox box(1.1, 0.7, 1., gsp);
+    galsim::SBMoffat moffat(3., 1.2, 0., 1., gsp);
+
+    std::list<galsim::SBProfile> plist3;
+    plist3.push_back(gauss);
+    plist3.push_back(exp);
+    plist3.push_back(box);
+    std::list<galsim::SBProfile> plist4 = plist3;
+    plist4.push_back(moffat);
+    std::list<galsim::SBProfile> pair;
+    pair.push_back(box);
+    pair.push_back(moffat);
+    std::list<galsim::SBProfile> nested;
+    nested.push_back(exp);
+    nested.push_back(galsim::SBConvolve(pair, false, gsp));
+    nested.push_back(gauss);
+
+    // Bounds with k=0 in the middle, so izero and jzero are used and the strips that
+    // leaf profiles are drawn in straddle ky=0, and bounds laid out the way drawFFT uses them.
+    galsim::Bounds<int> b1(-64, 64, -70, 40);
+    galsim::Bounds<int> b2(0, 64, -64, 63);
+    double shear_jac[4] = { 0.9, 0.2, 0.3, 1.1 };
+    double diag_jac[4] = { 0.9, 0., 0., 1.1 };
+
+    const std::list<galsim::SBProfile>* lists[3] = { &plist3, &plist4, &nested };
+    for (int n=0; n<3; ++n) {
+        TestKProduct(*lists[n], b1, 0.1, 0);
+        TestKProduct(*lists[n], b2, 0.07, 0);
+        TestKProduct(*lists[n], b1, 0.1, diag_jac);
+        TestKProduct(*lists[n], b1, 0.1, shear_jac);
+        TestKProduct(*lists[n], b2, 0.07, shear_jac);
+    }
+}
+
+void TestConvolve()
+{
+    TestKImage();
+    TestRealSpace();
+}
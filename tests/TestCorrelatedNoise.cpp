@@ -0,0 +1,88 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2023 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include "CorrelatedNoise.h"
+#include "SBGaussian.h"
+#include "SBTransform.h"
+#include "Test.h"
+
+// The original, direct calculation of the covariance matrix, evaluating the profile separately
+// for every element of the upper triangle.
+static void DirectCovarianceMatrix(galsim::ImageView<double> cov,
+    const galsim::SBProfile& sbp, const galsim::Bounds<int>& bounds, double dx)
+{
+    int idim = 1 + bounds.getXMax() - bounds.getXMin();
+    int jdim = 1 + bounds.getYMax() - bounds.getYMin();
+    int covdim = idim * jdim;
+    for (int i=1; i<=covdim; i++) {
+        for (int j=i; j<=covdim; j++) {
+            int k = ((j - 1) / jdim) - ((i - 1) / idim);
+            int ell = ((j - 1) % jdim) - ((i - 1) % idim);
+            galsim::Position<double> p(double(k) * dx, double(ell) * dx);
+            cov.setValue(i, j, sbp.xValue(p));
+        }
+    }
+}
+
+static void TestCovarianceMatrix(const galsim::SBProfile& sbp, const galsim::Bounds<int>& bounds,
+                                 double dx)
+{
+    int covdim = (1 + bounds.getXMax() - bounds.getXMin()) *
+        (1 + bounds.getYMax() - bounds.getYMin());
+    galsim::Bounds<int> cov_bounds(1, covdim, 1, covdim);
+    galsim::ImageAlloc<double> cov1(cov_bounds, 0.);
+    galsim::ImageAlloc<double> cov2(cov_bounds, 0.);
+    galsim::ImageView<double> view1 = cov1.view();
+    galsim::calculateCovarianceMatrix(view1, sbp, bounds, dx);
+    DirectCovarianceMatrix(cov2.view(), sbp, bounds, dx);
+
+    // Only the upper triangle is filled.  The rest should be left alone.
+    double atol = 1.e-14 * sbp.xValue(galsim::Position<double>(0.,0.));
+    for (int j=1; j<=covdim; ++j) {
+        for (int i=1; i<=covdim; ++i) {
+            AssertClose(cov1(i,j), cov2(i,j), 1.e-12, atol);
+        }
+    }
+
+    // The lag table has every value in the matrix.
+    galsim::ImageAlloc<double> lags(galsim::covarianceLagBounds(bounds));
+    galsim::calculateCovarianceLags(lags.view(), sbp, dx);
+    for (int ell=lags.getYMin(); ell<=lags.getYMax(); ++ell) {
+        for (int k=lags.getXMin(); k<=lags.getXMax(); ++k) {
+            galsim::Position<double> p(double(k) * dx, double(ell) * dx);
+            AssertClose(lags(k,ell), sbp.xValue(p), 1.e-12, atol);
+        }
+    }
+}
+
+void TestCorrelatedNoise()
+{
+    Log("Start tests of calculateCovarianceMatrix");
+    galsim::GSParams gsp;
+    galsim::SBGaussian gauss(1.7, 3., gsp);
+    const double jac[4] = { 1.1, 0.3, -0.2, 0.8 };
+    galsim::SBTransform sheared(gauss, jac, galsim::Position<double>(0.,0.), 1., gsp);
+
+    // Square and non-square bounds, which use different index conventions for x and y.
+    TestCovarianceMatrix(gauss, galsim::Bounds<int>(1, 6, 1, 6), 0.9);
+    TestCovarianceMatrix(sheared, galsim::Bounds<int>(1, 6, 1, 6), 0.9);
+    TestCovarianceMatrix(sheared, galsim::Bounds<int>(-2, 4, 3, 6), 0.7);
+    TestCovarianceMatrix(sheared, galsim::Bounds<int>(0, 2, 0, 6), 1.3);
+    TestCovarianceMatrix(sheared, galsim::Bounds<int>(0, 0, 0, 0), 1.);
+}
@@ -0,0 +1,191 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2023 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <stdexcept>
+#include <atomic>
+#include <vector>
+#include <memory>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "LRUCache.h"
+#include "Test.h"
+
+// A trivial value type for testing the LRUCache.  It just remembers its key and counts how
+// many of them have been built.
+struct CachedValue
+{
+    CachedValue(int k) : key(k) { ++nbuilt; }
+    size_t getMemorySize() const { return sizeof(*this); }
+    int key;
+    static std::atomic<int> nbuilt;
+};
+std::atomic<int> CachedValue::nbuilt(0);
+
+typedef galsim::LRUCache<int, CachedValue> TestCache;
+
+// A value that builds a table of the given size the first time it is used, and reports
+// that memory to the cache.
+struct LazyValue : public galsim::LRUCacheValue
+{
+    LazyValue(int k) : n(k) {}
+    size_t getMemorySize() const { return sizeof(*this) + table.size() * sizeof(double); }
+    void build() const
+    {
+        if (!table.empty()) return;
+        table.resize(n, 1.);
+        addMemory(n * sizeof(double));
+    }
+    int n;
+    mutable std::vector<double> table;
+};
+
+// Get each key in [k1,k2) from the cache, using multiple threads if available.
+// Returns the number of values that didn't match their key.
+static int GetRange(TestCache& cache, int k1, int k2)
+{
+    int nbad = 0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:nbad)
+#endif
+    for (int k=k1; k<k2; ++k) {
+        if (cache.get(k)->key != k) ++nbad;
+    }
+    return nbad;
+}
+
+static void TestEvictionOrder()
+{
+    Log("Start tests of LRUCache eviction order");
+    // Deliberately use more shards than entries.  The limit is for the cache as a whole.
+    TestCache cache("test_order", 4, 8);
+    AssertEqual(cache.getMaxSize(), 4u);
+
+    for (int k=0; k<4; ++k) cache.get(k);
+    AssertEqual(cache.size(), 4u);
+    AssertEqual(cache.getMisses(), 4);
+    AssertEqual(cache.getEvictions(), 0);
+
+    // Use 0 again, so 1 is now the least recently used.
+    cache.get(0);
+    AssertEqual(cache.getHits(), 1);
+    cache.get(4);
+    AssertEqual(cache.size(), 4u);
+    AssertEqual(cache.getEvictions(), 1);
+
+    // 0, 2, 3, 4 should all still be there.
+    cache.get(0); cache.get(2); cache.get(3); cache.get(4);
+    AssertEqual(cache.getHits(), 5);
+    AssertEqual(cache.getMisses(), 5);
+
+    // But 1 should not be.  Getting it again evicts 0, the least recently used one now.
+    cache.get(1);
+    AssertEqual(cache.getMisses(), 6);
+    AssertEqual(cache.getEvictions(), 2);
+    cache.get(0);
+    AssertEqual(cache.getMisses(), 7);
+
+    cache.clear();
+    AssertEqual(cache.size(), 0u);
+    AssertEqual(cache.getMemorySize(), 0u);
+}
+
+static void TestThreadedCapacity()
+{
+    Log("Start tests of LRUCache capacity with multiple threads");
+    const int nmax = 16;
+    TestCache cache("test_threads", nmax, 8);
+
+    // Fill the cache from several threads.  Regardless of how the keys hash into the shards,
+    // nothing should be evicted until there are more than nmax values.
+    AssertEqual(GetRange(cache, 0, nmax), 0);
+    AssertEqual(cache.size(), size_t(nmax));
+    AssertEqual(cache.getMisses(), nmax);
+    AssertEqual(cache.getEvictions(), 0);
+    AssertEqual(cache.getMemorySize(), nmax * sizeof(CachedValue));
+
+    // Use the second half again, then add nmax/2 new values.  These should replace exactly
+    // the first half, which are the least recently used ones.
+    AssertEqual(GetRange(cache, nmax/2, nmax), 0);
+    AssertEqual(cache.getHits(), nmax/2);
+    for (int k=nmax; k<nmax+nmax/2; ++k) cache.get(k);
+    AssertEqual(cache.size(), size_t(nmax));
+    AssertEqual(cache.getEvictions(), nmax/2);
+
+    int nbuilt = CachedValue::nbuilt;
+    AssertEqual(GetRange(cache, nmax/2, nmax+nmax/2), 0);
+    AssertEqual(int(CachedValue::nbuilt), nbuilt);
+    AssertEqual(cache.getHits(), nmax/2 + nmax);
+
+    // Now hammer it with many more keys than it can hold from all threads at once.
+    // Each key is built only when it is missing, and the cache ends up exactly full.
+    const int ntot = 20000;
+    int nbad = 0;
+    cache.resetStats();
+    nbuilt = CachedValue::nbuilt;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:nbad)
+#endif
+    for (int i=0; i<ntot; ++i) {
+        int k = (i * 7919) % 50;
+        if (cache.get(k)->key != k) ++nbad;
+    }
+    AssertEqual(nbad, 0);
+    AssertEqual(cache.getHits() + cache.getMisses(), ntot);
+    AssertEqual(int(CachedValue::nbuilt) - nbuilt, cache.getMisses());
+    AssertEqual(cache.size(), size_t(nmax));
+    AssertEqual(cache.getMisses() - cache.getEvictions(), 0);
+    AssertEqual(cache.getMemorySize(), nmax * sizeof(CachedValue));
+}
+
+static void TestLazyMemory()
+{
+    Log("Start tests of LRUCache memory of lazily built values");
+    galsim::LRUCache<int, LazyValue> cache("test_lazy", 4);
+
+    cache.get(100);
+    cache.get(1000);
+    AssertEqual(cache.getMemorySize(), 2 * sizeof(LazyValue));
+
+    // Building the table after the value is in the cache adds its memory.
+    cache.get(100)->build();
+    AssertEqual(cache.getMemorySize(), 2 * sizeof(LazyValue) + 100 * sizeof(double));
+    cache.get(1000)->build();
+    AssertEqual(cache.getMemorySize(), 2 * sizeof(LazyValue) + 1100 * sizeof(double));
+
+    // And evicting the value removes all of it again.
+    for (int k=0; k<4; ++k) cache.get(k);
+    AssertEqual(cache.getEvictions(), 2);
+    AssertEqual(cache.getMemorySize(), 4 * sizeof(LazyValue));
+
+    // A value that is no longer in the cache doesn't count any more.
+    std::shared_ptr<LazyValue> value = cache.get(500);
+    for (int k=0; k<4; ++k) cache.get(k);
+    value->build();
+    AssertEqual(cache.getMemorySize(), 4 * sizeof(LazyValue));
+}
+
+void TestLRUCache()
+{
+    TestEvictionOrder();
+    TestThreadedCapacity();
+    TestLazyMemory();
+}
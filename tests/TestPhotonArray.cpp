@@ -0,0 +1,72 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2023 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <vector>
+#include "PhotonArray.h"
+#include "Random.h"
+#include "Test.h"
+
+// Check PhotonArray::transform against the transformation applied one photon at a time.
+// The matrix cases (identity, uniform scale, diagonal, general 2x2) use different code paths,
+// so check each of them, with and without the offset and flux scaling.  The angles are
+// allocated, since they get the same matrix (but no offset).
+static void TestTransform(double mA, double mB, double mC, double mD,
+                          double dx, double dy, double fluxScale)
+{
+    const int N = 37;  // Not a multiple of any likely vector width.
+    std::vector<double> x(N), y(N), flux(N), dxdz(N), dydz(N);
+    galsim::UniformDeviate ud(1234);
+    for (int i=0; i<N; ++i) {
+        x[i] = 2.*ud() - 1.;
+        y[i] = 2.*ud() - 1.;
+        flux[i] = ud();
+        dxdz[i] = 0.1*ud();
+        dydz[i] = 0.1*ud();
+    }
+    std::vector<double> x1(x), y1(y), flux1(flux), dxdz1(dxdz), dydz1(dydz);
+    galsim::PhotonArray photons(N, &x1[0], &y1[0], &flux1[0], &dxdz1[0], &dydz1[0], 0, false);
+    photons.transform(mA, mB, mC, mD, dx, dy, fluxScale);
+
+    for (int i=0; i<N; ++i) {
+        AssertClose(x1[i], mA*x[i] + mB*y[i] + dx, 1.e-15, 1.e-15);
+        AssertClose(y1[i], mC*x[i] + mD*y[i] + dy, 1.e-15, 1.e-15);
+        AssertClose(flux1[i], flux[i] * fluxScale, 1.e-15, 1.e-15);
+        AssertClose(dxdz1[i], mA*dxdz[i] + mB*dydz[i], 1.e-15, 1.e-15);
+        AssertClose(dydz1[i], mC*dxdz[i] + mD*dydz[i], 1.e-15, 1.e-15);
+    }
+}
+
+void TestPhotonArray()
+{
+    // Identity
+    TestTransform(1., 0., 0., 1., 0., 0., 1.);
+    TestTransform(1., 0., 0., 1., 0.3, -0.7, 2.5);
+    // Uniform scale
+    TestTransform(1.7, 0., 0., 1.7, 0., 0., 1.);
+    TestTransform(-0.4, 0., 0., -0.4, 0.3, -0.7, 0.5);
+    // Diagonal
+    TestTransform(1.7, 0., 0., 0.6, 0., 0., 1.);
+    TestTransform(0.9, 0., 0., -1.3, -0.2, 0.1, 3.);
+    // General 2x2, including ones with only one off-diagonal term
+    TestTransform(1.1, 0.3, -0.2, 0.8, 0., 0., 1.);
+    TestTransform(1.1, 0.3, -0.2, 0.8, 0.3, -0.7, 0.7);
+    TestTransform(1., 0.5, 0., 1., 0., 0., 1.);
+    TestTransform(1., 0., -0.5, 1., 1.2, 0., 1.);
+    TestTransform(0., 1., 1., 0., 0., 0., 1.);
+}
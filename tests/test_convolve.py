@@ -474,6 +474,30 @@ def test_realspace_shearconvolve():
             img.array, saved_img.array, 5,
             err_msg="Using GSObject Convolve([pixel,psf]) disagrees with expected result")
 
+@timer
+def test_realspace_image():
+    """Test that drawing a real-space convolution matches xValue at each pixel center.
+    The image is filled in C++ with the setup shared across pixels,
+    so check it against the one-at-a-time calculation, including with a non-diagonal wcs.
+    """
+    box = galsim.Box(1.0, 1.3).shear(g1=0.1, g2=-0.05).shift(0.1, 0.05)
+    gauss = galsim.Gaussian(sigma=0.5)
+    wcs = galsim.JacobianWCS(0.18, 0.02, -0.01, 0.21)
+    offset = galsim.PositionD(0.3, -0.2)
+    for conv in [galsim.Convolve(box, gauss, real_space=True),
+                 galsim.Convolve(gauss, box, real_space=True),
+                 galsim.Convolve(box, galsim.Pixel(0.3), real_space=True),
+                 galsim.AutoConvolve(box, real_space=True),
+                 galsim.AutoCorrelate(box, real_space=True)]:
+        im = conv.drawImage(nx=12, ny=10, wcs=wcs, method='sb', offset=offset, dtype=float)
+        # Check a few pixels against xValue at the corresponding world position.
+        center = im.true_center + offset
+        for x, y in [(1,1), (6,5), (12,3), (4,10)]:
+            pos = wcs.toWorld(galsim.PositionD(x,y) - center)
+            np.testing.assert_allclose(
+                im(x,y), conv.xValue(pos), rtol=1.e-8, atol=1.e-12,
+                err_msg="Real-space image disagrees with xValue for %r"%conv)
+
 @timer
 def test_deconvolve():
     """Test that deconvolution works as expected
@@ -1689,6 +1689,109 @@ def test_direct_scale():
     assert_raises(TypeError, obj.drawPhot, im2, sensor=5)
     assert_raises(ValueError, obj.makePhot, n_photons=-20)
 
+@timer
+def test_draw_cache():
+    """Test the option to save drawn images in a cache.
+    """
+    orig = galsim.utilities.get_draw_cache()
+    galsim.utilities.set_draw_cache(True)
+    assert galsim.utilities.get_draw_cache()
+
+    def make_obj():
+        gal = galsim.Sersic(n=2.3, half_light_radius=1.2).shear(g1=0.1, g2=0.2)
+        psf = galsim.Kolmogorov(fwhm=0.7)
+        return galsim.Convolve(gal, psf)
+
+    # Make the profile from scratch each time.  The second time should be a cache hit.
+    galsim.utilities.reset_profile_cache_stats()
+    im1 = make_obj().drawImage(nx=40, ny=40, scale=0.2, method='no_pixel', offset=(0.3, 0.1))
+    im2 = make_obj().drawImage(nx=40, ny=40, scale=0.2, method='no_pixel', offset=(0.3, 0.1))
+    stats = galsim.utilities.get_profile_cache_stats()
+    assert stats['DrawK<double>']['hits'] >= 1
+    np.testing.assert_array_equal(im2.array, im1.array)
+
+    # The result is the same as without the cache.
+    galsim.utilities.set_draw_cache(False)
+    im3 = make_obj().drawImage(nx=40, ny=40, scale=0.2, method='no_pixel', offset=(0.3, 0.1))
+    np.testing.assert_array_equal(im3.array, im1.array)
+    galsim.utilities.set_draw_cache(True)
+
+    # A different offset, flux or profile is not a hit.
+    im4 = make_obj().drawImage(nx=40, ny=40, scale=0.2, method='no_pixel', offset=(0.4, 0.1))
+    assert not np.array_equal(im4.array, im1.array)
+    im5 = (2*make_obj()).drawImage(nx=40, ny=40, scale=0.2, method='no_pixel', offset=(0.3, 0.1))
+    np.testing.assert_allclose(im5.array, 2*im1.array, rtol=1.e-6, atol=1.e-12)
+    gal = galsim.Gaussian(sigma=1.1)
+    im6 = gal.drawImage(nx=40, ny=40, scale=0.2, method='no_pixel')
+    im7 = gal.dilate(1.01).drawImage(nx=40, ny=40, scale=0.2, method='no_pixel')
+    assert not np.array_equal(im6.array, im7.array)
+
+    # Real-space drawing also uses the cache.
+    galsim.utilities.reset_profile_cache_stats()
+    im8 = galsim.Gaussian(sigma=1.1).drawImage(nx=40, ny=40, scale=0.2, method='no_pixel')
+    stats = galsim.utilities.get_profile_cache_stats()
+    assert stats['Draw<float>']['hits'] >= 1
+    np.testing.assert_array_equal(im8.array, im6.array)
+
+    # The interpolation mode of SecondKick is part of the key, even when the interpolation
+    # weight is 0.  (kcrit = 1 is on the interpolation grid.)
+    orig_sk = galsim.utilities.get_second_kick_interpolated()
+    galsim.utilities.set_second_kick_interpolated(False)
+    galsim.utilities.reset_profile_cache_stats()
+    galsim.SecondKick(lam=700, r0=0.2, diam=4, kcrit=1.).drawImage(nx=16, ny=16, scale=0.2)
+    galsim.utilities.set_second_kick_interpolated(True)
+    galsim.SecondKick(lam=700, r0=0.2, diam=4, kcrit=1.).drawImage(nx=16, ny=16, scale=0.2)
+    stats = galsim.utilities.get_profile_cache_stats()
+    assert stats['DrawK<double>']['hits'] == 0
+    galsim.utilities.set_second_kick_interpolated(orig_sk)
+
+    galsim.utilities.set_draw_cache(orig)
+
+
+@timer
+def test_value_many():
+    """Test that xValueMany and kValueMany match xValue and kValue.
+    """
+    gal = galsim.Sum(galsim.Exponential(half_light_radius=1.2, flux=3).shear(g1=0.2, g2=0.1),
+                     galsim.Gaussian(sigma=0.7, flux=2).shift(0.3, -0.2),
+                     galsim.Moffat(beta=2.5, fwhm=0.9)).dilate(1.1) * 1.7
+    psf = galsim.Kolmogorov(fwhm=0.6)
+    rng = np.random.default_rng(1234)
+    x = rng.uniform(-3, 3, size=(7,11))
+    y = rng.uniform(-3, 3, size=(7,11))
+
+    for obj in [gal, galsim.Gaussian(sigma=1.3), galsim.Exponential(scale_radius=0.4), psf,
+                galsim.Sersic(n=2.5, half_light_radius=1.1).rotate(30*galsim.degrees)]:
+        xv = obj.xValueMany(x, y)
+        assert xv.shape == x.shape
+        xv_ref = [obj.xValue(xx, yy) for xx, yy in zip(x.ravel(), y.ravel())]
+        np.testing.assert_allclose(xv.ravel(), xv_ref, rtol=1.e-12, atol=1.e-14)
+
+    for obj in [gal, psf, galsim.Convolve(gal, psf), galsim.AutoConvolve(gal),
+                galsim.AutoCorrelate(gal), galsim.Deconvolve(psf), galsim.FourierSqrt(gal)]:
+        kv = obj.kValueMany(x, y)
+        assert kv.shape == x.shape
+        assert kv.dtype == complex
+        kv_ref = [obj.kValue(xx, yy) for xx, yy in zip(x.ravel(), y.ravel())]
+        np.testing.assert_allclose(kv.ravel(), kv_ref, rtol=1.e-12, atol=1.e-14)
+
+    # Inputs are broadcast, and scalars work.
+    xv = gal.xValueMany(x[0], 0.3)
+    np.testing.assert_allclose(xv, [gal.xValue(xx, 0.3) for xx in x[0]], rtol=1.e-12)
+    np.testing.assert_allclose(gal.xValueMany(0.1, 0.2), gal.xValue(0.1, 0.2), rtol=1.e-12)
+    np.testing.assert_allclose(gal.kValueMany([0.1, 0.2], 0.),
+                               [gal.kValue(0.1, 0.), gal.kValue(0.2, 0.)], rtol=1.e-12)
+
+    # Objects without a C++ profile fall back to evaluating one point at a time.
+    delta = galsim.DeltaFunction(flux=2.)
+    np.testing.assert_array_equal(delta.kValueMany(x, y), 2.)
+    np.testing.assert_array_equal(delta.xValueMany([1, 0], [0, 0]), [0., delta.xValue(0,0)])
+
+    # Same errors as xValue for profiles that can't do it.
+    assert_raises(galsim.GalSimError, galsim.Convolve(gal, psf, psf).xValueMany, x, y)
+    assert_raises(NotImplementedError, galsim.Deconvolve(psf).xValueMany, x, y)
+
+
 if __name__ == "__main__":
     testfns = [v for k, v in vars().items() if k[:5] == 'test_' and callable(v)]
     for testfn in testfns:
@@ -16,6 +16,7 @@
 #    and/or other materials provided with the distribution.
 #
 
+import math
 import numpy as np
 
 import galsim
@@ -320,6 +321,63 @@ def test_hankel():
         galsim.integ.hankel(f1, k=0.3, nu=-0.5)
 
 
+@timer
+def test_hankel_fftlog():
+    """Test the galsim.integ.hankel_fftlog function
+    """
+    f1 = lambda r: np.exp(-r)
+    kmin = 1.e-5
+    dlogk = 0.05
+    nk = 300
+    k = kmin * np.exp(np.arange(nk) * dlogk)
+    for nu in [0, 1, 7, 0.5, 0.003, 12.23]:
+        result = galsim.integ.hankel_fftlog(f1, kmin, dlogk, nk, nu=nu)
+        expected_val = (1+k**2)**-1.5 * (1+nu*(1+k**2)**0.5) * k**nu / (1+(1+k**2)**0.5)**nu
+        np.testing.assert_allclose(result, expected_val, rtol=1.e-6, atol=1.e-12)
+        # Should match the regular hankel function too.
+        np.testing.assert_allclose(result, galsim.integ.hankel(f1, k, nu=nu),
+                                   rtol=2.e-6, atol=2.e-12)
+
+    # A Sersic profile with a large n has a very extended profile.  This is one of the main
+    # use cases in GalSim.
+    n = 4.
+    f2 = lambda r: np.exp(-r**(1./n))
+    kmin = 1.e-6
+    nk = 200
+    k = kmin * np.exp(np.arange(nk) * dlogk)
+    result = galsim.integ.hankel_fftlog(f2, kmin, dlogk, nk, rel_err=1.e-6, abs_err=1.e-8)
+    np.testing.assert_allclose(result, galsim.integ.hankel(f2, k, rel_err=1.e-6, abs_err=1.e-8),
+                               rtol=1.e-5, atol=1.e-7)
+
+    # With a coarser spacing than the profile tables use, the Nyquist term of the Fourier series
+    # in log(r) is larger.  The result should still match the quadrature.
+    kmin = 1.e-3
+    dlogk = 0.3
+    nk = 40
+    k = kmin * np.exp(np.arange(nk) * dlogk)
+    result = galsim.integ.hankel_fftlog(f1, kmin, dlogk, nk)
+    np.testing.assert_allclose(result, galsim.integ.hankel(f1, k), rtol=2.e-6, atol=2.e-12)
+
+    # The Sersic Fourier table is built with hankel_fftlog.  Check it against the quadrature
+    # that was used to build it before.  (Use k values in the range of the table, not the
+    # high-k asymptotic formula.)
+    for n in [1.3, 2.5, 4.1]:
+        f3 = lambda r: np.exp(-r**(1./n))
+        sersic = galsim.Sersic(n=n, scale_radius=1.)
+        k = np.array([0.1, 0.5, 1., 2., 5.]) / sersic.half_light_radius
+        kval = np.array([sersic.kValue(kk, 0.).real for kk in k])
+        expected_val = galsim.integ.hankel(f3, k) / (n * math.gamma(2.*n))
+        print('n = ',n,' kValue = ',kval,' quadrature = ',expected_val)
+        np.testing.assert_allclose(kval, expected_val, rtol=1.e-5, atol=1.e-6)
+
+    with assert_raises(galsim.GalSimValueError):
+        galsim.integ.hankel_fftlog(f1, kmin=0., dlogk=0.1, nk=10)
+    with assert_raises(galsim.GalSimValueError):
+        galsim.integ.hankel_fftlog(f1, kmin=0.1, dlogk=-0.1, nk=10)
+    with assert_raises(galsim.GalSimValueError):
+        galsim.integ.hankel_fftlog(f1, kmin=0.1, dlogk=0.1, nk=10, nu=-1)
+
+
 def test_gq_annulus():
     """Test the galsim.integ.gq_annulus function
     """
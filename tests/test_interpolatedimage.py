@@ -1873,6 +1873,125 @@ def test_drawreal_seg_fault():
     np.testing.assert_array_equal(image.array, 0)
 
 
+@timer
+def test_phase_tolerance():
+    """Test drawing with the interpolant weights tabulated at quantized phases.
+    """
+    scale = 0.2
+    im = galsim.Gaussian(sigma=0.7).shear(g1=0.2, g2=-0.1).drawImage(nx=41, ny=41, scale=scale,
+                                                                      method='no_pixel')
+    tol = 1./2048.
+    gsp = galsim.GSParams(interpolant_phase_tolerance=tol)
+    check_pickle(gsp)
+    assert gsp.interpolant_phase_tolerance == tol
+    assert galsim.GSParams().interpolant_phase_tolerance == 0.
+
+    for interp in ['quintic', galsim.Lanczos(5)]:
+        ii = galsim.InterpolatedImage(im, x_interpolant=interp)
+        ii_phase = ii.withGSParams(gsp)
+        assert ii_phase.x_interpolant.gsparams == gsp
+        peak = np.max(im.array)
+
+        # With the drawn pixels at a phase on the grid (N=1024 here), the results are exact.
+        im1 = ii.drawImage(nx=31, ny=31, scale=scale, method='no_pixel', offset=(0.25, -0.375))
+        im2 = ii_phase.drawImage(nx=31, ny=31, scale=scale, method='no_pixel',
+                                 offset=(0.25, -0.375))
+        np.testing.assert_allclose(im2.array, im1.array, rtol=1.e-10, atol=1.e-12 * peak)
+
+        # Otherwise, the errors are of order tol times the slope of the interpolant.
+        # Check both the separable and non-separable drawing code.
+        for wcs in [galsim.PixelScale(scale*0.93),
+                    galsim.JacobianWCS(0.19, 0.03, -0.02, 0.21)]:
+            for offset in [(0.1234, 0.3141), (-0.4321, 0.2718)]:
+                im1 = ii.drawImage(nx=31, ny=31, wcs=wcs, method='no_pixel', offset=offset)
+                im2 = ii_phase.drawImage(nx=31, ny=31, wcs=wcs, method='no_pixel', offset=offset)
+                print(interp, wcs, offset, 'max diff = ', np.max(np.abs(im2.array-im1.array)))
+                np.testing.assert_allclose(im2.array, im1.array, atol=10 * tol * peak)
+                assert np.max(np.abs(im2.array-im1.array)) > 0.
+
+        # Drawing again reuses the same table and gives the same answer.
+        im3 = ii_phase.drawImage(nx=31, ny=31, wcs=wcs, method='no_pixel', offset=offset)
+        np.testing.assert_array_equal(im3.array, im2.array)
+
+
+@timer
+def test_commensurate_kimage():
+    """Test drawKImage when the k grid lands on the nodes of the internal FFT of the image.
+    """
+    scale = 0.3
+    im = galsim.Gaussian(sigma=1.1).shear(g1=0.2, g2=-0.1).drawImage(nx=32, ny=32, scale=scale)
+    for interp in ['quintic', galsim.Lanczos(3)]:
+        ii = galsim.InterpolatedImage(im, k_interpolant=interp)
+        # The internal k grid has spacing 2pi / (N scale), where N is the padded image size.
+        N = ii._xim.array.shape[1]
+        dk0 = 2.*np.pi / (N * scale)
+
+        # Multiples of dk0 use the fast path that reads the values directly.
+        # Other spacings use the general kInterp sums.  Both should match kValue.
+        for dk in [dk0, 2*dk0, 0.9*dk0]:
+            kim = galsim.ImageCD(galsim.BoundsI(-16,15,-16,15), scale=dk)
+            ii.drawKImage(kim, recenter=False)
+            kx, ky = np.meshgrid(np.arange(-16,16) * dk, np.arange(-16,16) * dk)
+            kv = np.array([ii.kValue(x,y) for x,y in zip(kx.ravel(), ky.ravel())])
+            print(interp, dk/dk0, 'max diff = ', np.max(np.abs(kim.array.ravel() - kv)))
+            np.testing.assert_allclose(kim.array.ravel(), kv, rtol=1.e-10, atol=1.e-12)
+
+
+@timer
+def test_interpolant_tables():
+    """Test the tabulated versions of the Cubic, Quintic and Lanczos interpolants.
+    """
+    gsp = galsim.GSParams(interpolant_tables=True)
+    check_pickle(gsp)
+    assert gsp.interpolant_tables
+    assert not galsim.GSParams().interpolant_tables
+
+    # Include some values that are exactly on the nodes, and some that are out of range.
+    x = np.concatenate([np.linspace(-7.3, 7.3, 2001), np.arange(-7, 8)])
+    u = np.linspace(-3.1, 3.1, 2001)
+    for interp in [galsim.Cubic(), galsim.Quintic(), galsim.Lanczos(3),
+                   galsim.Lanczos(5, conserve_dc=False), galsim.Lanczos(7)]:
+        tinterp = interp.withGSParams(gsp)
+        assert tinterp.gsparams.interpolant_tables
+        check_pickle(tinterp)
+
+        # The array versions use the vectorized table lookup.
+        xv1 = interp.xval(x)
+        xv2 = tinterp.xval(x)
+        print(interp, 'max xval diff = ', np.max(np.abs(xv2-xv1)))
+        np.testing.assert_allclose(xv2, xv1, atol=gsp.xvalue_accuracy)
+        uv1 = interp.uval(u)
+        uv2 = tinterp.uval(u)
+        print(interp, 'max uval diff = ', np.max(np.abs(uv2-uv1)))
+        np.testing.assert_allclose(uv2, uv1, atol=2*gsp.kvalue_accuracy)
+
+        # The scalar versions should match the array versions exactly.
+        np.testing.assert_array_equal([tinterp.xval(xx) for xx in x[::37]], xv2[::37])
+        np.testing.assert_array_equal([tinterp.uval(uu) for uu in u[::37]], uv2[::37])
+
+        # The values at the nodes are still exact.
+        np.testing.assert_array_equal(tinterp.xval(np.arange(-7, 8)),
+                                      interp.xval(np.arange(-7, 8)))
+
+        # If the table can't reach the requested accuracy, the direct calculation is used.
+        tight_gsp = galsim.GSParams(xvalue_accuracy=1.e-15, interpolant_tables=True)
+        np.testing.assert_array_equal(interp.withGSParams(tight_gsp).xval(x),
+                                      interp.withGSParams(xvalue_accuracy=1.e-15).xval(x))
+
+    # Drawing an InterpolatedImage with the tables should be accurate too.
+    scale = 0.2
+    im = galsim.Gaussian(sigma=0.7).shear(g1=0.2, g2=-0.1).drawImage(nx=41, ny=41, scale=scale,
+                                                                      method='no_pixel')
+    peak = np.max(im.array)
+    ii = galsim.InterpolatedImage(im, x_interpolant='lanczos5', k_interpolant='quintic')
+    ii_tab = ii.withGSParams(interpolant_tables=True)
+    im1 = ii.drawImage(nx=31, ny=31, scale=0.93*scale, method='no_pixel', offset=(0.12, 0.31))
+    im2 = ii_tab.drawImage(nx=31, ny=31, scale=0.93*scale, method='no_pixel', offset=(0.12, 0.31))
+    np.testing.assert_allclose(im2.array, im1.array, atol=1.e-4 * peak)
+    im1 = ii.drawImage(nx=32, ny=32, scale=0.93*scale)
+    im2 = ii_tab.drawImage(nx=32, ny=32, scale=0.93*scale)
+    np.testing.assert_allclose(im2.array, im1.array, atol=1.e-4 * peak)
+
 
 if __name__ == "__main__":
     setup()
@@ -302,6 +302,13 @@ def test_photon_array():
     assert len(photons) == 32
     np.testing.assert_almost_equal(photons.flux, 4.)
 
+    # The arrays are sized exactly, including pixels with negative flux.
+    mixed = galsim.Image(np.array([[0, 3, -7], [12, -0.5, 1]], dtype=float))
+    photons = galsim.PhotonArray.makeFromImage(mixed, max_flux=2.)
+    print('photons = ',photons)
+    assert len(photons) == 15
+    np.testing.assert_almost_equal(photons.flux.sum(), mixed.array.sum())
+
     assert_raises(ValueError, galsim.PhotonArray.makeFromImage, zero, max_flux=0.)
     assert_raises(ValueError, galsim.PhotonArray.makeFromImage, zero, max_flux=-2)
 
@@ -1755,6 +1762,30 @@ def test_scale_wavelength():
     check_pickle(scale_wave)
 
 
+@timer
+def test_shoot_omp_threads():
+    """Check that shooting an Add or a Convolve gives the same photons for any number of threads.
+    """
+    gauss = galsim.Gaussian(sigma=1.1, flux=2.)
+    exp = galsim.Exponential(half_light_radius=0.7).shear(g1=0.2, g2=-0.1)
+    kolm = galsim.Kolmogorov(fwhm=0.9)
+    box = galsim.Box(0.3, 0.4)
+    objs = [galsim.Add(gauss, exp, kolm), galsim.Convolve(gauss, exp, kolm, box)]
+
+    nthreads = galsim.get_omp_threads()
+    try:
+        for obj in objs:
+            galsim.set_omp_threads(1)
+            pa1 = obj.shoot(10000, galsim.BaseDeviate(1234))
+            galsim.set_omp_threads(4)
+            pa4 = obj.shoot(10000, galsim.BaseDeviate(1234))
+            np.testing.assert_array_equal(pa4.x, pa1.x)
+            np.testing.assert_array_equal(pa4.y, pa1.y)
+            np.testing.assert_array_equal(pa4.flux, pa1.flux)
+    finally:
+        galsim.set_omp_threads(nthreads)
+
+
 
 if __name__ == '__main__':
     testfns = [v for k, v in vars().items() if k[:5] == 'test_' and callable(v)]
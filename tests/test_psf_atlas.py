@@ -0,0 +1,98 @@
+# Copyright (c) 2012-2023 by the GalSim developers team on GitHub
+# https://github.com/GalSim-developers
+#
+# This file is part of GalSim: The modular galaxy image simulation toolkit.
+# https://github.com/GalSim-developers/GalSim
+#
+# GalSim is free software: redistribution and use in source and binary forms,
+# with or without modification, are permitted provided that the following
+# conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+#    list of conditions, and the disclaimer given in the accompanying LICENSE
+#    file.
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions, and the disclaimer given in the documentation
+#    and/or other materials provided with the distribution.
+#
+
+
+import numpy as np
+import galsim
+
+from galsim_test_helpers import *
+
+
+@timer
+def test_psf_atlas():
+    """Test that PSFAtlas stamps match drawImage at the same offsets.
+    """
+    scale = 0.2
+    for psf in [galsim.Kolmogorov(fwhm=0.7),
+                galsim.Moffat(beta=3, fwhm=0.8).shear(e1=0.1, e2=-0.05)]:
+        atlas = galsim.PSFAtlas(psf, scale)
+        np.testing.assert_equal(
+            atlas.oversample, int(np.ceil(2 * scale * psf.maxk / np.pi)))
+        np.testing.assert_almost_equal(atlas.atlas.array.sum(), 1., decimal=2)
+
+        for offset, flux in [((0,0), 1.), ((0.3,-0.2), 17.), ((-0.5,0.45), 1.e3),
+                             ((2.7,-1.3), 3.)]:
+            im1 = atlas.drawStamp(nx=25, ny=25, offset=offset, flux=flux)
+            im2 = psf.withFlux(flux).drawImage(nx=25, ny=25, scale=scale, offset=offset)
+            print('offset = ',offset,' max diff = ',np.max(np.abs(im1.array-im2.array)))
+            np.testing.assert_allclose(im1.array, im2.array, rtol=0,
+                                       atol=2.e-4 * np.max(im2.array))
+            assert im1.scale == scale
+            assert im1.dtype == np.float64
+
+        # Drawing onto an existing image, including float32 and non-trivial bounds.
+        im3 = galsim.ImageF(galsim.BoundsI(101,130,-20,-1))
+        im3.fill(99)
+        center = galsim.PositionD(115.2, -10.7)
+        atlas.drawStamp(im3, center=center, flux=5.)
+        im4 = psf.withFlux(5.).drawImage(galsim.ImageF(im3.bounds, scale=scale),
+                                          center=center)
+        np.testing.assert_allclose(im3.array, im4.array, rtol=0,
+                                   atol=2.e-4 * np.max(im4.array))
+
+        # Pixels off the edge of the atlas are zero.
+        im5 = atlas.drawStamp(nx=9, ny=9, offset=(200,0))
+        np.testing.assert_array_equal(im5.array, 0.)
+
+    # Higher oversampling gives a more accurate result.
+    psf = galsim.Kolmogorov(fwhm=0.7)
+    im2 = psf.drawImage(nx=25, ny=25, scale=scale, offset=(0.3,0.1))
+    err = []
+    for oversample in [1, 2, 4]:
+        atlas = galsim.PSFAtlas(psf, scale, oversample=oversample)
+        im1 = atlas.drawStamp(nx=25, ny=25, offset=(0.3,0.1))
+        err.append(np.max(np.abs(im1.array-im2.array)))
+    print('err = ',err)
+    assert err[1] < err[0]
+    assert err[2] < err[1]
+
+    # So does a tighter maxk_threshold.
+    gsp = galsim.GSParams(maxk_threshold=1.e-4)
+    atlas = galsim.PSFAtlas(psf, scale, gsparams=gsp)
+    assert atlas.gsparams == gsp
+    assert atlas.oversample >= galsim.PSFAtlas(psf, scale).oversample
+
+    # Other interpolants work too.
+    atlas = galsim.PSFAtlas(psf, scale, interpolant='lanczos5')
+    assert isinstance(atlas.interpolant, galsim.Lanczos)
+    im1 = atlas.drawStamp(nx=25, ny=25, offset=(0.3,0.1))
+    np.testing.assert_allclose(im1.array, im2.array, rtol=0, atol=2.e-4 * np.max(im2.array))
+
+    assert_raises(galsim.GalSimValueError, galsim.PSFAtlas, psf, scale, oversample=0)
+    assert_raises(galsim.GalSimIncompatibleValuesError, atlas.drawStamp)
+    assert_raises(galsim.GalSimIncompatibleValuesError, atlas.drawStamp, nx=3)
+    assert_raises(galsim.GalSimIncompatibleValuesError, atlas.drawStamp, im1, nx=3, ny=3)
+    assert_raises(galsim.GalSimIncompatibleValuesError, atlas.drawStamp,
+                  nx=3, ny=3, bounds=galsim.BoundsI(1,3,1,3))
+    assert_raises(galsim.GalSimValueError, atlas.drawStamp, galsim.ImageI(5,5))
+
+
+if __name__ == "__main__":
+    testfns = [v for k, v in vars().items() if k[:5] == 'test_' and callable(v)]
+    for testfn in testfns:
+        testfn()
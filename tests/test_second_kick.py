@@ -300,6 +300,31 @@ def test_sk_ne():
     check_all_diff(objs)
 
 
+@timer
+def test_sk_interpolated():
+    """Test the option to interpolate the SecondKick tables on a grid in kcrit.
+    """
+    orig = galsim.utilities.get_second_kick_interpolated()
+    galsim.utilities.set_second_kick_interpolated(True)
+    assert galsim.utilities.get_second_kick_interpolated()
+
+    k = np.linspace(0., 10., 21)
+    for lam, r0, kcrit in [(512.3, 0.123, 0.1234), (723.4, 0.187, 0.5678)]:
+        sk1 = galsim.SecondKick(lam=lam, r0=r0, diam=4., kcrit=kcrit)
+        kval1 = np.array([sk1.kValue(kx, 0.).real for kx in k])
+        maxk1 = sk1.maxk
+        galsim.utilities.set_second_kick_interpolated(False)
+        sk2 = galsim.SecondKick(lam=lam, r0=r0, diam=4., kcrit=kcrit)
+        kval2 = np.array([sk2.kValue(kx, 0.).real for kx in k])
+        galsim.utilities.set_second_kick_interpolated(True)
+
+        print('kcrit = ',kcrit,' max diff = ',np.max(np.abs(kval1-kval2)))
+        np.testing.assert_allclose(kval1, kval2, rtol=0, atol=3.e-5)
+        np.testing.assert_allclose(maxk1, sk2.maxk, rtol=1.e-2)
+
+    galsim.utilities.set_second_kick_interpolated(orig)
+
+
 if __name__ == '__main__':
     from argparse import ArgumentParser
     parser = ArgumentParser()
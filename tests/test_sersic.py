@@ -580,6 +580,48 @@ def test_near_05():
     np.testing.assert_allclose(im3.array, im1.array, atol=1.e-12)
 
 
+@timer
+def test_sersic_interpolated_ft():
+    """Test the option to interpolate the Sersic Fourier transform in n.
+    """
+    orig = galsim.utilities.get_sersic_interpolated_ft()
+    galsim.utilities.set_sersic_interpolated_ft(True)
+    assert galsim.utilities.get_sersic_interpolated_ft()
+
+    # Use unusual values of n, so the infos aren't already in the cache.
+    kx = np.linspace(0., 5., 31)
+    for n in [0.4321, 1.2345, 3.7654, 5.8765]:
+        s1 = galsim.Sersic(n=n, half_light_radius=1.)
+        kval1 = np.array([s1.kValue(k, 0.) for k in kx])
+        maxk1 = s1.maxk
+
+        galsim.utilities.set_sersic_interpolated_ft(False)
+        s2 = galsim.Sersic(n=n, half_light_radius=1.)
+        kval2 = np.array([s2.kValue(k, 0.) for k in kx])
+        galsim.utilities.set_sersic_interpolated_ft(True)
+
+        print('n = ',n,' max diff = ',np.max(np.abs(kval1-kval2)))
+        # The interpolation changes the values by up to about 10 x kvalue_accuracy, mostly
+        # near the lowest k values that use the table.  (The direct calculation itself is only
+        # accurate to a few x 1.e-4 there.)
+        np.testing.assert_allclose(kval1, kval2, rtol=0, atol=2.e-4)
+        np.testing.assert_allclose(maxk1, s2.maxk, rtol=1.e-3)
+
+        # Images drawn both ways should match well.
+        im1 = s1.drawImage(nx=32, ny=32, scale=0.2, method='no_pixel')
+        im2 = s2.drawImage(nx=32, ny=32, scale=0.2, method='no_pixel')
+        np.testing.assert_allclose(im1.array, im2.array, rtol=0, atol=1.e-4*im2.array.max())
+
+    # Truncated profiles aren't affected.
+    s3 = galsim.Sersic(n=2.3456, half_light_radius=1., trunc=4.)
+    galsim.utilities.set_sersic_interpolated_ft(False)
+    s4 = galsim.Sersic(n=2.3456, half_light_radius=1., trunc=4.)
+    assert s3.kValue(1.2, 0.3) == s4.kValue(1.2, 0.3)
+    assert s3.maxk == s4.maxk
+
+    galsim.utilities.set_sersic_interpolated_ft(orig)
+
+
 if __name__ == "__main__":
     testfns = [v for k, v in vars().items() if k[:5] == 'test_' and callable(v)]
     for testfn in testfns:
@@ -354,6 +354,59 @@ def test_roundoff():
     assert_raises(ValueError, table1, 10.0+1.e5)
 
 
+@timer
+def test_spacing():
+    """Test that the index lookup is right for log spaced and irregularly spaced args.
+    """
+    rng = np.random.default_rng(1234)
+    all_args = [
+        np.logspace(-2, 3, 500),                                    # log spaced
+        np.cumsum(rng.uniform(0.01, 1., size=500)),                 # irregular
+        np.concatenate([np.arange(0, 1, 1.e-3), np.arange(1, 500)]),  # very different spacings
+    ]
+    for args in all_args:
+        vals = np.sin(args) + np.arange(len(args))
+        table = galsim.LookupTable(args, vals, interpolant='linear')
+        # Random order, so successive lookups aren't close together.  Include the nodes too.
+        x = np.concatenate([rng.uniform(args[0], args[-1], size=2000), args])
+        rng.shuffle(x)
+        np.testing.assert_allclose(table(x), np.interp(x, args, vals), rtol=1.e-12)
+        np.testing.assert_allclose([table(xx) for xx in x[:200]],
+                                   np.interp(x[:200], args, vals), rtol=1.e-12)
+
+
+@timer
+def test_large_arrays():
+    """Test that array calls long enough to be done in batches (possibly in parallel) match
+    the scalar calls.
+    """
+    rng = np.random.default_rng(5678)
+    args = np.cumsum(rng.uniform(0.1, 1., size=300))
+    vals = np.sin(args)
+    x = rng.uniform(args[0], args[-1], size=20000)
+    for interp in interps:
+        table = galsim.LookupTable(args, vals, interpolant=interp)
+        y = table(x)
+        np.testing.assert_array_equal(y[::97], [table(xx) for xx in x[::97]])
+
+    xgrid = np.linspace(0, 10, 100)
+    ygrid = np.linspace(0, 5, 80)
+    z = np.sin(xgrid)[:,None] * np.cos(ygrid)
+    x = rng.uniform(0, 10, size=20000)
+    y = rng.uniform(0, 5, size=20000)
+    for interp in ['linear', 'spline', 'floor', 'nearest']:
+        tab2d = galsim.LookupTable2D(xgrid, ygrid, z, interpolant=interp)
+        f = tab2d(x, y)
+        np.testing.assert_array_equal(f[::97], [tab2d(xx, yy) for xx, yy in zip(x[::97], y[::97])])
+        fgrid = tab2d(x[:150], y[:150], grid=True)
+        np.testing.assert_array_equal(fgrid[::7,::7], tab2d(x[:150:7], y[:150:7], grid=True))
+        if interp in ['linear', 'spline']:
+            dfdx, dfdy = tab2d.gradient(x, y)
+            dx, dy = tab2d.gradient(x[::97], y[::97])
+            np.testing.assert_array_equal(dfdx[::97], dx)
+            np.testing.assert_array_equal(dfdy[::97], dy)
+
+
 @timer
 def test_table_GSInterp():
     def f(x_):
@@ -898,6 +951,25 @@ def test_table2d_cubic():
         np.testing.assert_allclose(test_dfdx, ref_dfdx, atol=1e-10, rtol=0)
         np.testing.assert_allclose(test_dfdy, ref_dfdy, atol=1e-10, rtol=0)
 
+        # Precomputing the bicubic coefficients should give the same answers.
+        tab2d_pre = galsim.LookupTable2D(x, y, z, interpolant='spline', precompute=True,
+            dfdx=dfdx(xx, yy), dfdy=dfdy(xx, yy), d2fdxdy=d2fdxdy(xx, yy))
+        assert tab2d_pre == tab2d
+        np.testing.assert_allclose(tab2d_pre(x1,y1), f(x1, y1), atol=1e-10, rtol=0)
+        np.testing.assert_allclose(tab2d_pre(newxx, newyy), f(newxx, newyy), atol=1e-10, rtol=0)
+        np.testing.assert_allclose(tab2d_pre(newx, newy, grid=True), f(newxx, newyy),
+                                   atol=1e-10, rtol=0)
+        test_dfdx, test_dfdy = tab2d_pre.gradient(newxx, newyy)
+        np.testing.assert_allclose(test_dfdx, ref_dfdx, atol=1e-10, rtol=0)
+        np.testing.assert_allclose(test_dfdy, ref_dfdy, atol=1e-10, rtol=0)
+        test_dfdx, test_dfdy = tab2d_pre.gradient(newx, newy, grid=True)
+        np.testing.assert_allclose(test_dfdx, ref_dfdx, atol=1e-10, rtol=0)
+        np.testing.assert_allclose(test_dfdy, ref_dfdy, atol=1e-10, rtol=0)
+
+    tab2d_pre = galsim.LookupTable2D(x[:10], y[:10], z[:10,:10], interpolant='spline',
+                                     precompute=True)
+    check_pickle(tab2d_pre, lambda t: t(x[3]+0.01, y[4]+0.02))
+
 
 @timer
 def test_table2d_GSInterp():
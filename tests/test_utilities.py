@@ -881,6 +881,116 @@ def test_python_LRU_Cache():
     assert_raises(ValueError, cache.resize, -20)
 
 
+@timer
+def test_profile_cache_stats():
+    """Test the statistics of the C++ profile caches
+    """
+    galsim.utilities.reset_profile_cache_stats()
+    stats = galsim.utilities.get_profile_cache_stats()
+    for name in ['Sersic', 'Spergel', 'Exponential', 'Kolmogorov', 'Airy', 'VonKarman',
+                 'SecondKick']:
+        assert name in stats
+        assert stats[name]['hits'] == 0
+        assert stats[name]['misses'] == 0
+        assert stats[name]['evictions'] == 0
+        assert 0 <= stats[name]['size'] <= stats[name]['max_size']
+
+    # Use an unusual n, so the info isn't already in the cache.
+    s1 = galsim.Sersic(n=2.3456, half_light_radius=1.)
+    s2 = galsim.Sersic(n=2.3456, half_light_radius=2.)
+    np.testing.assert_allclose(s1.maxk, 2. * s2.maxk, rtol=1.e-12)
+    stats = galsim.utilities.get_profile_cache_stats()['Sersic']
+    print('Sersic cache stats = ',stats)
+    assert stats['misses'] >= 1
+    assert stats['hits'] >= 1
+    assert stats['size'] >= 1
+
+    galsim.utilities.reset_profile_cache_stats()
+    stats = galsim.utilities.get_profile_cache_stats()['Sersic']
+    assert stats['hits'] == stats['misses'] == stats['evictions'] == 0
+    assert stats['size'] >= 1
+
+    # Check the memory budget
+    orig_budget = galsim.utilities.get_profile_cache_budget()
+    assert orig_budget == 256 * 1024**2
+    for n in np.linspace(1.1, 3.3, 20):
+        s = galsim.Sersic(n=n, half_light_radius=1.)
+        s._sbp  # Puts the info in the cache, before it builds any of the lazy parts.
+        mem1 = galsim.utilities.get_profile_cache_stats()['Sersic']['memory']
+        # Use it twice, so the cache sees the memory used by the Fourier table.
+        s.maxk
+        galsim.Sersic(n=n, half_light_radius=1.).maxk
+        mem2 = galsim.utilities.get_profile_cache_stats()['Sersic']['memory']
+        assert mem2 > mem1
+    # Shooting photons builds the sampler, which is also counted.
+    s = galsim.Sersic(n=3.21098, half_light_radius=1.)
+    s._sbp
+    mem1 = galsim.utilities.get_profile_cache_stats()['Sersic']['memory']
+    s.shoot(100, galsim.BaseDeviate(1234))
+    mem2 = galsim.utilities.get_profile_cache_stats()['Sersic']['memory']
+    assert mem2 > mem1
+    stats = galsim.utilities.get_profile_cache_stats()['Sersic']
+    print('Sersic cache stats = ',stats)
+    assert stats['memory'] > 0
+    budget = stats['memory'] // 2
+    galsim.utilities.set_profile_cache_budget(budget)
+    assert galsim.utilities.get_profile_cache_budget() == budget
+    stats = galsim.utilities.get_profile_cache_stats()
+    print('After budget = ',budget,', stats = ',stats)
+    assert sum(st['memory'] for st in stats.values()) <= budget
+    assert stats['Sersic']['evictions'] > 0
+
+    # 0 means no limit.
+    galsim.utilities.set_profile_cache_budget(0)
+    assert galsim.utilities.get_profile_cache_budget() == 0
+    assert_raises(ValueError, galsim.utilities.set_profile_cache_budget, -1)
+    galsim.utilities.set_profile_cache_budget(orig_budget)
+
+
+@timer
+def test_table_cache_dir():
+    """Test saving the profile lookup tables to disk
+    """
+    import shutil
+    orig_dir = galsim.utilities.get_table_cache_dir()
+    cache_dir = os.path.join('output', 'table_cache')
+    if os.path.exists(cache_dir):
+        shutil.rmtree(cache_dir)
+    galsim.utilities.set_table_cache_dir(cache_dir)
+    assert os.path.isdir(cache_dir)
+    assert galsim.utilities.get_table_cache_dir() == cache_dir
+
+    # Use an unusual n, so the info isn't already in the in-memory cache.
+    s1 = galsim.Sersic(n=3.14159, half_light_radius=1.)
+    maxk1 = s1.maxk
+    kval1 = s1.kValue(0.5, 0.3)
+    files = os.listdir(cache_dir)
+    print('files = ',files)
+    assert len([f for f in files if f.startswith('SersicFT_')]) == 1
+    assert not any('.tmp.' in f for f in files)
+
+    # Empty the in-memory caches, so the next one needs to load the table from the file.
+    orig_budget = galsim.utilities.get_profile_cache_budget()
+    galsim.utilities.set_profile_cache_budget(1)
+    galsim.utilities.set_profile_cache_budget(orig_budget)
+    galsim.utilities.reset_profile_cache_stats()
+    s2 = galsim.Sersic(n=3.14159, half_light_radius=1.)
+    assert s2.maxk == maxk1
+    assert s2.kValue(0.5, 0.3) == kval1
+    assert galsim.utilities.get_profile_cache_stats()['Sersic']['misses'] == 1
+
+    # Different GSParams make a different file.
+    gsp = galsim.GSParams(kvalue_accuracy=1.e-4)
+    s3 = galsim.Sersic(n=3.14159, half_light_radius=1., gsparams=gsp)
+    s3.maxk
+    files = os.listdir(cache_dir)
+    assert len([f for f in files if f.startswith('SersicFT_')]) == 2
+
+    galsim.utilities.set_table_cache_dir(None)
+    assert galsim.utilities.get_table_cache_dir() is None
+    galsim.utilities.set_table_cache_dir(orig_dir)
+
+
 @timer
 def test_rand_with_replacement():
     """Test routine to select random indices with replacement."""
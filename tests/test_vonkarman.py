@@ -374,6 +374,57 @@ def test_low_folding_threshold():
     assert image_size == 600
 
 
+@timer
+def test_vk_interpolated():
+    """Test the option to interpolate the VonKarman tables on a grid in L0/r0.
+    """
+    orig = galsim.utilities.get_vonkarman_interpolated()
+    galsim.utilities.set_vonkarman_interpolated(True)
+    assert galsim.utilities.get_vonkarman_interpolated()
+
+    # Use unusual values, so the infos aren't already in the cache.
+    for lam, r0, L0 in [(512.3, 0.123, 4.321), (623.4, 0.187, 23.45), (834.5, 0.234, 56.78)]:
+        vk1 = galsim.VonKarman(lam=lam, r0=r0, L0=L0, flux=1.7)
+        galsim.utilities.set_vonkarman_interpolated(False)
+        vk2 = galsim.VonKarman(lam=lam, r0=r0, L0=L0, flux=1.7)
+        galsim.utilities.set_vonkarman_interpolated(True)
+
+        kx = np.linspace(0., vk2.maxk, 31)
+        kval1 = np.array([vk1.kValue(k, 0.).real for k in kx])
+        kval2 = np.array([vk2.kValue(k, 0.).real for k in kx])
+        print('L0/r0 = ',L0/r0,' max diff = ',np.max(np.abs(kval1-kval2)))
+        np.testing.assert_allclose(kval1, kval2, rtol=0, atol=3.e-5 * vk2.flux)
+        np.testing.assert_allclose(vk1.maxk, vk2.maxk, rtol=2.e-2)
+        np.testing.assert_allclose(vk1.stepk, vk2.stepk, rtol=2.e-2)
+        np.testing.assert_allclose(vk1.half_light_radius, vk2.half_light_radius, rtol=5.e-2)
+
+        im1 = vk1.drawImage(nx=32, ny=32, scale=0.2, method='no_pixel')
+        im2 = vk2.drawImage(nx=32, ny=32, scale=0.2, method='no_pixel')
+        np.testing.assert_allclose(im1.array, im2.array, rtol=0, atol=1.e-3*im2.array.max())
+
+        # Photon shooting draws from both of the nearest tables, but the flux is unchanged.
+        im3 = vk1.drawImage(nx=32, ny=32, scale=0.2, method='phot', n_photons=100000,
+                            poisson_flux=False, rng=galsim.BaseDeviate(1234))
+        np.testing.assert_allclose(im3.array.sum(), im2.array.sum(), rtol=3.e-2)
+
+    galsim.utilities.set_vonkarman_interpolated(orig)
+
+
+@timer
+def test_vk_drawk():
+    """Test that drawKImage matches kValue.
+    """
+    vk = galsim.VonKarman(lam=623.4, r0=0.187, L0=23.45, flux=1.7)
+    # Also use a sheared version, which draws using the non-axis-aligned k grid.
+    for obj in [vk, vk.shear(g1=0.2, g2=-0.1)]:
+        scale = vk.maxk / 20.
+        im = obj.drawKImage(nx=48, ny=48, scale=scale)
+        for i, j in [(0,0), (3,0), (0,5), (-4,7), (10,-3), (-17,-12)]:
+            kval = obj.kValue(i*scale, j*scale)
+            print(i, j, im(i,j), kval)
+            np.testing.assert_allclose(im(i,j), kval, rtol=1.e-10, atol=1.e-12 * obj.flux)
+
+
 if __name__ == "__main__":
     from argparse import ArgumentParser
     parser = ArgumentParser()